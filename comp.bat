@@ -1,2 +1,2 @@
 @echo off
-gcc -Ofast -Os -Wall -Wextra -Wpedantic -Werror -std=c2x -m64 -o GLSLDesigner src/*.c -L vendor_win/lib -I vendor_win/include -lopengl32 -lglfw3 -lm -luser32 -lkernel32 -lgdi32
\ No newline at end of file
+gcc -Ofast -Os -Wall -Wextra -Wpedantic -Werror -std=c2x -m64 -o GLSLDesigner src/*.c -L vendor_win/lib -I vendor_win/include -lopengl32 -lglfw3 -lm -lpthread -luser32 -lkernel32 -lgdi32
\ No newline at end of file
@@ -3,6 +3,7 @@
 uniform mat4 uProjection;
 uniform mat4 uView;
 uniform mat4 uTransform;
+uniform mat4 uMeshDecode;
 
 uniform float uTime;
 uniform float uDeltaTime;
@@ -12,7 +13,8 @@ layout(location = 0) in vec4 iPos;
 out vec4 vPos;
 
 void main() {
-    vec4 p = iPos + vec4(0.0, (sin(uTime + iPos.x) + sin(uTime + iPos.x * 2.4) + sin(uTime + iPos.z * 1.7) + sin(uTime + iPos.z * 2.3)) / 4.0, 0.0, 0.0);
+    vec4 pos = uMeshDecode * iPos;
+    vec4 p = pos + vec4(0.0, (sin(uTime + pos.x) + sin(uTime + pos.x * 2.4) + sin(uTime + pos.z * 1.7) + sin(uTime + pos.z * 2.3)) / 4.0, 0.0, 0.0);
 
     vPos = p;
 
@@ -0,0 +1,324 @@
+#ifndef __BENCH_
+#define __BENCH_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include <glad/gl.h>
+
+#include "utils.h"
+#include "shaderbuild.h"
+
+// Queries in flight, result is read this many frames later so GPU is never waited on
+#define BN_QUERY_RING 8
+
+/**
+ * @brief Summary of measured frame times
+ */
+typedef struct BenchStats_s {
+    double mMean, mStdDev;
+    double mP50, mP90, mP99, mMax;
+} BenchStats_t;
+
+/**
+ * @brief Fixed length benchmark, CPU time of every frame and GPU time from GL_TIME_ELAPSED queries
+ */
+typedef struct Bench_s {
+    double* pCpuMs;
+    double* pGpuMs;
+    uint32_t mFrames;
+    uint32_t mCount;
+
+    uint32_t mQueries[BN_QUERY_RING];
+    // Frame index waiting in query slot, -1 when slot is free
+    int64_t mPending[BN_QUERY_RING];
+
+    double mFrameStart;
+    double mStart, mEnd;
+} Bench_t;
+
+/**
+ * @brief Allocate sample storage and queries
+ *
+ * @param pBench
+ * @param frames measured frames
+ * @return true
+ * @return false out of memory
+ */
+bool BNInit(Bench_t* pBench, uint32_t frames) {
+    memset(pBench, 0, sizeof(Bench_t));
+
+    pBench->mFrames = frames;
+    pBench->pCpuMs = (double*)calloc(frames ? frames : 1, sizeof(double));
+    pBench->pGpuMs = (double*)calloc(frames ? frames : 1, sizeof(double));
+
+    if(!pBench->pCpuMs || !pBench->pGpuMs) {
+        free(pBench->pCpuMs);
+        free(pBench->pGpuMs);
+
+        return false;
+    }
+
+    glGenQueries(BN_QUERY_RING, pBench->mQueries);
+
+    for(uint32_t i = 0; i < BN_QUERY_RING; i++) {
+        pBench->mPending[i] = -1;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Read result of query slot into its frame
+ *
+ * @param pBench
+ * @param slot
+ */
+void __BNCollect(Bench_t* pBench, uint32_t slot) {
+    if(pBench->mPending[slot] < 0) {
+        return;
+    }
+
+    uint64_t ns = 0;
+    glGetQueryObjectui64v(pBench->mQueries[slot], GL_QUERY_RESULT, &ns);
+
+    pBench->pGpuMs[pBench->mPending[slot]] = (double)ns / 1000000.0;
+    pBench->mPending[slot] = -1;
+}
+
+/**
+ * @brief Start measured frame
+ *
+ * @param pBench
+ */
+void BNBeginFrame(Bench_t* pBench) {
+    uint32_t slot = pBench->mCount % BN_QUERY_RING;
+
+    // Slot was used BN_QUERY_RING frames ago, it is long finished
+    __BNCollect(pBench, slot);
+
+    pBench->mFrameStart = UTGetTimeMs();
+
+    if(pBench->mCount == 0) {
+        pBench->mStart = pBench->mFrameStart;
+    }
+
+    glBeginQuery(GL_TIME_ELAPSED, pBench->mQueries[slot]);
+}
+
+/**
+ * @brief End measured frame, call after last draw of frame
+ *
+ * @param pBench
+ */
+void BNEndFrame(Bench_t* pBench) {
+    uint32_t slot = pBench->mCount % BN_QUERY_RING;
+
+    glEndQuery(GL_TIME_ELAPSED);
+    glFlush();
+
+    pBench->pCpuMs[pBench->mCount] = UTGetTimeMs() - pBench->mFrameStart;
+    pBench->mPending[slot] = pBench->mCount;
+    pBench->mCount++;
+}
+
+/**
+ * @brief Read all pending queries, waits for GPU
+ *
+ * @param pBench
+ */
+void BNFinish(Bench_t* pBench) {
+    glFinish();
+
+    pBench->mEnd = UTGetTimeMs();
+
+    for(uint32_t i = 0; i < BN_QUERY_RING; i++) {
+        __BNCollect(pBench, i);
+    }
+}
+
+/**
+ * @brief Stage name used as JSON key
+ *
+ * @param type
+ * @return const char*
+ */
+const char* __BNStageName(int type) {
+    switch(type) {
+        case GL_VERTEX_SHADER: return "vertex";
+        case GL_FRAGMENT_SHADER: return "fragment";
+        case GL_COMPUTE_SHADER: return "compute";
+        case GL_GEOMETRY_SHADER: return "geometry";
+        case GL_TESS_EVALUATION_SHADER: return "tess_evaluation";
+        case GL_TESS_CONTROL_SHADER: return "tess_control";
+        default: return "unknown";
+    }
+}
+
+int __BNCompare(const void* pA, const void* pB) {
+    double a = *(const double*)pA, b = *(const double*)pB;
+
+    return (a > b) - (a < b);
+}
+
+/**
+ * @brief Compute mean, standard deviation and nearest rank percentiles
+ *
+ * @param pSamples
+ * @param count
+ * @return BenchStats_t
+ */
+BenchStats_t BNStats(const double* pSamples, uint32_t count) {
+    BenchStats_t stats = {0};
+
+    if(count == 0) {
+        return stats;
+    }
+
+    double* pSorted = (double*)malloc(count * sizeof(double));
+
+    if(!pSorted) {
+        return stats;
+    }
+
+    memcpy(pSorted, pSamples, count * sizeof(double));
+    qsort(pSorted, count, sizeof(double), __BNCompare);
+
+    double sum = 0.0;
+
+    for(uint32_t i = 0; i < count; i++) {
+        sum += pSorted[i];
+    }
+
+    stats.mMean = sum / count;
+
+    double variance = 0.0;
+
+    for(uint32_t i = 0; i < count; i++) {
+        variance += (pSorted[i] - stats.mMean) * (pSorted[i] - stats.mMean);
+    }
+
+    stats.mStdDev = sqrt(variance / count);
+
+    stats.mP50 = pSorted[(uint32_t)ceil(0.50 * count) - 1];
+    stats.mP90 = pSorted[(uint32_t)ceil(0.90 * count) - 1];
+    stats.mP99 = pSorted[(uint32_t)ceil(0.99 * count) - 1];
+    stats.mMax = pSorted[count - 1];
+
+    free(pSorted);
+
+    return stats;
+}
+
+/**
+ * @brief Write JSON string with escaping
+ *
+ * @param pFile
+ * @param str
+ */
+void __BNWriteString(FILE* pFile, const char* str) {
+    fputc('"', pFile);
+
+    for(; *str; str++) {
+        if(*str == '"' || *str == '\\') {
+            fputc('\\', pFile);
+            fputc(*str, pFile);
+        }
+        else if((unsigned char)*str < 0x20) {
+            fprintf(pFile, "\\u%04x", (unsigned char)*str);
+        }
+        else {
+            fputc(*str, pFile);
+        }
+    }
+
+    fputc('"', pFile);
+}
+
+void __BNWriteStats(FILE* pFile, const char* name, BenchStats_t stats) {
+    fprintf(pFile, "    \"%s\": {\"mean\": %.4f, \"stddev\": %.4f, \"p50\": %.4f, \"p90\": %.4f, \"p99\": %.4f, \"max\": %.4f}", name, stats.mMean, stats.mStdDev, stats.mP50, stats.mP90, stats.mP99, stats.mMax);
+}
+
+/**
+ * @brief Print summary and write it as JSON
+ *
+ * @param pBench
+ * @param path JSON file
+ * @param warmup warm-up frames which were excluded
+ * @param width
+ * @param height
+ * @param shape shape name
+ * @param vertices vertices drawn every frame (indices of indexed meshes)
+ * @param pStages stages used by benchmarked program
+ * @param count
+ * @return true
+ * @return false cannot write file
+ */
+bool BNWriteJson(Bench_t* pBench, const char* path, uint32_t warmup, int width, int height, const char* shape, uint64_t vertices, ShaderStage_t* pStages, uint32_t count) {
+    BenchStats_t cpu = BNStats(pBench->pCpuMs, pBench->mCount);
+    BenchStats_t gpu = BNStats(pBench->pGpuMs, pBench->mCount);
+    double wallMs = pBench->mEnd - pBench->mStart;
+
+    printf("[INFO]: Bench %u frames (%u warm-up) at %dx%d, %.1f fps\n", pBench->mCount, warmup, width, height, wallMs > 0.0 ? pBench->mCount * 1000.0 / wallMs : 0.0);
+    printf("[INFO]:     CPU ms: mean %.4f stddev %.4f p50 %.4f p90 %.4f p99 %.4f max %.4f\n", cpu.mMean, cpu.mStdDev, cpu.mP50, cpu.mP90, cpu.mP99, cpu.mMax);
+    printf("[INFO]:     GPU ms: mean %.4f stddev %.4f p50 %.4f p90 %.4f p99 %.4f max %.4f\n", gpu.mMean, gpu.mStdDev, gpu.mP50, gpu.mP90, gpu.mP99, gpu.mMax);
+
+    FILE* pFile = fopen(path, "w");
+
+    if(!pFile) {
+        printf("[INFO]: Cannot write benchmark results <%s>\n", path);
+
+        return false;
+    }
+
+    fprintf(pFile, "{\n    \"frames\": %u,\n    \"warmup\": %u,\n    \"width\": %d,\n    \"height\": %d,\n    \"shape\": ", pBench->mCount, warmup, width, height);
+    __BNWriteString(pFile, shape);
+    fprintf(pFile, ",\n    \"vertices\": %llu,\n    \"renderer\": ", (unsigned long long)vertices);
+    const char* renderer = (const char*)glGetString(GL_RENDERER);
+    __BNWriteString(pFile, renderer ? renderer : "");
+    fprintf(pFile, ",\n    \"stages\": {");
+
+    bool first = true;
+
+    for(uint32_t i = 0; i < count; i++) {
+        if(pStages[i].mPath[0] == 0) {
+            continue;
+        }
+
+        fprintf(pFile, "%s\"%s\": ", first ? "" : ", ", __BNStageName(pStages[i].mType));
+        __BNWriteString(pFile, pStages[i].mPath);
+
+        first = false;
+    }
+
+    fprintf(pFile, "},\n    \"wall_ms\": %.4f,\n", wallMs);
+    __BNWriteStats(pFile, "cpu_ms", cpu);
+    fprintf(pFile, ",\n");
+    __BNWriteStats(pFile, "gpu_ms", gpu);
+    fprintf(pFile, "\n}\n");
+
+    fclose(pFile);
+
+    printf("[INFO]: Benchmark results saved to <%s>\n", path);
+
+    return true;
+}
+
+/**
+ * @brief Free samples and queries
+ *
+ * @param pBench
+ */
+void BNTerminate(Bench_t* pBench) {
+    glDeleteQueries(BN_QUERY_RING, pBench->mQueries);
+
+    free(pBench->pCpuMs);
+    free(pBench->pGpuMs);
+
+    memset(pBench, 0, sizeof(Bench_t));
+}
+
+#endif
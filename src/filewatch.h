@@ -0,0 +1,360 @@
+#ifndef __FILE_WATCH_
+#define __FILE_WATCH_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#ifdef __linux__
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#endif
+
+#include "utils.h"
+
+#define FW_MAX_FILES 32
+// Must be power of 2
+#define FW_QUEUE_SIZE 64
+// How often watcher wakes up when nothing happens (and how often stat is checked without inotify)
+#define FW_IDLE_MS 100
+
+/**
+ * @brief Coalesced change of watched files
+ */
+typedef struct FileWatchEvent_s {
+    // Bit per watched file
+    uint32_t mMask;
+    // When first change of this burst was seen, used for save to pixels latency
+    double mTime;
+} FileWatchEvent_t;
+
+/**
+ * @brief Watches files on background thread and posts debounced changes through single producer single consumer queue
+ *
+ * Linux uses inotify on parent directories (editors often save by rename), other platforms poll mtime
+ */
+typedef struct FileWatch_s {
+    char mPaths[FW_MAX_FILES][1024];
+    uint32_t mCount;
+    double mDebounceMs;
+
+    FileWatchEvent_t mQueue[FW_QUEUE_SIZE];
+    _Atomic uint32_t mHead, mTail;
+
+    _Atomic bool mQuit;
+    bool mRunning;
+    pthread_t mThread;
+
+    // New file list from render thread, applied by watcher thread
+    char mPendingPaths[FW_MAX_FILES][1024];
+    uint32_t mPendingCount;
+    bool mPendingDirty;
+    pthread_mutex_t mMutex;
+
+#ifdef __linux__
+    int mFd;
+    int mWatches[FW_MAX_FILES];
+#else
+    time_t mTimes[FW_MAX_FILES];
+#endif
+} FileWatch_t;
+
+/**
+ * @brief Push event, called only from watcher thread
+ *
+ * @param pWatch
+ * @param event
+ * @return true
+ * @return false queue is full, event dropped
+ */
+bool __FWPush(FileWatch_t* pWatch, FileWatchEvent_t event) {
+    uint32_t head = atomic_load_explicit(&pWatch->mHead, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&pWatch->mTail, memory_order_acquire);
+
+    if(head - tail == FW_QUEUE_SIZE) {
+        return false;
+    }
+
+    pWatch->mQueue[head & (FW_QUEUE_SIZE - 1)] = event;
+    atomic_store_explicit(&pWatch->mHead, head + 1, memory_order_release);
+
+    return true;
+}
+
+/**
+ * @brief Pop event, called only from render thread
+ *
+ * @param pWatch
+ * @param pEvent
+ * @return true got event
+ * @return false queue is empty
+ */
+bool FWPoll(FileWatch_t* pWatch, FileWatchEvent_t* pEvent) {
+    uint32_t tail = atomic_load_explicit(&pWatch->mTail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&pWatch->mHead, memory_order_acquire);
+
+    if(tail == head) {
+        return false;
+    }
+
+    *pEvent = pWatch->mQueue[tail & (FW_QUEUE_SIZE - 1)];
+    atomic_store_explicit(&pWatch->mTail, tail + 1, memory_order_release);
+
+    return true;
+}
+
+/**
+ * @brief Wait for changes and collect changed files since last call
+ *
+ * @param pWatch
+ * @param timeoutMs how long to wait for changes
+ * @return uint32_t bit mask of changed files
+ */
+uint32_t __FWCollect(FileWatch_t* pWatch, int timeoutMs) {
+    uint32_t mask = 0;
+
+#ifdef __linux__
+    struct pollfd pfd = {pWatch->mFd, POLLIN, 0};
+
+    if(poll(&pfd, 1, timeoutMs) <= 0) {
+        return 0;
+    }
+
+    _Alignas(struct inotify_event) char buffer[4096];
+    ssize_t len = read(pWatch->mFd, buffer, sizeof(buffer));
+
+    for(char* ptr = buffer; len > 0 && ptr < buffer + len; ) {
+        struct inotify_event* event = (struct inotify_event*)ptr;
+
+        if(event->len > 0) {
+            for(uint32_t i = 0; i < pWatch->mCount; i++) {
+                if(pWatch->mWatches[i] != event->wd) {
+                    continue;
+                }
+
+                const char* name = strrchr(pWatch->mPaths[i], '/');
+                name = name ? name + 1 : pWatch->mPaths[i];
+
+                if(strcmp(name, event->name) == 0) {
+                    mask |= 1u << i;
+                }
+            }
+        }
+
+        ptr += sizeof(struct inotify_event) + event->len;
+    }
+#else
+    struct timespec ts = {0, timeoutMs * 1000000};
+    nanosleep(&ts, nullptr);
+
+    for(uint32_t i = 0; i < pWatch->mCount; i++) {
+        struct stat st;
+
+        if(pWatch->mPaths[i][0] != 0 && stat(pWatch->mPaths[i], &st) == 0 && st.st_mtime != pWatch->mTimes[i]) {
+            pWatch->mTimes[i] = st.st_mtime;
+            mask |= 1u << i;
+        }
+    }
+#endif
+
+    return mask;
+}
+
+/**
+ * @brief Take pending file list and start watching it, called only from watcher thread (or before it starts)
+ *
+ * @param pWatch
+ */
+void __FWApplyFiles(FileWatch_t* pWatch) {
+    pthread_mutex_lock(&pWatch->mMutex);
+
+    if(!pWatch->mPendingDirty) {
+        pthread_mutex_unlock(&pWatch->mMutex);
+
+        return;
+    }
+
+#ifdef __linux__
+    for(uint32_t i = 0; i < pWatch->mCount; i++) {
+        if(pWatch->mWatches[i] >= 0) {
+            // Same directory can be watched more than once, second remove just fails
+            inotify_rm_watch(pWatch->mFd, pWatch->mWatches[i]);
+        }
+    }
+#endif
+
+    pWatch->mCount = pWatch->mPendingCount;
+    memcpy(pWatch->mPaths, pWatch->mPendingPaths, sizeof(pWatch->mPaths));
+    pWatch->mPendingDirty = false;
+
+    pthread_mutex_unlock(&pWatch->mMutex);
+
+#ifdef __linux__
+    for(uint32_t i = 0; i < pWatch->mCount; i++) {
+        pWatch->mWatches[i] = -1;
+
+        if(pWatch->mPaths[i][0] == 0) {
+            continue;
+        }
+
+        // Watch directory, not file, so saves done by rename are still seen
+        char dir[1024];
+        snprintf(dir, sizeof(dir), "%s", pWatch->mPaths[i]);
+
+        char* slash = strrchr(dir, '/');
+
+        if(slash) {
+            *slash = 0;
+        }
+        else {
+            strcpy(dir, ".");
+        }
+
+        pWatch->mWatches[i] = inotify_add_watch(pWatch->mFd, dir[0] ? dir : "/", IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+
+        if(pWatch->mWatches[i] < 0) {
+            printf("[INFO]: Cannot watch <%s>\n", pWatch->mPaths[i]);
+        }
+    }
+#else
+    for(uint32_t i = 0; i < pWatch->mCount; i++) {
+        struct stat st;
+
+        pWatch->mTimes[i] = 0;
+
+        if(pWatch->mPaths[i][0] != 0 && stat(pWatch->mPaths[i], &st) == 0) {
+            pWatch->mTimes[i] = st.st_mtime;
+        }
+    }
+#endif
+}
+
+/**
+ * @brief Replace list of watched files, can be called while watcher runs
+ *
+ * @param pWatch
+ * @param paths file paths, empty paths are ignored, index of path is bit in event mask
+ * @param count
+ */
+void FWSetFiles(FileWatch_t* pWatch, const char** paths, uint32_t count) {
+    pthread_mutex_lock(&pWatch->mMutex);
+
+    if(count > FW_MAX_FILES) {
+        printf("[INFO]: Too many files to watch, only first %u are watched\n", FW_MAX_FILES);
+
+        count = FW_MAX_FILES;
+    }
+
+    memset(pWatch->mPendingPaths, 0, sizeof(pWatch->mPendingPaths));
+
+    for(uint32_t i = 0; i < count; i++) {
+        snprintf(pWatch->mPendingPaths[i], sizeof(pWatch->mPendingPaths[i]), "%s", paths[i]);
+    }
+
+    pWatch->mPendingCount = count;
+    pWatch->mPendingDirty = true;
+
+    pthread_mutex_unlock(&pWatch->mMutex);
+}
+
+void* __FWThread(void* pData) {
+    FileWatch_t* pWatch = (FileWatch_t*)pData;
+
+    uint32_t pending = 0;
+    double first = 0.0, last = 0.0;
+
+    while(!atomic_load(&pWatch->mQuit)) {
+        __FWApplyFiles(pWatch);
+
+        // Check often only when burst is in progress
+        uint32_t mask = __FWCollect(pWatch, pending ? 5 : FW_IDLE_MS);
+        double now = UTGetTimeMs();
+
+        if(mask) {
+            if(!pending) {
+                first = now;
+            }
+
+            pending |= mask;
+            last = now;
+        }
+
+        // Editors write files in bursts (truncate, write, rename, chmod...), wait until it is quiet
+        if(pending && now - last >= pWatch->mDebounceMs) {
+            if(!__FWPush(pWatch, (FileWatchEvent_t){pending, first})) {
+                printf("[INFO]: File watch queue is full, change dropped\n");
+            }
+
+            pending = 0;
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief Start watching files
+ *
+ * @param pWatch
+ * @param paths file paths, empty paths are ignored, index of path is bit in event mask
+ * @param count
+ * @param debounceMs how long files must be quiet before change is posted
+ * @return true
+ * @return false watching is not available
+ */
+bool FWInit(FileWatch_t* pWatch, const char** paths, uint32_t count, double debounceMs) {
+    memset(pWatch, 0, sizeof(FileWatch_t));
+
+    pWatch->mDebounceMs = debounceMs;
+    pthread_mutex_init(&pWatch->mMutex, nullptr);
+
+#ifdef __linux__
+    pWatch->mFd = inotify_init1(IN_NONBLOCK);
+
+    if(pWatch->mFd < 0) {
+        printf("[INFO]: Cannot initialize inotify, automatic reload disabled\n");
+
+        return false;
+    }
+#endif
+
+    FWSetFiles(pWatch, paths, count);
+    __FWApplyFiles(pWatch);
+
+    atomic_store(&pWatch->mHead, 0);
+    atomic_store(&pWatch->mTail, 0);
+    atomic_store(&pWatch->mQuit, false);
+
+    pWatch->mRunning = pthread_create(&pWatch->mThread, nullptr, __FWThread, pWatch) == 0;
+
+    return pWatch->mRunning;
+}
+
+/**
+ * @brief Stop watcher thread
+ *
+ * @param pWatch
+ */
+void FWTerminate(FileWatch_t* pWatch) {
+    if(pWatch->mRunning) {
+        atomic_store(&pWatch->mQuit, true);
+        pthread_join(pWatch->mThread, nullptr);
+        pWatch->mRunning = false;
+    }
+
+#ifdef __linux__
+    if(pWatch->mFd >= 0) {
+        close(pWatch->mFd);
+        pWatch->mFd = -1;
+    }
+#endif
+
+    pthread_mutex_destroy(&pWatch->mMutex);
+}
+
+#endif
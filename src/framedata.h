@@ -0,0 +1,162 @@
+#ifndef __FRAME_DATA_
+#define __FRAME_DATA_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <glad/gl.h>
+
+// Frames in flight, CPU writes one slot while GPU may still read other two
+#define FD_RING_SIZE 3
+#define FD_BINDING 0
+#define FD_BLOCK_NAME "FrameData"
+
+/**
+ * @brief Per frame uniform block, std140 layout, shaders opt in by declaring:
+ *
+ * layout(std140, binding = 0) uniform FrameData {
+ *     mat4 uProjection;
+ *     mat4 uView;
+ *     mat4 uTransform;
+ *     float uTime;
+ *     float uDeltaTime;
+ *     vec2 uResolution;
+ *     mat4 uMeshDecode;
+ * };
+ */
+typedef struct FrameData_s {
+    float mProjection[16];
+    float mView[16];
+    float mTransform[16];
+    float mTime;
+    float mDeltaTime;
+    float mResolution[2];
+    // Takes position attribute of drawn mesh into mesh units, identity unless mesh is quantized
+    float mMeshDecode[16];
+} FrameData_t;
+
+/**
+ * @brief Persistently mapped ring of FrameData_t blocks (GL_ARB_buffer_storage, core since 4.4)
+ */
+typedef struct FrameRing_s {
+    uint32_t mBuffer;
+    uint8_t* pMapped;
+    uint32_t mStride;
+    GLsync mFences[FD_RING_SIZE];
+    uint32_t mFrame;
+    uint64_t mStalls;
+} FrameRing_t;
+
+/**
+ * @brief Create and map ring buffer
+ *
+ * @param pRing
+ */
+void FDInit(FrameRing_t* pRing) {
+    memset(pRing, 0, sizeof(FrameRing_t));
+
+    int alignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+
+    pRing->mStride = (sizeof(FrameData_t) + alignment - 1) / alignment * alignment;
+
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    glCreateBuffers(1, &pRing->mBuffer);
+    glNamedBufferStorage(pRing->mBuffer, pRing->mStride * FD_RING_SIZE, nullptr, flags);
+
+    pRing->pMapped = (uint8_t*)glMapNamedBufferRange(pRing->mBuffer, 0, pRing->mStride * FD_RING_SIZE, flags);
+
+    if(!pRing->pMapped) {
+        printf("[INFO]: Cannot map frame data buffer\n");
+    }
+}
+
+/**
+ * @brief Bind FrameData block of program to ring binding, for shaders which don`t specify binding themselves
+ *
+ * @param program
+ */
+void FDBindProgram(uint32_t program) {
+    if(!program) {
+        return;
+    }
+
+    uint32_t index = glGetUniformBlockIndex(program, FD_BLOCK_NAME);
+
+    if(index != GL_INVALID_INDEX) {
+        glUniformBlockBinding(program, index, FD_BINDING);
+    }
+}
+
+/**
+ * @brief Write frame data into next ring slot and bind it
+ *
+ * @param pRing
+ * @param pData
+ */
+void FDUpdate(FrameRing_t* pRing, const FrameData_t* pData) {
+    if(!pRing->pMapped) {
+        return;
+    }
+
+    uint32_t slot = pRing->mFrame % FD_RING_SIZE;
+
+    // GPU may still read this slot from FD_RING_SIZE frames ago
+    if(pRing->mFences[slot]) {
+        GLenum result = glClientWaitSync(pRing->mFences[slot], 0, 0);
+
+        if(result == GL_TIMEOUT_EXPIRED) {
+            pRing->mStalls++;
+
+            while(glClientWaitSync(pRing->mFences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED);
+        }
+
+        glDeleteSync(pRing->mFences[slot]);
+        pRing->mFences[slot] = nullptr;
+    }
+
+    memcpy(pRing->pMapped + slot * pRing->mStride, pData, sizeof(FrameData_t));
+
+    glBindBufferRange(GL_UNIFORM_BUFFER, FD_BINDING, pRing->mBuffer, slot * pRing->mStride, sizeof(FrameData_t));
+}
+
+/**
+ * @brief Fence current slot, call after last draw which uses frame data
+ *
+ * @param pRing
+ */
+void FDEndFrame(FrameRing_t* pRing) {
+    if(!pRing->pMapped) {
+        return;
+    }
+
+    pRing->mFences[pRing->mFrame % FD_RING_SIZE] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    pRing->mFrame++;
+}
+
+/**
+ * @brief Unmap and delete ring
+ *
+ * @param pRing
+ */
+void FDTerminate(FrameRing_t* pRing) {
+    for(uint32_t i = 0; i < FD_RING_SIZE; i++) {
+        if(pRing->mFences[i]) {
+            glDeleteSync(pRing->mFences[i]);
+        }
+    }
+
+    if(pRing->mBuffer) {
+        glUnmapNamedBuffer(pRing->mBuffer);
+        glDeleteBuffers(1, &pRing->mBuffer);
+    }
+
+    printf("[INFO]: Frame data ring: %u frames, %llu stalls\n", pRing->mFrame, (unsigned long long)pRing->mStalls);
+
+    memset(pRing, 0, sizeof(FrameRing_t));
+}
+
+#endif
@@ -0,0 +1,371 @@
+#ifndef __GPU_TIMER_
+#define __GPU_TIMER_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <glad/gl.h>
+
+#include "utils.h"
+
+// Frames of queries in flight, results are read this many frames later
+#define GT_RING 4
+#define GT_MAX_PASSES 8
+#define GT_MAX_NAME 32
+
+// GL_ARB_pipeline_statistics_query (core only since 4.6)
+#define GL_VERTEX_SHADER_INVOCATIONS_ARB 0x82F0
+#define GL_TESS_EVALUATION_SHADER_INVOCATIONS_ARB 0x82F2
+#define GL_GEOMETRY_SHADER_PRIMITIVES_EMITTED_ARB 0x82F3
+#define GL_FRAGMENT_SHADER_INVOCATIONS_ARB 0x82F4
+#define GL_CLIPPING_INPUT_PRIMITIVES_ARB 0x82F6
+#define GL_CLIPPING_OUTPUT_PRIMITIVES_ARB 0x82F7
+
+/**
+ * @brief Pipeline statistics counted for every pass when enabled
+ */
+enum GpuTimerStat {
+    GTVertexInvocations,
+    GTTessEvaluationInvocations,
+    GTGeometryPrimitives,
+    GTClippingInput,
+    GTClippingOutput,
+    GTFragmentInvocations,
+    GTStatCount
+};
+
+const GLenum gGpuTimerStatTargets[GTStatCount] = {
+    GL_VERTEX_SHADER_INVOCATIONS_ARB,
+    GL_TESS_EVALUATION_SHADER_INVOCATIONS_ARB,
+    GL_GEOMETRY_SHADER_PRIMITIVES_EMITTED_ARB,
+    GL_CLIPPING_INPUT_PRIMITIVES_ARB,
+    GL_CLIPPING_OUTPUT_PRIMITIVES_ARB,
+    GL_FRAGMENT_SHADER_INVOCATIONS_ARB
+};
+
+const char* gGpuTimerStatNames[GTStatCount] = {
+    "vs",
+    "tes",
+    "gs prims",
+    "clip in",
+    "clip out",
+    "fs"
+};
+
+/**
+ * @brief Timed pass (draw, compute, culling...), one GL_TIME_ELAPSED query per frame
+ */
+typedef struct GpuTimerPass_s {
+    char mName[GT_MAX_NAME];
+    double mSumMs;
+    uint32_t mSamples;
+    double mRollingMs;
+
+    double mStatSums[GTStatCount];
+    double mRollingStats[GTStatCount];
+} GpuTimerPass_t;
+
+/**
+ * @brief Pool of GPU timer queries, never waits for results
+ *
+ * GL_TIMESTAMP pair brackets whole frame, GL_TIME_ELAPSED query brackets every pass (elapsed queries can`t nest so passes can`t overlap)
+ * Optional pipeline statistics queries bracket every pass too, each counter has its own target so they run together
+ */
+typedef struct GpuTimer_s {
+    uint32_t mElapsed[GT_RING][GT_MAX_PASSES];
+    uint32_t mTimestamps[GT_RING][2];
+    uint32_t mPassMask[GT_RING];
+    bool mPending[GT_RING];
+
+    uint32_t mStats[GT_RING][GT_MAX_PASSES][GTStatCount];
+    bool mStatsEnabled;
+
+    GpuTimerPass_t mPasses[GT_MAX_PASSES];
+    uint32_t mPassCount;
+
+    double mFrameSumMs;
+    uint32_t mFrameSamples;
+    double mRollingFrameMs;
+
+    uint32_t mFrame;
+    // Current frame has no free query slot, it is not measured
+    bool mSkipFrame;
+    bool mPassOpen;
+    uint64_t mSkipped;
+    double mWindowStart;
+} GpuTimer_t;
+
+/**
+ * @brief Create query pool
+ *
+ * @param pTimer
+ * @param statistics also count shader invocations and primitives of every pass
+ */
+void GTInit(GpuTimer_t* pTimer, bool statistics) {
+    memset(pTimer, 0, sizeof(GpuTimer_t));
+
+    glGenQueries(GT_RING * GT_MAX_PASSES, &pTimer->mElapsed[0][0]);
+    glGenQueries(GT_RING * 2, &pTimer->mTimestamps[0][0]);
+
+    if(statistics) {
+        if(UTHasGLExtension("GL_ARB_pipeline_statistics_query")) {
+            glGenQueries(GT_RING * GT_MAX_PASSES * GTStatCount, &pTimer->mStats[0][0][0]);
+            pTimer->mStatsEnabled = true;
+        }
+        else {
+            printf("[INFO]: GL_ARB_pipeline_statistics_query is not supported, pipeline statistics disabled\n");
+        }
+    }
+
+    pTimer->mWindowStart = UTGetTimeMs();
+}
+
+/**
+ * @brief Add named pass
+ *
+ * @param pTimer
+ * @param name
+ * @return uint32_t pass index used with GTBeginPass, UINT32_MAX when there is no free pass (GTBeginPass ignores it)
+ */
+uint32_t GTRegisterPass(GpuTimer_t* pTimer, const char* name) {
+    if(pTimer->mPassCount >= GT_MAX_PASSES) {
+        printf("[INFO]: Too many GPU timer passes, <%s> is not timed\n", name);
+
+        return UINT32_MAX;
+    }
+
+    snprintf(pTimer->mPasses[pTimer->mPassCount].mName, GT_MAX_NAME, "%s", name);
+
+    return pTimer->mPassCount++;
+}
+
+/**
+ * @brief Read finished slot, returns without waiting when GPU is not done yet
+ *
+ * @param pTimer
+ * @param slot
+ * @return true slot is free
+ * @return false results are not available yet
+ */
+bool __GTCollect(GpuTimer_t* pTimer, uint32_t slot) {
+    if(!pTimer->mPending[slot]) {
+        return true;
+    }
+
+    // End timestamp is last command of frame, when it is done everything before is done too
+    int available = 0;
+    glGetQueryObjectiv(pTimer->mTimestamps[slot][1], GL_QUERY_RESULT_AVAILABLE, &available);
+
+    if(!available) {
+        return false;
+    }
+
+    uint64_t begin = 0, end = 0;
+    glGetQueryObjectui64v(pTimer->mTimestamps[slot][0], GL_QUERY_RESULT, &begin);
+    glGetQueryObjectui64v(pTimer->mTimestamps[slot][1], GL_QUERY_RESULT, &end);
+
+    pTimer->mFrameSumMs += (double)(end - begin) / 1000000.0;
+    pTimer->mFrameSamples++;
+
+    for(uint32_t i = 0; i < GT_MAX_PASSES; i++) {
+        if(!(pTimer->mPassMask[slot] & (1u << i))) {
+            continue;
+        }
+
+        uint64_t ns = 0;
+        glGetQueryObjectui64v(pTimer->mElapsed[slot][i], GL_QUERY_RESULT, &ns);
+
+        pTimer->mPasses[i].mSumMs += (double)ns / 1000000.0;
+        pTimer->mPasses[i].mSamples++;
+
+        for(uint32_t s = 0; s < GTStatCount && pTimer->mStatsEnabled; s++) {
+            uint64_t value = 0;
+            glGetQueryObjectui64v(pTimer->mStats[slot][i][s], GL_QUERY_RESULT, &value);
+
+            pTimer->mPasses[i].mStatSums[s] += (double)value;
+        }
+    }
+
+    pTimer->mPending[slot] = false;
+    pTimer->mPassMask[slot] = 0;
+
+    return true;
+}
+
+/**
+ * @brief Start GPU frame, call before first GL command of frame
+ *
+ * @param pTimer
+ */
+void GTBeginFrame(GpuTimer_t* pTimer) {
+    uint32_t slot = pTimer->mFrame % GT_RING;
+
+    // GPU is more than GT_RING frames behind, rather lose sample than stall
+    pTimer->mSkipFrame = !__GTCollect(pTimer, slot);
+
+    if(pTimer->mSkipFrame) {
+        pTimer->mSkipped++;
+
+        return;
+    }
+
+    glQueryCounter(pTimer->mTimestamps[slot][0], GL_TIMESTAMP);
+}
+
+/**
+ * @brief Start timing pass, pass which was never registered (timer not initialized) is ignored
+ *
+ * @param pTimer
+ * @param pass
+ */
+void GTBeginPass(GpuTimer_t* pTimer, uint32_t pass) {
+    if(pTimer->mSkipFrame || pass >= pTimer->mPassCount) {
+        return;
+    }
+
+    pTimer->mPassOpen = true;
+
+    uint32_t slot = pTimer->mFrame % GT_RING;
+
+    glBeginQuery(GL_TIME_ELAPSED, pTimer->mElapsed[slot][pass]);
+    pTimer->mPassMask[slot] |= 1u << pass;
+
+    for(uint32_t s = 0; s < GTStatCount && pTimer->mStatsEnabled; s++) {
+        glBeginQuery(gGpuTimerStatTargets[s], pTimer->mStats[slot][pass][s]);
+    }
+}
+
+/**
+ * @brief End timing pass started by GTBeginPass
+ *
+ * @param pTimer
+ */
+void GTEndPass(GpuTimer_t* pTimer) {
+    if(pTimer->mSkipFrame || !pTimer->mPassOpen) {
+        return;
+    }
+
+    pTimer->mPassOpen = false;
+
+    glEndQuery(GL_TIME_ELAPSED);
+
+    for(uint32_t s = 0; s < GTStatCount && pTimer->mStatsEnabled; s++) {
+        glEndQuery(gGpuTimerStatTargets[s]);
+    }
+}
+
+/**
+ * @brief End GPU frame, call after last GL command of frame
+ *
+ * @param pTimer
+ */
+void GTEndFrame(GpuTimer_t* pTimer) {
+    uint32_t slot = pTimer->mFrame % GT_RING;
+
+    if(!pTimer->mSkipFrame) {
+        glQueryCounter(pTimer->mTimestamps[slot][1], GL_TIMESTAMP);
+        pTimer->mPending[slot] = true;
+    }
+
+    pTimer->mFrame++;
+}
+
+/**
+ * @brief Average samples collected since last update
+ *
+ * @param pTimer
+ * @param intervalMs how long samples are averaged
+ * @return true new rolling values are ready
+ * @return false interval didn`t pass yet
+ */
+bool GTUpdate(GpuTimer_t* pTimer, double intervalMs) {
+    double now = UTGetTimeMs();
+
+    if(now - pTimer->mWindowStart < intervalMs || pTimer->mFrameSamples == 0) {
+        return false;
+    }
+
+    pTimer->mRollingFrameMs = pTimer->mFrameSumMs / pTimer->mFrameSamples;
+    pTimer->mFrameSumMs = 0.0;
+    pTimer->mFrameSamples = 0;
+
+    for(uint32_t i = 0; i < pTimer->mPassCount; i++) {
+        GpuTimerPass_t* pPass = &pTimer->mPasses[i];
+
+        pPass->mRollingMs = pPass->mSamples ? pPass->mSumMs / pPass->mSamples : 0.0;
+
+        for(uint32_t s = 0; s < GTStatCount; s++) {
+            pPass->mRollingStats[s] = pPass->mSamples ? pPass->mStatSums[s] / pPass->mSamples : 0.0;
+            pPass->mStatSums[s] = 0.0;
+        }
+
+        pPass->mSumMs = 0.0;
+        pPass->mSamples = 0;
+    }
+
+    pTimer->mWindowStart = now;
+
+    return true;
+}
+
+/**
+ * @brief Format rolling values as "GPU 1.23 ms (draw 1.10 ms)"
+ *
+ * @param pTimer
+ * @param buffer
+ * @param size
+ */
+void GTFormat(GpuTimer_t* pTimer, char* buffer, uint32_t size) {
+    int length = snprintf(buffer, size, "GPU %.3f ms (", pTimer->mRollingFrameMs);
+
+    for(uint32_t i = 0; i < pTimer->mPassCount && length > 0 && (uint32_t)length < size; i++) {
+        length += snprintf(buffer + length, size - length, "%s%s %.3f ms", i ? ", " : "", pTimer->mPasses[i].mName, pTimer->mPasses[i].mRollingMs);
+    }
+
+    if(length > 0 && (uint32_t)length < size) {
+        snprintf(buffer + length, size - length, ")");
+    }
+}
+
+/**
+ * @brief Print per frame pipeline statistics of every pass next to its GPU time, nothing when statistics are disabled
+ *
+ * @param pTimer
+ */
+void GTPrintStats(GpuTimer_t* pTimer) {
+    if(!pTimer->mStatsEnabled) {
+        return;
+    }
+
+    for(uint32_t i = 0; i < pTimer->mPassCount; i++) {
+        GpuTimerPass_t* pPass = &pTimer->mPasses[i];
+
+        printf("[INFO]:     %s %.3f ms:", pPass->mName, pPass->mRollingMs);
+
+        for(uint32_t s = 0; s < GTStatCount; s++) {
+            printf(" %s %.0f%s", gGpuTimerStatNames[s], pPass->mRollingStats[s], s + 1 < GTStatCount ? "," : "\n");
+        }
+    }
+}
+
+/**
+ * @brief Delete query pool
+ *
+ * @param pTimer
+ */
+void GTTerminate(GpuTimer_t* pTimer) {
+    glDeleteQueries(GT_RING * GT_MAX_PASSES, &pTimer->mElapsed[0][0]);
+    glDeleteQueries(GT_RING * 2, &pTimer->mTimestamps[0][0]);
+
+    if(pTimer->mStatsEnabled) {
+        glDeleteQueries(GT_RING * GT_MAX_PASSES * GTStatCount, &pTimer->mStats[0][0][0]);
+    }
+
+    printf("[INFO]: GPU timer: %u frames, %llu not measured (GPU too far behind)\n", pTimer->mFrame, (unsigned long long)pTimer->mSkipped);
+
+    memset(pTimer, 0, sizeof(GpuTimer_t));
+}
+
+#endif
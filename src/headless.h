@@ -0,0 +1,317 @@
+#ifndef __HEADLESS_
+#define __HEADLESS_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <dlfcn.h>
+#endif
+
+#include <glad/gl.h>
+
+// Minimal EGL subset, libEGL is opened at runtime so normal builds don`t need EGL headers or library
+typedef void* HLEGLDisplay_t;
+typedef void* HLEGLConfig_t;
+typedef void* HLEGLContext_t;
+typedef void* HLEGLSurface_t;
+typedef void (*HLEGLProc_t)(void);
+
+#define HL_EGL_NONE 0x3038
+#define HL_EGL_SURFACE_TYPE 0x3033
+#define HL_EGL_RENDERABLE_TYPE 0x3040
+#define HL_EGL_OPENGL_BIT 0x0008
+#define HL_EGL_OPENGL_API 0x30A2
+#define HL_EGL_EXTENSIONS 0x3055
+#define HL_EGL_CONTEXT_MAJOR_VERSION 0x3098
+#define HL_EGL_CONTEXT_MINOR_VERSION 0x30FB
+#define HL_EGL_CONTEXT_OPENGL_PROFILE_MASK 0x30FD
+#define HL_EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT 0x0001
+#define HL_EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+
+/**
+ * @brief Surfaceless EGL context and offscreen render target
+ */
+typedef struct Headless_s {
+    void* pLibrary;
+
+    HLEGLProc_t (*eglGetProcAddress)(const char*);
+    HLEGLDisplay_t (*eglGetDisplay)(void*);
+    HLEGLDisplay_t (*eglGetPlatformDisplayEXT)(int, void*, const int*);
+    unsigned (*eglInitialize)(HLEGLDisplay_t, int*, int*);
+    const char* (*eglQueryString)(HLEGLDisplay_t, int);
+    unsigned (*eglBindAPI)(unsigned);
+    unsigned (*eglChooseConfig)(HLEGLDisplay_t, const int*, HLEGLConfig_t*, int, int*);
+    HLEGLContext_t (*eglCreateContext)(HLEGLDisplay_t, HLEGLConfig_t, HLEGLContext_t, const int*);
+    unsigned (*eglMakeCurrent)(HLEGLDisplay_t, HLEGLSurface_t, HLEGLSurface_t, HLEGLContext_t);
+    unsigned (*eglDestroyContext)(HLEGLDisplay_t, HLEGLContext_t);
+    unsigned (*eglTerminate)(HLEGLDisplay_t);
+
+    HLEGLDisplay_t pDisplay;
+    HLEGLContext_t pContext;
+
+    uint32_t mFramebuffer;
+    uint32_t mColor, mDepth;
+    int mWidth, mHeight;
+} Headless_t;
+
+/**
+ * @brief Find EGL function in opened library
+ *
+ * @param pHeadless
+ * @param name
+ * @param pFunction where function pointer is written
+ * @return true
+ * @return false function is missing
+ */
+bool __HLSymbol(Headless_t* pHeadless, const char* name, void* pFunction) {
+#ifdef __linux__
+    void* pSymbol = dlsym(pHeadless->pLibrary, name);
+
+    // ISO C has no object to function pointer cast, copy bytes instead
+    memcpy(pFunction, &pSymbol, sizeof(void*));
+
+    return pSymbol != nullptr;
+#else
+    pHeadless = pHeadless;
+    name = name;
+    pFunction = pFunction;
+
+    return false;
+#endif
+}
+
+/**
+ * @brief Create OpenGL 4.5 core context without window or display server (EGL_MESA_platform_surfaceless) and make it current
+ *
+ * @param pHeadless
+ * @return true context is current, GL functions can be loaded with HLGetProcAddress
+ * @return false EGL or surfaceless platform is not available
+ */
+bool HLInit(Headless_t* pHeadless) {
+    memset(pHeadless, 0, sizeof(Headless_t));
+
+#ifdef __linux__
+    pHeadless->pLibrary = dlopen("libEGL.so.1", RTLD_NOW | RTLD_LOCAL);
+
+    if(!pHeadless->pLibrary) {
+        printf("[INFO]: Cannot open libEGL.so.1\n");
+
+        return false;
+    }
+#else
+    printf("[INFO]: Surfaceless EGL is supported only on Linux\n");
+
+    return false;
+#endif
+
+    bool loaded = __HLSymbol(pHeadless, "eglGetProcAddress", &pHeadless->eglGetProcAddress);
+    loaded = __HLSymbol(pHeadless, "eglGetDisplay", &pHeadless->eglGetDisplay) && loaded;
+    loaded = __HLSymbol(pHeadless, "eglInitialize", &pHeadless->eglInitialize) && loaded;
+    loaded = __HLSymbol(pHeadless, "eglQueryString", &pHeadless->eglQueryString) && loaded;
+    loaded = __HLSymbol(pHeadless, "eglBindAPI", &pHeadless->eglBindAPI) && loaded;
+    loaded = __HLSymbol(pHeadless, "eglChooseConfig", &pHeadless->eglChooseConfig) && loaded;
+    loaded = __HLSymbol(pHeadless, "eglCreateContext", &pHeadless->eglCreateContext) && loaded;
+    loaded = __HLSymbol(pHeadless, "eglMakeCurrent", &pHeadless->eglMakeCurrent) && loaded;
+    loaded = __HLSymbol(pHeadless, "eglDestroyContext", &pHeadless->eglDestroyContext) && loaded;
+    loaded = __HLSymbol(pHeadless, "eglTerminate", &pHeadless->eglTerminate) && loaded;
+
+    if(!loaded) {
+        printf("[INFO]: libEGL is missing core functions\n");
+
+        return false;
+    }
+
+    // Surfaceless platform needs no X11/Wayland/GBM device, fall back to default display when it is missing
+    const char* clientExtensions = pHeadless->eglQueryString(nullptr, HL_EGL_EXTENSIONS);
+
+    if(clientExtensions && strstr(clientExtensions, "EGL_MESA_platform_surfaceless")) {
+        HLEGLProc_t proc = pHeadless->eglGetProcAddress("eglGetPlatformDisplayEXT");
+        memcpy(&pHeadless->eglGetPlatformDisplayEXT, &proc, sizeof(HLEGLProc_t));
+    }
+
+    if(pHeadless->eglGetPlatformDisplayEXT) {
+        pHeadless->pDisplay = pHeadless->eglGetPlatformDisplayEXT(HL_EGL_PLATFORM_SURFACELESS_MESA, nullptr, nullptr);
+    }
+    else {
+        pHeadless->pDisplay = pHeadless->eglGetDisplay(nullptr);
+    }
+
+    int major = 0, minor = 0;
+
+    if(!pHeadless->pDisplay || !pHeadless->eglInitialize(pHeadless->pDisplay, &major, &minor)) {
+        printf("[INFO]: Cannot initialize EGL display\n");
+
+        return false;
+    }
+
+    const char* extensions = pHeadless->eglQueryString(pHeadless->pDisplay, HL_EGL_EXTENSIONS);
+
+    if(!extensions || !strstr(extensions, "EGL_KHR_surfaceless_context")) {
+        printf("[INFO]: EGL %d.%d has no EGL_KHR_surfaceless_context\n", major, minor);
+
+        return false;
+    }
+
+    const int configAttributes[] = {
+        HL_EGL_SURFACE_TYPE, 0,
+        HL_EGL_RENDERABLE_TYPE, HL_EGL_OPENGL_BIT,
+        HL_EGL_NONE
+    };
+
+    const int contextAttributes[] = {
+        HL_EGL_CONTEXT_MAJOR_VERSION, 4,
+        HL_EGL_CONTEXT_MINOR_VERSION, 5,
+        HL_EGL_CONTEXT_OPENGL_PROFILE_MASK, HL_EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        HL_EGL_NONE
+    };
+
+    HLEGLConfig_t config = nullptr;
+    int configCount = 0;
+
+    if(!pHeadless->eglBindAPI(HL_EGL_OPENGL_API) || !pHeadless->eglChooseConfig(pHeadless->pDisplay, configAttributes, &config, 1, &configCount) || configCount < 1) {
+        printf("[INFO]: No EGL config with desktop OpenGL\n");
+
+        return false;
+    }
+
+    pHeadless->pContext = pHeadless->eglCreateContext(pHeadless->pDisplay, config, nullptr, contextAttributes);
+
+    if(!pHeadless->pContext || !pHeadless->eglMakeCurrent(pHeadless->pDisplay, nullptr, nullptr, pHeadless->pContext)) {
+        printf("[INFO]: Cannot create surfaceless OpenGL 4.5 core context\n");
+
+        return false;
+    }
+
+    printf("[INFO]: Headless EGL %d.%d context created\n", major, minor);
+
+    return true;
+}
+
+/**
+ * @brief Find GL function, context created by HLInit must be current (EGL 1.5 returns core functions too), usable with gladLoadGLUserPtr
+ *
+ * @param pHeadless Headless_t
+ * @param name
+ * @return HLEGLProc_t
+ */
+HLEGLProc_t HLGetProcAddress(void* pHeadless, const char* name) {
+    Headless_t* pData = (Headless_t*)pHeadless;
+
+    return pData->eglGetProcAddress ? pData->eglGetProcAddress(name) : nullptr;
+}
+
+/**
+ * @brief Create offscreen framebuffer and bind it as draw and read target
+ *
+ * @param pHeadless
+ * @param width
+ * @param height
+ * @return true
+ * @return false framebuffer is incomplete
+ */
+bool HLCreateTarget(Headless_t* pHeadless, int width, int height) {
+    pHeadless->mWidth = width;
+    pHeadless->mHeight = height;
+
+    glCreateRenderbuffers(1, &pHeadless->mColor);
+    glNamedRenderbufferStorage(pHeadless->mColor, GL_RGBA8, width, height);
+
+    glCreateRenderbuffers(1, &pHeadless->mDepth);
+    glNamedRenderbufferStorage(pHeadless->mDepth, GL_DEPTH24_STENCIL8, width, height);
+
+    glCreateFramebuffers(1, &pHeadless->mFramebuffer);
+    glNamedFramebufferRenderbuffer(pHeadless->mFramebuffer, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, pHeadless->mColor);
+    glNamedFramebufferRenderbuffer(pHeadless->mFramebuffer, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, pHeadless->mDepth);
+
+    GLenum status = glCheckNamedFramebufferStatus(pHeadless->mFramebuffer, GL_FRAMEBUFFER);
+
+    if(status != GL_FRAMEBUFFER_COMPLETE) {
+        printf("[INFO]: Offscreen framebuffer incomplete (0x%04x)\n", status);
+
+        return false;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, pHeadless->mFramebuffer);
+    glViewport(0, 0, width, height);
+
+    return true;
+}
+
+/**
+ * @brief Read offscreen color and write it as binary PPM
+ *
+ * @param pHeadless
+ * @param path
+ * @return true
+ * @return false cannot write file
+ */
+bool HLWriteImage(Headless_t* pHeadless, const char* path) {
+    uint64_t rowSize = (uint64_t)pHeadless->mWidth * 3;
+    uint8_t* pPixels = (uint8_t*)malloc(rowSize * pHeadless->mHeight);
+
+    if(!pPixels) {
+        return false;
+    }
+
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, pHeadless->mWidth, pHeadless->mHeight, GL_RGB, GL_UNSIGNED_BYTE, pPixels);
+
+    FILE* pFile = fopen(path, "wb");
+
+    if(!pFile) {
+        printf("[INFO]: Cannot write image <%s>\n", path);
+        free(pPixels);
+
+        return false;
+    }
+
+    fprintf(pFile, "P6\n%d %d\n255\n", pHeadless->mWidth, pHeadless->mHeight);
+
+    // GL rows go bottom to top, PPM rows top to bottom
+    for(int y = pHeadless->mHeight - 1; y >= 0; y--) {
+        fwrite(pPixels + y * rowSize, 1, rowSize, pFile);
+    }
+
+    fclose(pFile);
+    free(pPixels);
+
+    printf("[INFO]: Saved %dx%d image <%s>\n", pHeadless->mWidth, pHeadless->mHeight, path);
+
+    return true;
+}
+
+/**
+ * @brief Delete render target and destroy context
+ *
+ * @param pHeadless
+ */
+void HLTerminate(Headless_t* pHeadless) {
+    if(pHeadless->mFramebuffer) {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &pHeadless->mFramebuffer);
+        glDeleteRenderbuffers(1, &pHeadless->mColor);
+        glDeleteRenderbuffers(1, &pHeadless->mDepth);
+    }
+
+    if(pHeadless->pContext) {
+        pHeadless->eglMakeCurrent(pHeadless->pDisplay, nullptr, nullptr, nullptr);
+        pHeadless->eglDestroyContext(pHeadless->pDisplay, pHeadless->pContext);
+    }
+
+    if(pHeadless->pDisplay) {
+        pHeadless->eglTerminate(pHeadless->pDisplay);
+    }
+
+#ifdef __linux__
+    if(pHeadless->pLibrary) {
+        dlclose(pHeadless->pLibrary);
+    }
+#endif
+
+    memset(pHeadless, 0, sizeof(Headless_t));
+}
+
+#endif
@@ -0,0 +1,596 @@
+#ifndef __HIZ_
+#define __HIZ_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include <glad/gl.h>
+
+#include "utils.h"
+#include "meshregistry.h"
+#include "shaderbuild.h"
+#include "framedata.h"
+#include "instances.h"
+#include "scene.h"
+
+#define HZ_GROUP_SIZE 64
+#define HZ_REDUCE_GROUP_SIZE 8
+// Frames counters are read after, same as frame data ring
+#define HZ_READBACK_FRAMES 3
+
+#define HZ_SPHERE_BINDING 6
+#define HZ_COMMAND_BINDING 7
+#define HZ_COUNTER_BINDING 8
+#define HZ_SOURCE_BINDING 9
+#define HZ_VISIBLE_BINDING 10
+
+/**
+ * @brief Counters written by culling pass
+ */
+typedef struct HiZCounters_s {
+    uint32_t mFrustumCulled;
+    uint32_t mOccluded;
+    // Screen area of bounding rectangles of occluded objects, upper estimate of fragments not shaded, 64-bit as low and high word
+    uint32_t mSavedPixels;
+    uint32_t mSavedPixelsHigh;
+} HiZCounters_t;
+
+/**
+ * @brief Depth pyramid of previous frame and GPU pass which culls scene draws or instances against it
+ */
+typedef struct HiZ_s {
+    uint32_t mReduceProgram;
+    uint32_t mCullProgram;
+
+    // Copy of depth buffer, format and sample count have to match source for blit
+    uint32_t mDepth;
+    uint32_t mFramebuffer;
+    GLenum mDepthFormat;
+    int mSamples;
+    int mWidth, mHeight;
+
+    // R32F, every texel is farthest depth of texels it covers, level 0 is half of screen
+    uint32_t mPyramid;
+    int mLevels;
+    int mPyramidWidth, mPyramidHeight;
+    // Pyramid and matrices it was rendered with are from last frame
+    bool mValid;
+    float mProjection[16];
+    float mView[16];
+    float mTransform[16];
+
+    // Instanced draws, survivors are copied into own transform buffer and counted in command
+    uint32_t mInstanceCommand;
+    uint32_t mVisibleBuffer;
+    uint32_t mVisibleCapacity;
+
+    // Persistently mapped counters, one slot per frame in flight
+    uint32_t mCounterBuffer;
+    uint8_t* pCounters;
+    uint32_t mCounterStride;
+    GLsync mFences[HZ_READBACK_FRAMES];
+    uint32_t mTested[HZ_READBACK_FRAMES];
+    uint32_t mFrame;
+
+    // Sums since last HZPrintStats
+    uint64_t mSumTested, mSumFrustumCulled, mSumOccluded, mSumSavedPixels, mSumPixels;
+    uint32_t mFrames;
+} HiZ_t;
+
+// Level 0 reads depth texture (every sample of multisampled one), last column and row of odd sized source fold into neighbour so no depth is skipped
+const char* gHiZReduceSource =
+    "#version 450 core\n"
+    "layout(local_size_x = 8, local_size_y = 8) in;\n"
+    "layout(binding = 0) uniform sampler2D uSource;\n"
+    "layout(binding = 1) uniform sampler2DMS uSourceMS;\n"
+    "layout(binding = 0, r32f) writeonly uniform image2D uTarget;\n"
+    "layout(location = 0) uniform int uSourceLevel;\n"
+    "layout(location = 1) uniform int uSamples;\n"
+    "void main() {\n"
+    "    ivec2 p = ivec2(gl_GlobalInvocationID.xy);\n"
+    "    ivec2 target = imageSize(uTarget);\n"
+    "    if(any(greaterThanEqual(p, target))) return;\n"
+    "    ivec2 source = uSamples > 0 ? textureSize(uSourceMS) : textureSize(uSource, uSourceLevel);\n"
+    "    ivec2 extent = ivec2(2) + ivec2(p.x == target.x - 1 ? source.x & 1 : 0, p.y == target.y - 1 ? source.y & 1 : 0);\n"
+    "    float depth = 0.0;\n"
+    "    for(int y = 0; y < extent.y; y++) {\n"
+    "        for(int x = 0; x < extent.x; x++) {\n"
+    "            ivec2 texel = min(p * 2 + ivec2(x, y), source - 1);\n"
+    "            if(uSamples > 0) {\n"
+    "                for(int i = 0; i < uSamples; i++) depth = max(depth, texelFetch(uSourceMS, texel, i).r);\n"
+    "            }\n"
+    "            else depth = max(depth, texelFetch(uSource, texel, uSourceLevel).r);\n"
+    "        }\n"
+    "    }\n"
+    "    imageStore(uTarget, p, vec4(depth));\n"
+    "}\n";
+
+// Frustum test uses current frame, occlusion test projects bounds with matrices of frame pyramid was built from
+const char* gHiZCullSource =
+    "#version 450 core\n"
+    "layout(local_size_x = 64) in;\n"
+    "layout(std140, binding = 0) uniform FrameData { mat4 uProjection; mat4 uView; mat4 uTransform; float uTime; float uDeltaTime; vec2 uResolution; };\n"
+    "layout(std430, binding = 6) readonly buffer Spheres { vec4 uSpheres[]; };\n"
+    "layout(std430, binding = 7) buffer Commands { uint uCommands[]; };\n"
+    "layout(std430, binding = 8) buffer Counters { uint uFrustumCulled; uint uOccluded; uint uSavedPixels; uint uSavedPixelsHigh; };\n"
+    "layout(std430, binding = 9) readonly buffer Source { mat4 uSource[]; };\n"
+    "layout(std430, binding = 10) writeonly buffer Visible { mat4 uVisible[]; };\n"
+    "layout(binding = 0) uniform sampler2D uPyramid;\n"
+    "layout(location = 0) uniform uint uCount;\n"
+    "layout(location = 1) uniform uint uFirst;\n"
+    "layout(location = 2) uniform uint uCommandBase;\n"
+    "layout(location = 3) uniform uint uCommandStride;\n"
+    "layout(location = 4) uniform bool uInstanced;\n"
+    "layout(location = 5) uniform vec4 uLocalSphere;\n"
+    "layout(location = 6) uniform bool uOcclusion;\n"
+    "layout(location = 7) uniform mat4 uPrevProjection;\n"
+    "layout(location = 8) uniform mat4 uPrevModelView;\n"
+    "float maxScale(mat4 m) { return max(max(length(m[0].xyz), length(m[1].xyz)), length(m[2].xyz)); }\n"
+    "bool occluded(vec4 sphere, inout float area) {\n"
+    "    vec3 c = (uPrevModelView * vec4(sphere.xyz, 1.0)).xyz;\n"
+    "    float r = sphere.w * maxScale(uPrevModelView);\n"
+    "    vec4 nearest = uPrevProjection * vec4(c.xy, c.z + r, 1.0);\n"
+    "    vec2 lo = vec2(1.0), hi = vec2(-1.0);\n"
+    "    for(int i = 0; i < 8; i++) {\n"
+    "        vec4 corner = uPrevProjection * vec4(c + r * vec3((i & 1) != 0 ? 1.0 : -1.0, (i & 2) != 0 ? 1.0 : -1.0, (i & 4) != 0 ? 1.0 : -1.0), 1.0);\n"
+    "        if(corner.w <= 1e-5) return false;\n"
+    "        lo = min(lo, corner.xy / corner.w);\n"
+    "        hi = max(hi, corner.xy / corner.w);\n"
+    "    }\n"
+    "    lo = clamp(lo * 0.5 + 0.5, 0.0, 1.0);\n"
+    "    hi = clamp(hi * 0.5 + 0.5, 0.0, 1.0);\n"
+    "    vec2 size = (hi - lo) * vec2(textureSize(uPyramid, 0));\n"
+    "    int level = clamp(int(ceil(log2(max(max(size.x, size.y), 1.0)))), 0, textureQueryLevels(uPyramid) - 1);\n"
+    "    ivec2 levelSize = textureSize(uPyramid, level);\n"
+    "    ivec2 a = clamp(ivec2(lo * vec2(levelSize)), ivec2(0), levelSize - 1);\n"
+    "    ivec2 b = clamp(ivec2(hi * vec2(levelSize)), ivec2(0), levelSize - 1);\n"
+    "    float farthest = max(max(texelFetch(uPyramid, a, level).r, texelFetch(uPyramid, ivec2(b.x, a.y), level).r), max(texelFetch(uPyramid, ivec2(a.x, b.y), level).r, texelFetch(uPyramid, b, level).r));\n"
+    "    area = (hi.x - lo.x) * (hi.y - lo.y) * uResolution.x * uResolution.y;\n"
+    "    return nearest.z / nearest.w * 0.5 + 0.5 > farthest;\n"
+    "}\n"
+    "void main() {\n"
+    "    uint i = gl_GlobalInvocationID.x;\n"
+    "    if(i >= uCount) return;\n"
+    "    mat4 model = uInstanced ? uSource[i] : mat4(1.0);\n"
+    "    vec4 sphere = uInstanced ? vec4((model * vec4(uLocalSphere.xyz, 1.0)).xyz, uLocalSphere.w * maxScale(model)) : uSpheres[uFirst + i];\n"
+    "    mat4 mv = uView * uTransform;\n"
+    "    vec3 c = (mv * vec4(sphere.xyz, 1.0)).xyz;\n"
+    "    float r = sphere.w * maxScale(mv);\n"
+    "    mat4 p = transpose(uProjection);\n"
+    "    vec4 planes[6] = vec4[6](p[3] + p[0], p[3] - p[0], p[3] + p[1], p[3] - p[1], p[3] + p[2], p[3] - p[2]);\n"
+    "    bool visible = true;\n"
+    "    float area = 0.0;\n"
+    "    for(int k = 0; k < 6 && visible; k++) {\n"
+    "        visible = dot(planes[k].xyz, c) + planes[k].w >= -r * length(planes[k].xyz);\n"
+    "    }\n"
+    "    if(!visible) atomicAdd(uFrustumCulled, 1u);\n"
+    "    else if(uOcclusion && occluded(sphere, area)) {\n"
+    "        visible = false;\n"
+    "        atomicAdd(uOccluded, 1u);\n"
+    "        uint saved = uint(min(area, uResolution.x * uResolution.y));\n"
+    "        if(atomicAdd(uSavedPixels, saved) + saved < saved) atomicAdd(uSavedPixelsHigh, 1u);\n"
+    "    }\n"
+    "    if(!uInstanced) uCommands[uCommandBase + i * uCommandStride + 1u] = visible ? 1u : 0u;\n"
+    "    else if(visible) uVisible[atomicAdd(uCommands[uCommandBase + 1u], 1u)] = model;\n"
+    "}\n";
+
+/**
+ * @brief Compile culling and reduction programs and create counters, pyramid is created with first HZBuildPyramid
+ *
+ * @param pHiZ
+ * @return true
+ * @return false shader failed
+ */
+bool HZInit(HiZ_t* pHiZ) {
+    memset(pHiZ, 0, sizeof(HiZ_t));
+
+    pHiZ->mReduceProgram = SBBuildComputeProgram("hi-z reduce", gHiZReduceSource);
+    pHiZ->mCullProgram = SBBuildComputeProgram("hi-z cull", gHiZCullSource);
+
+    if(!pHiZ->mReduceProgram || !pHiZ->mCullProgram) {
+        return false;
+    }
+
+    int alignment = 256;
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+
+    pHiZ->mCounterStride = (sizeof(HiZCounters_t) + alignment - 1) / alignment * alignment;
+
+    GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    glCreateBuffers(1, &pHiZ->mCounterBuffer);
+    glNamedBufferStorage(pHiZ->mCounterBuffer, pHiZ->mCounterStride * HZ_READBACK_FRAMES, nullptr, flags);
+    pHiZ->pCounters = (uint8_t*)glMapNamedBufferRange(pHiZ->mCounterBuffer, 0, pHiZ->mCounterStride * HZ_READBACK_FRAMES, flags);
+
+    if(!pHiZ->pCounters) {
+        printf("[INFO]: Cannot map hi-z counters, culling stats are disabled\n");
+    }
+
+    glCreateBuffers(1, &pHiZ->mInstanceCommand);
+    glNamedBufferStorage(pHiZ->mInstanceCommand, 5 * sizeof(uint32_t), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+    return true;
+}
+
+/**
+ * @brief Collect counters of slot written HZ_READBACK_FRAMES frames ago, clear it and bind it with pyramid and culling program
+ *
+ * @param pHiZ
+ * @param tested objects culled this frame
+ */
+void __HZBeginCull(HiZ_t* pHiZ, uint32_t tested) {
+    uint32_t slot = pHiZ->mFrame % HZ_READBACK_FRAMES;
+
+    if(pHiZ->mFences[slot]) {
+        while(glClientWaitSync(pHiZ->mFences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED);
+
+        glDeleteSync(pHiZ->mFences[slot]);
+        pHiZ->mFences[slot] = nullptr;
+
+        if(pHiZ->pCounters) {
+            HiZCounters_t counters;
+
+            memcpy(&counters, pHiZ->pCounters + slot * pHiZ->mCounterStride, sizeof(counters));
+
+            pHiZ->mSumTested += pHiZ->mTested[slot];
+            pHiZ->mSumFrustumCulled += counters.mFrustumCulled;
+            pHiZ->mSumOccluded += counters.mOccluded;
+            pHiZ->mSumSavedPixels += (uint64_t)counters.mSavedPixelsHigh << 32 | counters.mSavedPixels;
+            pHiZ->mSumPixels += (uint64_t)pHiZ->mWidth * pHiZ->mHeight;
+            pHiZ->mFrames++;
+        }
+    }
+
+    pHiZ->mTested[slot] = tested;
+
+    glClearNamedBufferSubData(pHiZ->mCounterBuffer, GL_R32UI, slot * pHiZ->mCounterStride, sizeof(HiZCounters_t), GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, HZ_COUNTER_BINDING, pHiZ->mCounterBuffer, slot * pHiZ->mCounterStride, sizeof(HiZCounters_t));
+
+    glUseProgram(pHiZ->mCullProgram);
+    glBindTextureUnit(0, pHiZ->mPyramid);
+
+    glProgramUniform1i(pHiZ->mCullProgram, 6, pHiZ->mValid);
+    glProgramUniformMatrix4fv(pHiZ->mCullProgram, 7, 1, GL_FALSE, pHiZ->mProjection);
+
+    // Same product shaders do, view first
+    float modelView[16];
+
+    for(uint32_t c = 0; c < 4; c++) {
+        for(uint32_t r = 0; r < 4; r++) {
+            modelView[c * 4 + r] = 0.0f;
+
+            for(uint32_t k = 0; k < 4; k++) {
+                modelView[c * 4 + r] += pHiZ->mView[k * 4 + r] * pHiZ->mTransform[c * 4 + k];
+            }
+        }
+    }
+
+    glProgramUniformMatrix4fv(pHiZ->mCullProgram, 8, 1, GL_FALSE, modelView);
+}
+
+/**
+ * @brief Make indirect arguments visible to draws and fence counters
+ *
+ * @param pHiZ
+ */
+void __HZEndCull(HiZ_t* pHiZ) {
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT | GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT);
+    glUseProgram(0);
+    glBindTextureUnit(0, 0);
+
+    pHiZ->mFences[pHiZ->mFrame % HZ_READBACK_FRAMES] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    pHiZ->mFrame++;
+}
+
+/**
+ * @brief Set instance count of every scene draw to 0 when it is outside frustum or hidden in last frame depth and to 1 otherwise, call after FDUpdate and before draw program is bound
+ *
+ * @param pHiZ
+ * @param pScene
+ * @return true
+ * @return false culling is not available
+ */
+bool HZCullScene(HiZ_t* pHiZ, Scene_t* pScene) {
+    if(!pHiZ->mCullProgram || !pScene->mObjectCount) {
+        return false;
+    }
+
+    __HZBeginCull(pHiZ, pScene->mObjectCount);
+
+    glProgramUniform1i(pHiZ->mCullProgram, 4, GL_FALSE);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, HZ_SPHERE_BINDING, pScene->mSphereBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, HZ_COMMAND_BINDING, pScene->mCommandBuffer);
+
+    for(uint32_t b = 0; b < pScene->mBatchCount; b++) {
+        SceneBatch_t* pBatch = &pScene->mBatches[b];
+
+        if(pBatch->mDrawCount == 0) {
+            continue;
+        }
+
+        glProgramUniform1ui(pHiZ->mCullProgram, 0, pBatch->mDrawCount);
+        glProgramUniform1ui(pHiZ->mCullProgram, 1, pBatch->mFirstDraw);
+        glProgramUniform1ui(pHiZ->mCullProgram, 2, (uint32_t)(pBatch->mCommandOffset / sizeof(uint32_t)));
+        glProgramUniform1ui(pHiZ->mCullProgram, 3, (pBatch->mIndexType ? sizeof(SceneElementsCommand_t) : sizeof(SceneArraysCommand_t)) / sizeof(uint32_t));
+
+        glDispatchCompute((pBatch->mDrawCount + HZ_GROUP_SIZE - 1) / HZ_GROUP_SIZE, 1, 1);
+    }
+
+    __HZEndCull(pHiZ);
+
+    return true;
+}
+
+/**
+ * @brief Copy transforms of instances which are inside frustum and weren`t hidden in last frame depth into visible buffer and count them in indirect command, call after INBuild and FDUpdate and before draw program is bound
+ *
+ * @param pHiZ
+ * @param pInstances
+ * @param pRegistry
+ * @param mesh drawn mesh, its bounds are bounds of every instance
+ * @return true
+ * @return false culling is not available
+ */
+bool HZCullInstances(HiZ_t* pHiZ, Instances_t* pInstances, MeshRegistry_t* pRegistry, uint32_t mesh) {
+    if(!pHiZ->mCullProgram || !pInstances->mBuffer || mesh >= pRegistry->mCount) {
+        return false;
+    }
+
+    if(pHiZ->mVisibleCapacity < pInstances->mCount) {
+        glDeleteBuffers(1, &pHiZ->mVisibleBuffer);
+        glCreateBuffers(1, &pHiZ->mVisibleBuffer);
+        glNamedBufferStorage(pHiZ->mVisibleBuffer, (uint64_t)pInstances->mCount * 16 * sizeof(float), nullptr, 0);
+
+        pHiZ->mVisibleCapacity = pInstances->mCount;
+    }
+
+    const MeshEntry_t* pMesh = &pRegistry->mMeshes[mesh];
+    uint32_t command[5] = {0};
+
+    // Instance count at index 1 is 0 here and counted up by culling pass
+    if(pMesh->mDesc.mIndexType) {
+        command[0] = pMesh->mDesc.mIndexCount;
+        command[2] = (uint32_t)(pMesh->mIndexOffset / MRIndexSize(pMesh->mDesc.mIndexType));
+        command[3] = pMesh->mBaseVertex;
+    }
+    else {
+        command[0] = pMesh->mDesc.mVertexCount;
+        command[2] = pMesh->mBaseVertex;
+    }
+
+    glNamedBufferSubData(pHiZ->mInstanceCommand, 0, sizeof(command), command);
+
+    float sphere[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+
+    for(uint32_t c = 0; c < 3; c++) {
+        sphere[c] = (pMesh->mMin[c] + pMesh->mMax[c]) * 0.5f;
+        sphere[3] += (pMesh->mMax[c] - pMesh->mMin[c]) * (pMesh->mMax[c] - pMesh->mMin[c]) * 0.25f;
+    }
+
+    sphere[3] = sqrtf(sphere[3]);
+
+    __HZBeginCull(pHiZ, pInstances->mCount);
+
+    glProgramUniform1ui(pHiZ->mCullProgram, 0, pInstances->mCount);
+    glProgramUniform1ui(pHiZ->mCullProgram, 2, 0);
+    glProgramUniform1i(pHiZ->mCullProgram, 4, GL_TRUE);
+    glProgramUniform4fv(pHiZ->mCullProgram, 5, 1, sphere);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, HZ_COMMAND_BINDING, pHiZ->mInstanceCommand);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, HZ_SOURCE_BINDING, pInstances->mBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, HZ_VISIBLE_BINDING, pHiZ->mVisibleBuffer);
+
+    glDispatchCompute((pInstances->mCount + HZ_GROUP_SIZE - 1) / HZ_GROUP_SIZE, 1, 1);
+
+    __HZEndCull(pHiZ);
+
+    return true;
+}
+
+/**
+ * @brief Draw instances which survived last HZCullInstances, visible transforms are bound as InstanceData
+ *
+ * @param pHiZ
+ * @param pRegistry
+ * @param mesh
+ */
+void HZDrawInstances(HiZ_t* pHiZ, MeshRegistry_t* pRegistry, uint32_t mesh) {
+    MeshEntry_t* pMesh = &pRegistry->mMeshes[mesh];
+
+    glBindVertexArray(pRegistry->mVaos[pMesh->mFormat]);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, IN_BINDING, pHiZ->mVisibleBuffer);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, pHiZ->mInstanceCommand);
+
+    if(pMesh->mDesc.mIndexType) {
+        glDrawElementsIndirect(pMesh->mDesc.mPrimitive, pMesh->mDesc.mIndexType, nullptr);
+    }
+    else {
+        glDrawArraysIndirect(pMesh->mDesc.mPrimitive, nullptr);
+    }
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+/**
+ * @brief Depth format of framebuffer, copy target must match it
+ *
+ * @param framebuffer 0 for window
+ * @return GLenum
+ */
+GLenum __HZDepthFormat(uint32_t framebuffer) {
+    int depth = 24, stencil = 0, type = GL_UNSIGNED_NORMALIZED;
+
+    glGetNamedFramebufferAttachmentParameteriv(framebuffer, framebuffer ? GL_DEPTH_ATTACHMENT : GL_DEPTH, GL_FRAMEBUFFER_ATTACHMENT_DEPTH_SIZE, &depth);
+    glGetNamedFramebufferAttachmentParameteriv(framebuffer, framebuffer ? GL_DEPTH_ATTACHMENT : GL_DEPTH, GL_FRAMEBUFFER_ATTACHMENT_COMPONENT_TYPE, &type);
+    glGetNamedFramebufferAttachmentParameteriv(framebuffer, framebuffer ? GL_STENCIL_ATTACHMENT : GL_STENCIL, GL_FRAMEBUFFER_ATTACHMENT_STENCIL_SIZE, &stencil);
+
+    if(type == GL_FLOAT) {
+        return stencil ? GL_DEPTH32F_STENCIL8 : GL_DEPTH_COMPONENT32F;
+    }
+
+    if(stencil) {
+        return GL_DEPTH24_STENCIL8;
+    }
+
+    return depth > 24 ? GL_DEPTH_COMPONENT32 : (depth > 16 ? GL_DEPTH_COMPONENT24 : GL_DEPTH_COMPONENT16);
+}
+
+/**
+ * @brief (Re)create depth copy and pyramid for new screen size, depth format or sample count
+ *
+ * @param pHiZ
+ * @param width
+ * @param height
+ * @param format
+ * @param samples sample count of source, 0 when it isn`t multisampled
+ */
+void __HZResize(HiZ_t* pHiZ, int width, int height, GLenum format, int samples) {
+    glDeleteFramebuffers(1, &pHiZ->mFramebuffer);
+    glDeleteTextures(1, &pHiZ->mDepth);
+    glDeleteTextures(1, &pHiZ->mPyramid);
+
+    pHiZ->mWidth = width;
+    pHiZ->mHeight = height;
+    pHiZ->mDepthFormat = format;
+    pHiZ->mSamples = samples;
+
+    bool stencil = format == GL_DEPTH24_STENCIL8 || format == GL_DEPTH32F_STENCIL8;
+
+    // Multisampled depth is copied as is, resolving blit would keep single sample which isn`t farthest at silhouettes
+    if(samples > 1) {
+        glCreateTextures(GL_TEXTURE_2D_MULTISAMPLE, 1, &pHiZ->mDepth);
+        glTextureStorage2DMultisample(pHiZ->mDepth, samples, format, width, height, GL_TRUE);
+    }
+    else {
+        glCreateTextures(GL_TEXTURE_2D, 1, &pHiZ->mDepth);
+        glTextureStorage2D(pHiZ->mDepth, 1, format, width, height);
+        glTextureParameteri(pHiZ->mDepth, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTextureParameteri(pHiZ->mDepth, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    }
+
+    glCreateFramebuffers(1, &pHiZ->mFramebuffer);
+    glNamedFramebufferTexture(pHiZ->mFramebuffer, stencil ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT, pHiZ->mDepth, 0);
+
+    pHiZ->mPyramidWidth = width / 2 > 1 ? width / 2 : 1;
+    pHiZ->mPyramidHeight = height / 2 > 1 ? height / 2 : 1;
+    pHiZ->mLevels = (int)floor(log2((double)(pHiZ->mPyramidWidth > pHiZ->mPyramidHeight ? pHiZ->mPyramidWidth : pHiZ->mPyramidHeight))) + 1;
+
+    glCreateTextures(GL_TEXTURE_2D, 1, &pHiZ->mPyramid);
+    glTextureStorage2D(pHiZ->mPyramid, pHiZ->mLevels, GL_R32F, pHiZ->mPyramidWidth, pHiZ->mPyramidHeight);
+    glTextureParameteri(pHiZ->mPyramid, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTextureParameteri(pHiZ->mPyramid, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    printf("[INFO]: Hi-z pyramid %dx%d with %d levels\n", pHiZ->mPyramidWidth, pHiZ->mPyramidHeight, pHiZ->mLevels);
+}
+
+/**
+ * @brief Copy depth of bound framebuffer and reduce it into pyramid for next frame, call after last draw of frame
+ *
+ * @param pHiZ
+ * @param width
+ * @param height
+ * @param pFrameData matrices frame was drawn with, next frame projects bounds with them
+ */
+void HZBuildPyramid(HiZ_t* pHiZ, int width, int height, const FrameData_t* pFrameData) {
+    if(!pHiZ->mReduceProgram || width <= 0 || height <= 0) {
+        return;
+    }
+
+    int source = 0;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &source);
+
+    GLenum format = __HZDepthFormat(source);
+    int samples = 0;
+
+    glGetNamedFramebufferParameteriv(source, GL_SAMPLES, &samples);
+    samples = samples > 1 ? samples : 0;
+
+    if(width != pHiZ->mWidth || height != pHiZ->mHeight || format != pHiZ->mDepthFormat || samples != pHiZ->mSamples) {
+        __HZResize(pHiZ, width, height, format, samples);
+    }
+
+    // Same sample count on both sides, so blit copies every sample and first reduction takes farthest of them
+    glBlitNamedFramebuffer(source, pHiZ->mFramebuffer, 0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+
+    glUseProgram(pHiZ->mReduceProgram);
+
+    for(int level = 0; level < pHiZ->mLevels; level++) {
+        int levelWidth = pHiZ->mPyramidWidth >> level, levelHeight = pHiZ->mPyramidHeight >> level;
+        bool multisampled = level == 0 && pHiZ->mSamples;
+
+        levelWidth = levelWidth ? levelWidth : 1;
+        levelHeight = levelHeight ? levelHeight : 1;
+
+        glBindTextureUnit(0, level ? pHiZ->mPyramid : (multisampled ? 0 : pHiZ->mDepth));
+        glBindTextureUnit(1, multisampled ? pHiZ->mDepth : 0);
+        glProgramUniform1i(pHiZ->mReduceProgram, 0, level ? level - 1 : 0);
+        glProgramUniform1i(pHiZ->mReduceProgram, 1, multisampled ? pHiZ->mSamples : 0);
+        glBindImageTexture(0, pHiZ->mPyramid, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+
+        glDispatchCompute((levelWidth + HZ_REDUCE_GROUP_SIZE - 1) / HZ_REDUCE_GROUP_SIZE, (levelHeight + HZ_REDUCE_GROUP_SIZE - 1) / HZ_REDUCE_GROUP_SIZE, 1);
+
+        // Next level fetches this one
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+    }
+
+    glUseProgram(0);
+    glBindTextureUnit(0, 0);
+    glBindTextureUnit(1, 0);
+
+    memcpy(pHiZ->mProjection, pFrameData->mProjection, sizeof(pHiZ->mProjection));
+    memcpy(pHiZ->mView, pFrameData->mView, sizeof(pHiZ->mView));
+    memcpy(pHiZ->mTransform, pFrameData->mTransform, sizeof(pHiZ->mTransform));
+
+    pHiZ->mValid = true;
+}
+
+/**
+ * @brief Print average culled objects and estimated fragments saved per frame since last call
+ *
+ * @param pHiZ
+ */
+void HZPrintStats(HiZ_t* pHiZ) {
+    if(pHiZ->mFrames == 0) {
+        return;
+    }
+
+    double frames = pHiZ->mFrames;
+
+    printf("[INFO]:     hi-z: %.0f of %.0f objects occluded, %.0f outside frustum, ~%.0f fragments saved per frame (%.1f%% of screen)\n", pHiZ->mSumOccluded / frames, pHiZ->mSumTested / frames, pHiZ->mSumFrustumCulled / frames, pHiZ->mSumSavedPixels / frames, pHiZ->mSumPixels ? 100.0 * pHiZ->mSumSavedPixels / pHiZ->mSumPixels : 0.0);
+
+    pHiZ->mSumTested = pHiZ->mSumFrustumCulled = pHiZ->mSumOccluded = pHiZ->mSumSavedPixels = pHiZ->mSumPixels = 0;
+    pHiZ->mFrames = 0;
+}
+
+/**
+ * @brief Delete programs, textures, buffers and fences
+ *
+ * @param pHiZ
+ */
+void HZTerminate(HiZ_t* pHiZ) {
+    for(uint32_t i = 0; i < HZ_READBACK_FRAMES; i++) {
+        if(pHiZ->mFences[i]) {
+            glDeleteSync(pHiZ->mFences[i]);
+        }
+    }
+
+    if(pHiZ->pCounters) {
+        glUnmapNamedBuffer(pHiZ->mCounterBuffer);
+    }
+
+    glDeleteProgram(pHiZ->mReduceProgram);
+    glDeleteProgram(pHiZ->mCullProgram);
+    glDeleteFramebuffers(1, &pHiZ->mFramebuffer);
+    glDeleteTextures(1, &pHiZ->mDepth);
+    glDeleteTextures(1, &pHiZ->mPyramid);
+    glDeleteBuffers(1, &pHiZ->mInstanceCommand);
+    glDeleteBuffers(1, &pHiZ->mVisibleBuffer);
+    glDeleteBuffers(1, &pHiZ->mCounterBuffer);
+
+    memset(pHiZ, 0, sizeof(HiZ_t));
+}
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef __INSTANCES_
+#define __INSTANCES_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include <glad/gl.h>
+
+#include "math3d.h"
+#include "utils.h"
+
+#define IN_BINDING 1
+// Instances per thread below which generation isn`t split further
+#define IN_MIN_INSTANCES 1024
+// Gap between neighbours in mesh sizes
+#define IN_SPACING 1.5f
+
+/**
+ * @brief Per instance transforms in shader storage buffer, shaders opt in by declaring:
+ *
+ * layout(std430, binding = 1) readonly buffer InstanceData {
+ *     mat4 uInstances[];
+ * };
+ *
+ * and transform position with uInstances[gl_InstanceID] before uTransform
+ */
+typedef struct Instances_s {
+    uint32_t mBuffer;
+    uint32_t mCount;
+    // Mesh extent transforms were laid out for, grid is rebuilt when it changes
+    float mExtent;
+} Instances_t;
+
+typedef struct __INContext_s {
+    float* pMatrices;
+    // Floats between two matrices, 16 when tightly packed
+    uint32_t mStride;
+    uint32_t mSide;
+    float mSpacing;
+} __INContext_t;
+
+void __INGenerate(uint32_t begin, uint32_t end, void* pData) {
+    __INContext_t* pContext = (__INContext_t*)pData;
+    uint32_t side = pContext->mSide;
+    float center = (side - 1) * 0.5f;
+
+    for(uint32_t i = begin; i < end; i++) {
+        // Stable pseudo random rotation and scale from instance index
+        uint64_t hash = UTHash(&i, sizeof(i), UT_HASH_SEED);
+        float angle = (float)(hash & 0xFFFF) / 65535.0f * 6.28318530718f;
+        float scale = 0.75f + (float)((hash >> 16) & 0xFFFF) / 65535.0f * 0.5f;
+
+        vec4_t position = {
+            ((float)(i % side) - center) * pContext->mSpacing,
+            ((float)(i / side % side) - center) * pContext->mSpacing,
+            ((float)(i / (side * side)) - center) * pContext->mSpacing,
+            1.0f
+        };
+
+        // MX4Translate stores offset in row-major order while shaders read columns, transpose puts it into last column
+        mat4_t matrix = MX4MulMX4(MX4Transpose(MX4Translate(position)), MX4MulMX4(MX4RotateY(angle), MX4Scale((vec4_t){scale, scale, scale, 1.0f})));
+
+        memcpy(&pContext->pMatrices[(uint64_t)i * pContext->mStride], matrix.m, 16 * sizeof(float));
+    }
+}
+
+/**
+ * @brief Generate transforms on cube grid in parallel, grid is centered at origin
+ *
+ * @param pMatrices output, count matrices
+ * @param count
+ * @param stride floats between two matrices, at least 16
+ * @param spacing distance of neighbours
+ * @param pSide optional, receives grid side
+ * @return uint32_t threads used
+ */
+uint32_t INGenerateTransforms(float* pMatrices, uint32_t count, uint32_t stride, float spacing, uint32_t* pSide) {
+    __INContext_t context = {
+        .pMatrices = pMatrices,
+        .mStride = stride,
+        .mSide = (uint32_t)ceil(cbrt((double)count)),
+        .mSpacing = spacing
+    };
+
+    context.mSide = context.mSide ? context.mSide : 1;
+
+    if(pSide) {
+        *pSide = context.mSide;
+    }
+
+    return UTParallelFor(count, IN_MIN_INSTANCES, __INGenerate, &context);
+}
+
+/**
+ * @brief Generate count transforms on cube grid in parallel and upload them into immutable storage buffer
+ *
+ * @param pInstances
+ * @param count
+ * @param extent largest size of drawn mesh, sets grid spacing
+ * @return true
+ * @return false out of memory
+ */
+bool INBuild(Instances_t* pInstances, uint32_t count, float extent) {
+    if(pInstances->mBuffer && pInstances->mCount == count && pInstances->mExtent == extent) {
+        return true;
+    }
+
+    double start = UTGetTimeMs();
+    float* pMatrices = (float*)malloc((uint64_t)(count ? count : 1) * 16 * sizeof(float));
+
+    if(!pMatrices) {
+        printf("[INFO]: Not enough memory for %u instances\n", count);
+
+        return false;
+    }
+
+    uint32_t side = 1;
+    uint32_t threads = INGenerateTransforms(pMatrices, count, 16, (extent > 0.0f ? extent : 1.0f) * IN_SPACING, &side);
+
+    glDeleteBuffers(1, &pInstances->mBuffer);
+    glCreateBuffers(1, &pInstances->mBuffer);
+    glNamedBufferStorage(pInstances->mBuffer, (uint64_t)(count ? count : 1) * 16 * sizeof(float), pMatrices, 0);
+
+    free(pMatrices);
+
+    pInstances->mCount = count;
+    pInstances->mExtent = extent;
+
+    printf("[INFO]: %u instances on %ux%ux%u grid generated in %.2f ms on %u threads\n", count, side, side, side, UTGetTimeMs() - start, threads);
+
+    return true;
+}
+
+/**
+ * @brief Bind transforms for next draw
+ *
+ * @param pInstances
+ */
+void INBind(Instances_t* pInstances) {
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, IN_BINDING, pInstances->mBuffer);
+}
+
+/**
+ * @brief Delete buffer
+ *
+ * @param pInstances
+ */
+void INTerminate(Instances_t* pInstances) {
+    glDeleteBuffers(1, &pInstances->mBuffer);
+
+    memset(pInstances, 0, sizeof(Instances_t));
+}
+
+#endif
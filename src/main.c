@@ -14,6 +14,9 @@
  * For windows just run .exe file
  */
 
+// We compile with -std=c2x which hides POSIX stuff (clock_gettime, utime, ...)
+#define _DEFAULT_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
@@ -25,8 +28,33 @@
 
 #include "math3d.h"
 #include "meshes.h"
+#include "meshregistry.h"
+#include "meshindex.h"
+#include "meshgen.h"
+#include "meshimport.h"
+#include "meshcache.h"
+#include "instances.h"
+#include "scene.h"
+#include "meshlet.h"
+#include "hiz.h"
+#include "meshsimplify.h"
+#include "meshquantize.h"
+#include "meshattrib.h"
+#include "utils.h"
+#include "programcache.h"
+#include "preprocess.h"
+#include "shaderbuild.h"
+#include "filewatch.h"
+#include "pipeline.h"
+#include "uniforms.h"
+#include "framedata.h"
+#include "headless.h"
+#include "bench.h"
+#include "gputimer.h"
 
 mat4_t gProj, /*gView,*/ gTrans;
+// Position decode of drawn mesh, identity unless it is quantized
+mat4_t gMeshDecode;
 
 // Global variables, cuz why not
 int gUsedShape = Plane;
@@ -36,79 +64,297 @@ char gComputeShader[1024];
 char gGeometryShader[1024];
 char gTessevShader[1024];
 char gTessctrlShader[1024];
-bool gRefreshPressed = false;
+bool gReloadRequested = false;
 
 float gScale = 0.1f;
 float gMultiplyBy = 1.0f;
 
+char gCacheDirectory[1024] = ".shader_cache";
+uint64_t gCacheSize = 64ull * 1024ull * 1024ull;
+bool gCacheDisabled = false;
+ProgramCache_t gProgramCache;
+ShaderRebuild_t gRebuild;
+double gDebounceMs = 50.0;
+FileWatch_t gFileWatch;
+bool gSeparable = false;
+ShaderPipeline_t gPipeline;
+const char* gIncludeDirs[PP_MAX_INCLUDE_DIRS];
+uint32_t gIncludeDirCount = 0;
+Preprocessor_t gPreprocessor;
+// Index 0 is used by monolithic program, pipeline uses one per stage
+UniformTable_t gUniforms[SB_MAX_STAGES];
+FrameRing_t gFrameRing;
+int gWidth = 800, gHeight = 600;
+bool gHeadlessMode = false;
+Headless_t gHeadless;
+uint32_t gHeadlessFrames = 60;
+char gOutputPath[1024];
+uint32_t gBenchFrames = 0;
+uint32_t gBenchWarmup = 30;
+char gBenchOutput[1024] = "bench.json";
+Bench_t gBench;
+GpuTimer_t gGpuTimer;
+bool gPipelineStats = false;
+// Timer passes, UINT32_MAX when pass is not timed
+uint32_t gDrawPass = UINT32_MAX;
+uint32_t gCullPass = UINT32_MAX;
+uint32_t gHiZPass = UINT32_MAX;
+// Meshes are added in Shape order so gUsedShape is mesh index
+MeshRegistry_t gMeshRegistry;
+char gShapeSpec[256];
+char gMeshCacheDirectory[1024] = ".mesh_cache";
+bool gMeshCacheDisabled = false;
+// 0 draws single object without instance buffer
+uint32_t gInstanceCount = 0;
+Instances_t gInstances;
+// 0 disables multi draw indirect scene, otherwise it replaces single shape
+uint32_t gSceneObjects = 0;
+Scene_t gScene;
+// Single shape is drawn as meshlets culled by compute pass
+bool gMeshletCulling = false;
+Meshlets_t gMeshlets;
+// Scene draws or instances hidden in last frame depth are skipped
+bool gHiZCulling = false;
+HiZ_t gHiZ;
+// Triangle ratios of simplified custom shape levels, 0 draws custom shape as is
+float gLodRatios[MS_MAX_LODS];
+uint32_t gLodCount = 0;
+MeshLods_t gLods;
+// Normals, UVs and tangents of every shape, missing ones are generated
+bool gAttributes = false;
+int gNormals = MASmooth;
+int gUVs = MAPlanar;
+MeshAttributes_t gMeshAttributes;
+// Vertices are stored as 16-bit positions, octahedral normals and half float UVs
+bool gQuantize = false;
+MeshQuantizer_t gQuantizer;
+
+ShaderStage_t gStages[] = {
+    {.mPath = gVertexShader, .mType = GL_VERTEX_SHADER},
+    {.mPath = gFragmentShader, .mType = GL_FRAGMENT_SHADER},
+    {.mPath = gComputeShader, .mType = GL_COMPUTE_SHADER},
+    {.mPath = gGeometryShader, .mType = GL_GEOMETRY_SHADER},
+    {.mPath = gTessevShader, .mType = GL_TESS_EVALUATION_SHADER},
+    {.mPath = gTessctrlShader, .mType = GL_TESS_CONTROL_SHADER}
+};
+
+#define STAGE_COUNT (sizeof(gStages) / sizeof(ShaderStage_t))
+
+/**
+ * @brief Clamp function
+ * 
+ * @param val clamped value
+ * @param max max value
+ * @param min min value
+ * @return float 
+ */
+float clamp(float val, float max, float min) {
+    return val > max ? max : (val < min ? min : val);
+}
+
 /**
- * @brief Loads shaders from file
+ * @brief Sets built-in uniforms of program from its reflection table, unchanged values are not sent
  * 
- * @param path path to file
- * @param type shader type
- * @return uint32_t 
+ * @param pTable 
+ * @param time 
+ * @param deltaTime 
  */
-uint32_t LoadShader(const char* path, int type) {
-    // Open folder
-    FILE* f = fopen(path, "rb+");
+void SetUniforms(UniformTable_t* pTable, float time, float deltaTime) {
+    UNSetFloat(pTable, UNTime, time);
+    UNSetFloat(pTable, UNDeltaTime, deltaTime);
+    UNSetMatrix4(pTable, UNProjection, gProj.m);
+    // Here is mat4(1.0) becouse currently gView doesn`t work 
+    UNSetMatrix4(pTable, UNView, /*gView.m*/MX4One().m);
+    UNSetMatrix4(pTable, UNTransform, gTrans.m);
+    UNSetMatrix4(pTable, UNMeshDecode, gMeshDecode.m);
+}
+
+/**
+ * @brief Reflect uniforms of pipeline stage programs which changed
+ */
+void ReflectPipeline() {
+    for(uint32_t i = 0; i < STAGE_COUNT; i++) {
+        if(gPipeline.mPrograms[i] != gUniforms[i].mProgram) {
+            UNReflect(&gUniforms[i], gPipeline.mPrograms[i]);
+            UNPrint(&gUniforms[i]);
+            FDBindProgram(gPipeline.mPrograms[i]);
+        }
+    }
+}
+
+/**
+ * @brief Write frame data, set uniforms and draw used shape with current program or pipeline
+ * 
+ * @param sh monolithic program, unused with --separable
+ * @param time 
+ * @param deltaTime 
+ */
+void DrawScene(uint32_t sh, float time, float deltaTime) {
+    // Custom shape is drawn at coarsest level whose error stays under pixel on screen
+    uint32_t shape = gLods.mCount > 1 && gUsedShape == Custom ? MSSelectLod(&gLods, gScale, gProj.m, gHeight) : (uint32_t)gUsedShape;
+
+    // Scene draws carry decode of their mesh in model matrix
+    gMeshDecode = MX4One();
+
+    if(!gScene.mObjectCount) {
+        MRDecodeMatrix(&gMeshRegistry.mMeshes[shape], gMeshDecode.m);
+    }
 
-    // Get length
-    fseek(f, 0, SEEK_END);
-    uint32_t len = ftell(f);
-    fseek(f, 0, SEEK_SET);
+    // Frame data block, written once for every program
+    FrameData_t frameData = {
+        .mTime = time,
+        .mDeltaTime = deltaTime,
+        .mResolution = {(float)gWidth, (float)gHeight}
+    };
 
-    // Alloc some memory for source code
-    char *buffer = malloc(len + 1);
+    memcpy(frameData.mProjection, gProj.m, sizeof(frameData.mProjection));
+    memcpy(frameData.mView, /*gView.m*/MX4One().m, sizeof(frameData.mView));
+    memcpy(frameData.mTransform, gTrans.m, sizeof(frameData.mTransform));
+    memcpy(frameData.mMeshDecode, gMeshDecode.m, sizeof(frameData.mMeshDecode));
 
-    // Read file
-    fread(buffer, 1, len, f);
-    buffer[len] = '\0';
+    FDUpdate(&gFrameRing, &frameData);
 
-    // Close file
-    fclose(f);
+    if(gInstanceCount && !gScene.mObjectCount) {
+        // Grid spacing follows drawn mesh, transforms are generated again only when shape changes
+        const MeshEntry_t* pMesh = &gMeshRegistry.mMeshes[shape];
+        float extent = fmaxf(fmaxf(pMesh->mMax[0] - pMesh->mMin[0], pMesh->mMax[1] - pMesh->mMin[1]), pMesh->mMax[2] - pMesh->mMin[2]);
 
-    // Make shader
-    uint32_t shader = glCreateShader(type);
-    glShaderSource(shader, 1, (const char* const*)&buffer, nullptr);
-    glCompileShader(shader);
+        INBuild(&gInstances, gInstanceCount, extent);
+    }
 
-    // Check for any errors and display then if they exist
-    int isCompiled = 0;
+    // Culling reads frame data and uses own program, so it runs before draw program is bound
+    GTBeginPass(&gGpuTimer, gCullPass);
+    bool meshlets = gMeshletCulling && !gScene.mObjectCount && !gInstanceCount && MLCull(&gMeshlets, shape, gProj.m);
+    bool occlusion = gHiZCulling && (gScene.mObjectCount ? HZCullScene(&gHiZ, &gScene) : gInstanceCount && HZCullInstances(&gHiZ, &gInstances, &gMeshRegistry, shape));
+    GTEndPass(&gGpuTimer);
 
-    glGetShaderiv(shader, GL_COMPILE_STATUS, &isCompiled);
+    GTBeginPass(&gGpuTimer, gDrawPass);
 
-    if(!isCompiled) {
-        int maxLength = 0;
+    // Set uniforms and draw
+    if(gSeparable) {
+        glBindProgramPipeline(gPipeline.mPipeline);
 
-        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &maxLength);
+        for(uint32_t i = 0; i < STAGE_COUNT; i++) {
+            if(gPipeline.mPrograms[i]) {
+                SetUniforms(&gUniforms[i], time, deltaTime);
+            }
+        }
+    }
+    else {
+        glUseProgram(sh);
+        SetUniforms(&gUniforms[0], time, deltaTime);
+    }
 
-        char* infoLog = (char*)malloc(maxLength);
+    if(gScene.mObjectCount) {
+        SCDraw(&gScene, &gMeshRegistry);
+    }
+    else if(gInstanceCount && occlusion) {
+        HZDrawInstances(&gHiZ, &gMeshRegistry, shape);
+    }
+    else if(gInstanceCount) {
+        INBind(&gInstances);
+        MRDrawInstanced(&gMeshRegistry, shape, gInstanceCount);
+    }
+    else if(meshlets) {
+        MLDraw(&gMeshlets, &gMeshRegistry, shape);
+    }
+    else {
+        MRDraw(&gMeshRegistry, shape);
+    }
 
-        glGetShaderInfoLog(shader, maxLength, &maxLength, &infoLog[0]);
+    glBindVertexArray(0);
+    glUseProgram(0);
+    glBindProgramPipeline(0);
 
-        printf("[INFO]: Shader error <%s>: %s\n", path, infoLog);
+    GTEndPass(&gGpuTimer);
 
-        free(infoLog);
-        infoLog = nullptr;
+    // Next frame culls against depth of this one
+    if(occlusion) {
+        GTBeginPass(&gGpuTimer, gHiZPass);
+        HZBuildPyramid(&gHiZ, gWidth, gHeight, &frameData);
+        GTEndPass(&gGpuTimer);
     }
 
-    // Free allocated memory, to everyone reading this commenst: DO NOT FORGET TO DO THAT, IT COUSES MANY ERRORS
-    free(buffer);
-    
-    // Return out compiled shader
-    return shader;
+    FDEndFrame(&gFrameRing);
 }
 
 /**
- * @brief Clamp function
+ * @brief Render frames into offscreen target with fixed 60 Hz time step (same input gives same image), print frame times and save last frame
  * 
- * @param val clamped value
- * @param max max value
- * @param min min value
- * @return float 
+ * With --bench warm-up frames are rendered first and then measured frames are written to JSON
+ * 
+ * @param sh 
  */
-float clamp(float val, float max, float min) {
-    return val > max ? max : (val < min ? min : val);
+void RenderHeadless(uint32_t sh) {
+    if(!HLCreateTarget(&gHeadless, gWidth, gHeight)) {
+        return;
+    }
+
+    gTrans = MX4Scale((vec4_t){gScale, gScale, gScale, 1.0f});
+
+    if(gBenchFrames) {
+        if(!BNInit(&gBench, gBenchFrames)) {
+            return;
+        }
+
+        gHeadlessFrames = gBenchWarmup + gBenchFrames;
+    }
+
+    double total = 0.0, minMs = 1e9, maxMs = 0.0;
+
+    for(uint32_t i = 0; i < gHeadlessFrames; i++) {
+        // Warm-up frames let driver finish lazy shader compilation and clocks ramp up
+        bool measured = gBenchFrames && i >= gBenchWarmup;
+
+        if(measured) {
+            BNBeginFrame(&gBench);
+        }
+
+        double start = UTGetTimeMs();
+
+        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        DrawScene(sh, (float)i / 60.0f, 1.0f / 60.0f);
+
+        if(measured) {
+            // GPU time comes from queries, frames are not serialized
+            BNEndFrame(&gBench);
+        }
+        else {
+            // Nothing is presented, wait for GPU so frame time covers whole frame
+            glFinish();
+        }
+
+        double ms = UTGetTimeMs() - start;
+
+        total += ms;
+        minMs = ms < minMs ? ms : minMs;
+        maxMs = ms > maxMs ? ms : maxMs;
+    }
+
+    if(gHeadlessFrames > 0 && !gBenchFrames) {
+        printf("[INFO]: Headless %u frames at %dx%d: %.3f ms avg, %.3f ms min, %.3f ms max, %.2f ms total\n", gHeadlessFrames, gWidth, gHeight, total / gHeadlessFrames, minMs, maxMs, total);
+        SCPrintStats(&gScene);
+        MLPrintStats(&gMeshlets);
+        HZPrintStats(&gHiZ);
+        MSPrintStats(&gLods);
+    }
+
+    if(gBenchFrames) {
+        // Level drawn in last frame, levels share vertex buffer so indices are counted
+        uint32_t shape = gLods.mCount > 1 && gUsedShape == Custom ? gLods.mMeshes[gLods.mSelected] : (uint32_t)gUsedShape;
+        const MeshDesc_t* pDesc = &gMeshRegistry.mMeshes[shape].mDesc;
+        uint64_t vertices = gScene.mObjectCount ? gScene.mVertices : (uint64_t)(pDesc->mIndexType ? pDesc->mIndexCount : pDesc->mVertexCount) * (gInstanceCount ? gInstanceCount : 1);
+
+        BNFinish(&gBench);
+        BNWriteJson(&gBench, gBenchOutput, gBenchWarmup, gWidth, gHeight, gScene.mObjectCount ? "scene" : gMeshRegistry.mMeshes[gUsedShape].mName, vertices, gStages, STAGE_COUNT);
+        BNTerminate(&gBench);
+    }
+
+    if(gOutputPath[0]) {
+        HLWriteImage(&gHeadless, gOutputPath);
+    }
 }
 
 /**
@@ -124,6 +370,8 @@ void framebufferCallback(GLFWwindow* pWnd, int width, int height) {
 
     // Set new vievport
     glViewport(0, 0, width, height);
+    gWidth = width;
+    gHeight = height;
     
     // Set perspective
     gProj = MX4PerspectiveFOV((3.14159265359 / 180.0) * 90.0f, (real_t)width, (real_t)height, 0.001f, 30.0f * gMultiplyBy);
@@ -154,6 +402,26 @@ void scrollCallback(GLFWwindow* pWnd, double x, double y) {
     gScale = clamp(gScale, 10.0f * gMultiplyBy, 0.025f);
 }
 
+/**
+ * @brief Keyboard callback, used only for manual reload so we don`t need to poll R every frame
+ * 
+ * @param pWnd 
+ * @param key 
+ * @param scancode 
+ * @param action 
+ * @param mods 
+ */
+void keyCallback(GLFWwindow* pWnd, int key, int scancode, int action, int mods) {
+    // Error deleter
+    pWnd = pWnd;
+    scancode = scancode;
+    mods = mods;
+
+    if(key == GLFW_KEY_R && action == GLFW_PRESS) {
+        gReloadRequested = true;
+    }
+}
+
 int main(int argc, char **argv) {
     // Check for desired amount of arguments, id amount of args don`t satisfy, return 0 and let user know that he must study how to use program
     if(argc < 2) {
@@ -169,13 +437,36 @@ int main(int argc, char **argv) {
                 "%s [args...]\n"
                 "Available arguments:\n"
                 "\t--help                   | -h            -\tShow this prompt\n"
-                "\t--shape <shape>          | -s <shape>    -\tChange shape (cube, plane or plane10x10)\n"
+                "\t--shape <shape>          | -s <shape>    -\tChange shape (cube, plane, plane10x10, grid:WxH, sphere:N, torus:N, torus:MxN, cylinder:N, cylinder:NxH or .obj / .ply file)\n"
                 "\t--vertex <path>          | -v <path>     -\tSet used vertex shader\n"
                 "\t--fragment <path>        | -f <path>     -\tSet used fragment shader\n"
                 "\t--compute <path>         | -c <path>     -\tSet used compute shader\n"
                 "\t--tess_evaluation <path> | -te <path>    -\tSet used tesselation evaluation shader\n"
                 "\t--tess_control <path>    | -tc <path>    -\tSet used tesselation control shader\n"
                 "\t--multiply_by <number>   | -mb <number>  -\tMultiply all values by this number\n"
+                "\t--cache_dir <path>       | -cd <path>    -\tSet shader binary cache directory (default .shader_cache)\n"
+                "\t--cache_size <MiB>       | -cs <MiB>     -\tSet shader binary cache size cap (default 64)\n"
+                "\t--no_cache               | -nc           -\tDisable shader binary cache\n"
+                "\t--mesh_cache_dir <path>  | -mcd <path>   -\tSet imported mesh cache directory (default .mesh_cache)\n"
+                "\t--no_mesh_cache          | -nmc          -\tAlways import mesh files, don`t read or write mesh cache\n"
+                "\t--debounce <ms>          | -db <ms>      -\tHow long shader files must be quiet before automatic reload (default 50)\n"
+                "\t--separable              | -sp           -\tBuild every stage as separable program in program pipeline\n"
+                "\t--include_dir <path>     | -id <path>    -\tAdd directory searched by #include (can be used multiple times)\n"
+                "\t--headless               | -hl           -\tRender offscreen without window (surfaceless EGL) and exit\n"
+                "\t--resolution <WxH>       | -r <WxH>      -\tSet window or offscreen resolution (default 800x600)\n"
+                "\t--frames <count>         | -n <count>    -\tFrames rendered in headless mode (default 60)\n"
+                "\t--output <path>          | -o <path>     -\tSave last headless frame as PPM image\n"
+                "\t--bench <frames>         | -b <frames>   -\tBenchmark frames offscreen and write CPU/GPU time percentiles as JSON\n"
+                "\t--warmup <frames>        | -wu <frames>  -\tFrames rendered before benchmark is measured (default 30)\n"
+                "\t--bench_output <path>    | -bo <path>    -\tBenchmark JSON file (default bench.json)\n"
+                "\t--pipeline_stats         | -ps           -\tCount shader invocations and primitives of every pass (GL_ARB_pipeline_statistics_query)\n"
+                "\t--instances <count>      | -in <count>   -\tDraw shape count times in one instanced call, transforms are in InstanceData buffer\n"
+                "\t--scene <objects>        | -sc <objects> -\tDraw objects cycling through all shapes with glMultiDrawElementsIndirect, per draw data is in DrawData buffer\n"
+                "\t--meshlets               | -ml           -\tSplit indexed shapes into meshlets and cull them against frustum and normal cone in compute shader\n"
+                "\t--hiz                    | -hz           -\tCull --scene objects or --instances hidden in last frame depth pyramid on GPU\n"
+                "\t--attributes <modes>     | -at <modes>   -\tGenerate normals (smooth or flat), UVs (planar or spherical) and tangents, e.g. flat,spherical, inputs are iNormal, iUV, iTangent at locations 1, 2, 3\n"
+                "\t--quantize               | -qz           -\tStore vertices as 16-bit positions, octahedral normals and half float UVs, shaders decode position with uMeshDecode\n"
+                "\t--lods <ratios>          | -lod <ratios> -\tSimplify custom shape to comma separated triangle ratios (e.g. 0.5,0.25,0.1) and draw level matching screen size\n"
 
                 , argv[0]
             );
@@ -189,6 +480,10 @@ int main(int argc, char **argv) {
             else if(strcmp(argv[i + 1], "plane10x10") == 0) {
                 gUsedShape = Plane10;
             }
+            else if(strchr(argv[i + 1], ':') || strstr(argv[i + 1], ".obj") || strstr(argv[i + 1], ".ply")) {
+                snprintf(gShapeSpec, sizeof(gShapeSpec), "%s", argv[i + 1]);
+                gUsedShape = Custom;
+            }
             else {
                 gUsedShape = Plane;
             }
@@ -214,6 +509,91 @@ int main(int argc, char **argv) {
         else if(strcmp(argv[i], "--multiply_by") == 0 || strcmp(argv[i], "-mb") == 0) {
             gMultiplyBy = atof(argv[i + 1]);
         }
+        else if(strcmp(argv[i], "--cache_dir") == 0 || strcmp(argv[i], "-cd") == 0) {
+            strcpy(gCacheDirectory, argv[i + 1]);
+        }
+        else if(strcmp(argv[i], "--cache_size") == 0 || strcmp(argv[i], "-cs") == 0) {
+            gCacheSize = (uint64_t)(atof(argv[i + 1]) * 1024.0 * 1024.0);
+        }
+        else if(strcmp(argv[i], "--no_cache") == 0 || strcmp(argv[i], "-nc") == 0) {
+            gCacheDisabled = true;
+        }
+        else if(strcmp(argv[i], "--mesh_cache_dir") == 0 || strcmp(argv[i], "-mcd") == 0) {
+            strcpy(gMeshCacheDirectory, argv[i + 1]);
+        }
+        else if(strcmp(argv[i], "--no_mesh_cache") == 0 || strcmp(argv[i], "-nmc") == 0) {
+            gMeshCacheDisabled = true;
+        }
+        else if(strcmp(argv[i], "--debounce") == 0 || strcmp(argv[i], "-db") == 0) {
+            gDebounceMs = atof(argv[i + 1]);
+        }
+        else if(strcmp(argv[i], "--separable") == 0 || strcmp(argv[i], "-sp") == 0) {
+            gSeparable = true;
+        }
+        else if((strcmp(argv[i], "--include_dir") == 0 || strcmp(argv[i], "-id") == 0) && gIncludeDirCount < PP_MAX_INCLUDE_DIRS) {
+            gIncludeDirs[gIncludeDirCount++] = argv[i + 1];
+        }
+        else if(strcmp(argv[i], "--headless") == 0 || strcmp(argv[i], "-hl") == 0) {
+            gHeadlessMode = true;
+        }
+        else if(strcmp(argv[i], "--resolution") == 0 || strcmp(argv[i], "-r") == 0) {
+            if(sscanf(argv[i + 1], "%dx%d", &gWidth, &gHeight) != 2 || gWidth <= 0 || gHeight <= 0) {
+                gWidth = 800;
+                gHeight = 600;
+            }
+        }
+        else if(strcmp(argv[i], "--frames") == 0 || strcmp(argv[i], "-n") == 0) {
+            gHeadlessFrames = (uint32_t)atoi(argv[i + 1]);
+        }
+        else if(strcmp(argv[i], "--output") == 0 || strcmp(argv[i], "-o") == 0) {
+            strcpy(gOutputPath, argv[i + 1]);
+        }
+        else if(strcmp(argv[i], "--bench") == 0 || strcmp(argv[i], "-b") == 0) {
+            // Benchmark runs offscreen at fixed resolution, never waits for vsync
+            gBenchFrames = (uint32_t)atoi(argv[i + 1]);
+
+            if(gBenchFrames) {
+                gHeadlessMode = true;
+            }
+        }
+        else if(strcmp(argv[i], "--warmup") == 0 || strcmp(argv[i], "-wu") == 0) {
+            gBenchWarmup = (uint32_t)atoi(argv[i + 1]);
+        }
+        else if(strcmp(argv[i], "--bench_output") == 0 || strcmp(argv[i], "-bo") == 0) {
+            strcpy(gBenchOutput, argv[i + 1]);
+        }
+        else if(strcmp(argv[i], "--pipeline_stats") == 0 || strcmp(argv[i], "-ps") == 0) {
+            gPipelineStats = true;
+        }
+        else if(strcmp(argv[i], "--instances") == 0 || strcmp(argv[i], "-in") == 0) {
+            gInstanceCount = (uint32_t)atoi(argv[i + 1]);
+        }
+        else if(strcmp(argv[i], "--scene") == 0 || strcmp(argv[i], "-sc") == 0) {
+            gSceneObjects = (uint32_t)atoi(argv[i + 1]);
+        }
+        else if(strcmp(argv[i], "--meshlets") == 0 || strcmp(argv[i], "-ml") == 0) {
+            gMeshletCulling = true;
+        }
+        else if(strcmp(argv[i], "--hiz") == 0 || strcmp(argv[i], "-hz") == 0) {
+            gHiZCulling = true;
+        }
+        else if(strcmp(argv[i], "--attributes") == 0 || strcmp(argv[i], "-at") == 0) {
+            gAttributes = MAParse(argv[i + 1], &gNormals, &gUVs);
+
+            if(!gAttributes) {
+                printf("[INFO]: Invalid attribute modes <%s>, expected smooth or flat and planar or spherical like flat,spherical\n", argv[i + 1]);
+            }
+        }
+        else if(strcmp(argv[i], "--quantize") == 0 || strcmp(argv[i], "-qz") == 0) {
+            gQuantize = true;
+        }
+        else if(strcmp(argv[i], "--lods") == 0 || strcmp(argv[i], "-lod") == 0) {
+            gLodCount = MSParseRatios(argv[i + 1], gLodRatios);
+
+            if(gLodCount == 0) {
+                printf("[INFO]: Invalid LOD ratios <%s>, expected values between 0 and 1 like 0.5,0.25\n", argv[i + 1]);
+            }
+        }
         // Currently textures are non-existant
         /*else if(strcmp(argv[i], "--texture") == 0 || strcmp(argv[i], "-t") == 0) {
 
@@ -221,122 +601,206 @@ int main(int argc, char **argv) {
     }
 
     // Multiply every value in vertices by multiplayer set by user (it doesn`t take long so we can just multiply it even if user doesn`t specified multiplayer) 
-    for(uint64_t i = 0; i < sizeof(gPlaneVertices) / sizeof(float); i++) {
-        gPlaneVertices[i] *= gMultiplyBy;
+    for(uint64_t i = 0; i < sizeof(gCubeVertices) / sizeof(float); i++) {
+        gCubeVertices[i] *= gMultiplyBy;
     }
 
-    for(uint64_t i = 0; i < sizeof(gPlane10Vertices) / sizeof(float); i++) {
-        gPlane10Vertices[i] *= gMultiplyBy;
-    }
+    GLFWwindow* window = nullptr;
 
-    for(uint64_t i = 0; i < sizeof(gCubeVertices) / sizeof(float); i++) {
-        gCubeVertices[i] *= gMultiplyBy;
+    // Surfaceless context needs no display, without EGL hidden window is used instead
+    if(gHeadlessMode && HLInit(&gHeadless)) {
+        if(!gladLoadGLUserPtr((GLADuserptrloadfunc)HLGetProcAddress, &gHeadless)) {
+            perror("Cannot load OpenGL 4.5 core context!");
+
+            return -2;
+        }
+
+        framebufferCallback(nullptr, gWidth, gHeight);
     }
+    else {
+        if(gHeadlessMode) {
+            printf("[INFO]: Surfaceless context unavailable, rendering offscreen in hidden window\n");
+        }
+        else {
+            // Info user how to use program quicker from window
+            printf("R - reaload\n1 - Plane\n2 - Plane 10x10\n3 - Cube\n4 - Custom shape (--shape generator or mesh file)\nScroll - Object scale\nMouse button 1 - Rotate object\n");
+        }
 
-    // Info user how to use program quicker from window
-    printf("R - reaload\n1 - Plane\n2 - Plane 10x10\n3 - Cube\nScroll - Object scale\nMouse button 1 - Rotate object\n");
+        // Initialize glfw
+        glfwInit();
 
-    // Initialize glfw
-    glfwInit();
+        // Set context verion of opengl to 4.5 core
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        // Set multisampling to 16 samples per pixel
+        glfwWindowHint(GLFW_SAMPLES, 16);
+        glfwWindowHint(GLFW_VISIBLE, !gHeadlessMode);
 
-    // Set context verion of opengl to 4.5 core
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-    // Set multisampling to 16 samples per pixel
-    glfwWindowHint(GLFW_SAMPLES, 16);
+        // Create window
+        window = glfwCreateWindow(gWidth, gHeight, "GLSL Shader Designer", nullptr, nullptr);
 
-    // Create window
-    GLFWwindow* window = glfwCreateWindow(800, 600, "GLSL Shader Designer", nullptr, nullptr);
+        // Check if we have window
+        if(!window) {
+            perror("Cannot create window!");
 
-    // Check if we have window
-    if(!window) {
-        perror("Cannot create window!");
+            return -1;
+        }
 
-        return -1;
-    }
+        // If window exist make it current context
+        glfwMakeContextCurrent(window);
+        glfwSwapInterval(0);
 
-    // If window exist make it current context
-    glfwMakeContextCurrent(window);
+        // Load OpenGL 4.5 core context
+        if(!gladLoadGL((GLADloadfunc)glfwGetProcAddress)) {
+            perror("Cannot load OpenGL 4.5 core context!");
 
-    // Load OpenGL 4.5 core context
-    if(!gladLoadGL((GLADloadfunc)glfwGetProcAddress)) {
-        perror("Cannot load OpenGL 4.5 core context!");
+            return -2;
+        }
 
-        return -2;
+        // Before setting callback set values to update perspective
+        framebufferCallback(window, gWidth, gHeight);
+        glfwSetScrollCallback(window, scrollCallback);
+        glfwSetFramebufferSizeCallback(window, framebufferCallback);
+        glfwSetKeyCallback(window, keyCallback);
     }
 
-    // Before setting callback set values to update perspective
-    framebufferCallback(window, 800, 600);
-    glfwSetScrollCallback(window, scrollCallback);
-    glfwSetFramebufferSizeCallback(window, framebufferCallback);
-
     glEnable(GL_DEPTH_TEST);
     glEnable(GL_MULTISAMPLE);
 
-    uint32_t vs = 0, fs = 0, gs = 0, cs = 0, tes = 0, tcs = 0;
-    uint32_t vao, vbo, sh;
+    uint32_t sh = 0;
 
-    // Create shader program
-    sh = glCreateProgram();
+    // Program binaries are keyed by driver strings so cache can start only now
+    if(!gCacheDisabled) {
+        PCInit(&gProgramCache, gCacheDirectory, gCacheSize);
+    }
 
-    // Load shader if they are specified and attach them to shader program
-    if(gVertexShader[0] != 0) {
-        vs = LoadShader(gVertexShader, GL_VERTEX_SHADER);
-        glAttachShader(sh, vs);
+    // Per frame uniform block shared by every program
+    FDInit(&gFrameRing);
+
+    // Expands #include in every stage
+    PPInit(&gPreprocessor, gIncludeDirs, gIncludeDirCount);
+
+    if(gSeparable) {
+        // Every stage is its own program, edits swap only changed stage
+        SPInit(&gPipeline);
+        SPUpdate(&gPipeline, gStages, STAGE_COUNT, (1u << STAGE_COUNT) - 1, &gProgramCache, &gPreprocessor);
+        ReflectPipeline();
+    }
+    else {
+        // Create shader program from user specified shaders, there is nothing to show yet so we wait for it
+        sh = SBBuildProgram(gStages, STAGE_COUNT, &gProgramCache, &gPreprocessor);
+        UNReflect(&gUniforms[0], sh);
+        UNPrint(&gUniforms[0]);
+        FDBindProgram(sh);
+
+        // Later rebuilds happen in background, headless mode never rebuilds
+        if(!gHeadlessMode) {
+            SBRebuildInit(&gRebuild, window, gStages, STAGE_COUNT, &gProgramCache, &gPreprocessor);
+        }
     }
 
-    if(gFragmentShader[0] != 0) {
-        fs = LoadShader(gFragmentShader, GL_FRAGMENT_SHADER);
-        glAttachShader(sh, fs);
+    // Watch shader files, first bits in change mask are indices in gStages, rest are included files
+    const char* watchPaths[FW_MAX_FILES];
+    char includePaths[FW_MAX_FILES][1024];
+    uint32_t watchedGeneration = ~0u;
+
+    for(uint32_t i = 0; i < STAGE_COUNT; i++) {
+        watchPaths[i] = gStages[i].mPath;
     }
 
-    if(gComputeShader[0] != 0) {
-        cs = LoadShader(gComputeShader, GL_COMPUTE_SHADER);
-        glAttachShader(sh, cs);
+    if(!gHeadlessMode) {
+        FWInit(&gFileWatch, watchPaths, STAGE_COUNT, gDebounceMs);
     }
 
-    if(gGeometryShader[0] != 0) {
-        gs = LoadShader(gGeometryShader, GL_GEOMETRY_SHADER);
-        glAttachShader(sh, gs);
+    // Every mesh goes to GPU once, switching shape only changes draw range
+    // Planes are generated grids, cube is triangle soup so weld and reorder it so every vertex is transformed about once
+    MeshGenDesc_t genDesc;
+    IndexedMesh_t generated[3] = {0};
+    IndexedMesh_t cube;
+    MeshDesc_t cubeDesc = MRDescPositions(sizeof(gCubeVertices) / (3 * sizeof(float)));
+
+    MGParse("grid:1x1", gMultiplyBy, &genDesc);
+    MGGenerate("plane", &genDesc, &generated[0]);
+    MRAdd(&gMeshRegistry, "plane", generated[0].pVertices, generated[0].pIndices, &generated[0].mDesc);
+
+    MGParse("grid:10x10", gMultiplyBy, &genDesc);
+    MGGenerate("plane10x10", &genDesc, &generated[1]);
+    MRAdd(&gMeshRegistry, "plane10x10", generated[1].pVertices, generated[1].pIndices, &generated[1].mDesc);
+
+    if(MIIndexMesh("cube", gCubeVertices, &cubeDesc, &cube)) {
+        MRAdd(&gMeshRegistry, "cube", cube.pVertices, cube.pIndices, &cube.mDesc);
     }
+    else {
+        MRAdd(&gMeshRegistry, "cube", gCubeVertices, nullptr, &cubeDesc);
+    }
+
+    // Generator string or OBJ / PLY file, imported files are mapped from mesh cache when source didn`t change
+    MeshCacheFile_t meshCache = {0};
+    bool custom = false;
 
-    if(gTessevShader[0] != 0) {
-        tes = LoadShader(gTessevShader, GL_TESS_EVALUATION_SHADER);
-        glAttachShader(sh, tes);
+    if(gShapeSpec[0] && strchr(gShapeSpec, ':') && !strstr(gShapeSpec, ".obj") && !strstr(gShapeSpec, ".ply")) {
+        custom = MGParse(gShapeSpec, gMultiplyBy, &genDesc) && MGGenerate(gShapeSpec, &genDesc, &generated[2]);
     }
+    else if(gShapeSpec[0] && !gMeshCacheDisabled && MCLoad(gMeshCacheDirectory, gShapeSpec, &meshCache)) {
+        custom = MRAddBounded(&gMeshRegistry, gShapeSpec, meshCache.pVertices, meshCache.pIndices, &meshCache.mDesc, meshCache.mMin, meshCache.mMax) >= 0;
+    }
+    else if(gShapeSpec[0]) {
+        custom = IMLoad(gShapeSpec, &generated[2]);
 
-    if(gTessctrlShader[0] != 0) {
-        tcs = LoadShader(gTessctrlShader, GL_TESS_CONTROL_SHADER);
-        glAttachShader(sh, tcs);
+        if(custom && !gMeshCacheDisabled) {
+            MCWrite(gMeshCacheDirectory, gShapeSpec, meshCache.mSourceHash, meshCache.mSourceLength, &generated[2]);
+        }
     }
 
-    // lInk shader program
-    glLinkProgram(sh);
+    if(custom && generated[2].pVertices) {
+        MRAdd(&gMeshRegistry, gShapeSpec, generated[2].pVertices, generated[2].pIndices, &generated[2].mDesc);
+    }
+    else if(!custom && gUsedShape == Custom) {
+        gUsedShape = Plane;
+    }
 
-    // Gen array and buffer
-    glGenVertexArrays(1, &vao);
-    glBindVertexArray(vao);
+    // Generated attributes change vertex counts and strides, so registry is laid out again before anything reads its offsets
+    if(gAttributes) {
+        MABuildRegistry(&gMeshAttributes, &gMeshRegistry, gNormals, gUVs);
+    }
 
-    glGenBuffers(1, &vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    // Registry is laid out again for smaller strides before anything reads its offsets
+    if(gQuantize) {
+        MQQuantizeRegistry(&gQuantizer, &gMeshRegistry);
+    }
 
-    // Bind desired start data
-    if(gUsedShape == Plane) {
-        glBufferData(GL_ARRAY_BUFFER, sizeof(gPlaneVertices), gPlaneVertices, GL_DYNAMIC_DRAW);
+    // Levels index custom shape vertices and are uploaded with it
+    if(custom && gLodCount) {
+        MSBuildLods(&gLods, &gMeshRegistry, Custom, gLodRatios, gLodCount);
     }
-    else if(gUsedShape == Plane10) {
-        glBufferData(GL_ARRAY_BUFFER, sizeof(gPlane10Vertices), gPlane10Vertices, GL_DYNAMIC_DRAW);
+
+    // Meshlet bounds are computed from vertices which are gone after upload
+    if(gMeshletCulling) {
+        MLBuild(&gMeshlets, &gMeshRegistry);
     }
-    else {
-        glBufferData(GL_ARRAY_BUFFER, sizeof(gCubeVertices), gCubeVertices, GL_DYNAMIC_DRAW);
+
+    // Cache pages are copied straight into registry buffer
+    MRUpload(&gMeshRegistry);
+    MCClose(&meshCache);
+    MLReleaseIndices(&gMeshlets);
+    MSReleaseIndices(&gLods);
+    MQReleaseVertices(&gQuantizer);
+    MAReleaseVertices(&gMeshAttributes);
+
+    if(gSceneObjects) {
+        SCBuild(&gScene, &gMeshRegistry, gSceneObjects);
+    }
+
+    if(gHiZCulling && !HZInit(&gHiZ)) {
+        gHiZCulling = false;
     }
 
-    // Enable layout attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, 0, 0, nullptr);
-    glEnableVertexAttribArray(0);
+    for(uint32_t i = 0; i < 3; i++) {
+        MIFree(&generated[i]);
+    }
 
-    glBindVertexArray(0);
+    MIFree(&cube);
 
     // Basicly don`t work
     //gView = MX4LookAt((vec4_t){0.0f, 0.0f, -4.0f, 0.0f}, (vec4_t){0.0f, 0.0f, 0.0f, 0.0f}, (vec4_t){0.0f, 1.0f, 0.0f, 0.0f});
@@ -345,8 +809,35 @@ int main(int argc, char **argv) {
     float c = 0.0f, l = 0.0f, d = 0.0f;
     double mx = 0.0, my = 0.0f;
 
-    // Main loop
-    while(!glfwWindowShouldClose(window)) {
+    // When change which is being rebuilt was saved, 0 if there is nothing in flight
+    double reloadStart = 0.0;
+    bool reportLatency = false;
+    uint32_t reloadMask = 0;
+
+    if(gHeadlessMode) {
+        RenderHeadless(sh);
+    }
+
+    // GPU cost of every pass, read few frames later so loop never waits for it
+    if(!gHeadlessMode) {
+        GTInit(&gGpuTimer, gPipelineStats);
+
+        // Culling gets own passes so its cost is not hidden in draw time
+        if(gMeshletCulling || gHiZCulling) {
+            gCullPass = GTRegisterPass(&gGpuTimer, "cull");
+        }
+
+        gDrawPass = GTRegisterPass(&gGpuTimer, "draw");
+
+        if(gHiZCulling) {
+            gHiZPass = GTRegisterPass(&gGpuTimer, "hi-z");
+        }
+    }
+
+    // Main loop, skipped in headless mode
+    while(!gHeadlessMode && !glfwWindowShouldClose(window)) {
+        GTBeginFrame(&gGpuTimer);
+
         // Clear screen and set bg color
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
@@ -354,136 +845,128 @@ int main(int argc, char **argv) {
         // Check if user desire other model
         if(glfwGetKey(window, GLFW_KEY_1) == GLFW_PRESS) {
             gUsedShape = Plane;
-            glBindVertexArray(vao);
-            glBindBuffer(GL_ARRAY_BUFFER, vbo);
-            glBufferData(GL_ARRAY_BUFFER, sizeof(gPlaneVertices), gPlaneVertices, GL_DYNAMIC_DRAW);
-            glBindVertexArray(0);
         }
         else if(glfwGetKey(window, GLFW_KEY_2) == GLFW_PRESS) {
             gUsedShape = Plane10;
-            glBindVertexArray(vao);
-            glBindBuffer(GL_ARRAY_BUFFER, vbo);
-            glBufferData(GL_ARRAY_BUFFER, sizeof(gPlane10Vertices), gPlane10Vertices, GL_DYNAMIC_DRAW);
-            glBindVertexArray(0);
         }
         else if(glfwGetKey(window, GLFW_KEY_3) == GLFW_PRESS) {
             gUsedShape = Cube;
-            glBindVertexArray(vao);
-            glBindBuffer(GL_ARRAY_BUFFER, vbo);
-            glBufferData(GL_ARRAY_BUFFER, sizeof(gCubeVertices), gCubeVertices, GL_DYNAMIC_DRAW);
-            glBindVertexArray(0);
+        }
+        else if(glfwGetKey(window, GLFW_KEY_4) == GLFW_PRESS && gMeshRegistry.mCount > Custom) {
+            gUsedShape = Custom;
         }
 
-        // Refresh
-        if(glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS && !gRefreshPressed) {
-            gRefreshPressed = true;
+        // Manual refresh, rebuild all stages
+        if(gReloadRequested) {
+            gReloadRequested = false;
 
             // Show previous info
-            printf("\nR - reaload\n1 - Plane\n2 - Plane 10x10\n3 - Cube\nScroll - Object scale\nMouse button 1 - Rotate object\n");
-
-            // Delete shader program and create new one
-            glDeleteProgram(sh);
-            sh = glCreateProgram();
+            printf("\nR - reaload\n1 - Plane\n2 - Plane 10x10\n3 - Cube\n4 - Custom shape (--shape generator or mesh file)\nScroll - Object scale\nMouse button 1 - Rotate object\n");
 
-            // Check user specified shaders, compile them, check for errors and return rebuild info 
-            if(gVertexShader[0] != 0) {
-                glDeleteShader(vs);
-                vs = LoadShader(gVertexShader, GL_VERTEX_SHADER);
-                glAttachShader(sh, vs);
+            reloadMask |= (1u << STAGE_COUNT) - 1;
 
-                printf("[INFO]: Rebuilded %s\n", gVertexShader);
+            if(reloadStart == 0.0) {
+                reloadStart = UTGetTimeMs();
             }
+        }
 
-            if(gFragmentShader[0] != 0) {
-                glDeleteShader(fs);
-                fs = LoadShader(gFragmentShader, GL_FRAGMENT_SHADER);
-                glAttachShader(sh, fs);
+        // Follow new included files
+        if(atomic_load(&gPreprocessor.mGeneration) != watchedGeneration) {
+            watchedGeneration = atomic_load(&gPreprocessor.mGeneration);
 
-                printf("[INFO]: Rebuilded %s\n", gFragmentShader);
-            }
+            uint32_t count = STAGE_COUNT + PPGetFiles(&gPreprocessor, includePaths, FW_MAX_FILES - STAGE_COUNT);
 
-            if(gComputeShader[0] != 0) {
-                glDeleteShader(cs);
-                cs = LoadShader(gComputeShader, GL_COMPUTE_SHADER);
-                glAttachShader(sh, cs);
-
-                printf("[INFO]: Rebuilded %s\n", gComputeShader);
+            for(uint32_t i = STAGE_COUNT; i < count; i++) {
+                watchPaths[i] = includePaths[i - STAGE_COUNT];
             }
 
-            if(gGeometryShader[0] != 0) {
-                glDeleteShader(gs);
-                gs = LoadShader(gGeometryShader, GL_GEOMETRY_SHADER);
-                glAttachShader(sh, gs);
+            FWSetFiles(&gFileWatch, watchPaths, count);
+        }
 
-                printf("[INFO]: Rebuilded %s\n", gGeometryShader);
-            }
+        // Automatic refresh, only stages which changed on disk or include changed file
+        FileWatchEvent_t event;
 
-            if(gTessevShader[0] != 0) {
-                glDeleteShader(tes);
-                tes = LoadShader(gTessevShader, GL_TESS_EVALUATION_SHADER);
-                glAttachShader(sh, tes);
+        while(FWPoll(&gFileWatch, &event)) {
+            reloadMask |= (event.mMask & ((1u << STAGE_COUNT) - 1)) | PPDirtyStages(&gPreprocessor);
 
-                printf("[INFO]: Rebuilded %s\n", gTessevShader);
+            if(reloadStart == 0.0 || event.mTime < reloadStart) {
+                reloadStart = event.mTime;
             }
+        }
 
-            if(gTessctrlShader[0] != 0) {
-                glDeleteShader(tcs);
-                tcs = LoadShader(gTessctrlShader, GL_TESS_CONTROL_SHADER);
-                glAttachShader(sh, tcs);
-
-                printf("[INFO]: Rebuilded %s\n", gTessctrlShader);
+        if(gSeparable) {
+            // Stage programs are small, swap changed ones right now
+            if(reloadMask) {
+                if(SPUpdate(&gPipeline, gStages, STAGE_COUNT, reloadMask, &gProgramCache, &gPreprocessor)) {
+                    reportLatency = reloadStart != 0.0;
+                }
+                else {
+                    reloadStart = 0.0;
+                }
+
+                ReflectPipeline();
+            }
+        }
+        else {
+            // Build new program in background, old one stays on screen until new one links
+            if(reloadMask) {
+                SBRebuildRequest(&gRebuild, reloadMask);
             }
 
-            // Link shader program
-            glLinkProgram(sh);
-
-            // Check another time for errors
-            int isLinked = 0;
-
-            glGetProgramiv(sh, GL_LINK_STATUS, &isLinked);
-
-            if(!isLinked) {
-                int maxLength = 0;
-
-                glGetProgramiv(sh, GL_INFO_LOG_LENGTH, &maxLength);
-
-                char* infoLog = (char*)malloc(maxLength);
-                glGetProgramInfoLog(sh, maxLength, &maxLength, &infoLog[0]);
+            // Swap in rebuilded program only when it linked
+            uint32_t rebuilt = SBRebuildPoll(&gRebuild);
 
-                printf("[INFO]: Link error: %s\n", infoLog);
+            if(rebuilt) {
+                glDeleteProgram(sh);
+                sh = rebuilt;
 
-                free(infoLog);
+                UNReflect(&gUniforms[0], sh);
+                UNPrint(&gUniforms[0]);
+                FDBindProgram(sh);
 
-                infoLog = nullptr;
+                reportLatency = reloadStart != 0.0;
+            }
+            else if(reloadStart != 0.0 && SBRebuildIsIdle(&gRebuild)) {
+                // Rebuild failed, nothing new will reach screen
+                reloadStart = 0.0;
             }
         }
-        else if(glfwGetKey(window, GLFW_KEY_R) == GLFW_RELEASE && gRefreshPressed) {
-            // Set flag
-            gRefreshPressed = false;
-        }
+
+        reloadMask = 0;
 
         // Calculate  delta time
         c = glfwGetTime();
         d = c - l;
         l = c;
 
-        // Set uniforms and draw
-        glUseProgram(sh);
-        glBindVertexArray(vao);
+        DrawScene(sh, c, d);
 
-        glUniform1f(glGetUniformLocation(sh, "uTime"), c);
-        glUniform1f(glGetUniformLocation(sh, "uDeltaTime"), d);
-        glUniformMatrix4fv(glGetUniformLocation(sh, "uProjection"), 1, 0, gProj.m);
-        // Here is mat4(1.0) becouse currently gView doesn`t work 
-        glUniformMatrix4fv(glGetUniformLocation(sh, "uView"), 1, 0, /*gView.m*/MX4One().m);
-        glUniformMatrix4fv(glGetUniformLocation(sh, "uTransform"), 1, 0, gTrans.m);
+        GTEndFrame(&gGpuTimer);
 
-        glDrawArrays(GL_TRIANGLES, 0, sizeof(gPlane10Vertices) / 3);
+        glfwSwapBuffers(window);
 
-        glBindVertexArray(0);
-        glUseProgram(0);
+        if(GTUpdate(&gGpuTimer, 1000.0)) {
+            char gpuTime[256];
+            char title[320];
 
-        glfwSwapBuffers(window);
+            GTFormat(&gGpuTimer, gpuTime, sizeof(gpuTime));
+            snprintf(title, sizeof(title), "GLSL Shader Designer | %s", gpuTime);
+
+            glfwSetWindowTitle(window, title);
+            printf("[INFO]: %s\n", gpuTime);
+            GTPrintStats(&gGpuTimer);
+            SCPrintStats(&gScene);
+            MLPrintStats(&gMeshlets);
+            HZPrintStats(&gHiZ);
+            MSPrintStats(&gLods);
+        }
+
+        if(reportLatency) {
+            printf("[INFO]: Save to pixels latency %.2f ms\n", UTGetTimeMs() - reloadStart);
+
+            reloadStart = 0.0;
+            reportLatency = false;
+        }
 
         glfwPollEvents();
 
@@ -509,6 +992,39 @@ int main(int argc, char **argv) {
         glfwSwapInterval(0);
     }
 
+    if(!gHeadlessMode) {
+        GTTerminate(&gGpuTimer);
+        FWTerminate(&gFileWatch);
+        SBRebuildTerminate(&gRebuild);
+    }
+
+    if(gSeparable) {
+        SPTerminate(&gPipeline);
+    }
+
+    uint64_t uploads = 0, skipped = 0;
+
+    for(uint32_t i = 0; i < STAGE_COUNT; i++) {
+        uploads += gUniforms[i].mUploads;
+        skipped += gUniforms[i].mSkipped;
+    }
+
+    printf("[INFO]: Uniforms: %llu uploads, %llu skipped (unchanged)\n", (unsigned long long)uploads, (unsigned long long)skipped);
+
+    FDTerminate(&gFrameRing);
+    SCTerminate(&gScene);
+    MLTerminate(&gMeshlets);
+    HZTerminate(&gHiZ);
+    INTerminate(&gInstances);
+    MRTerminate(&gMeshRegistry);
+
+    PPPrintStats(&gPreprocessor);
+    PPTerminate(&gPreprocessor);
+
+    if(gHeadlessMode) {
+        HLTerminate(&gHeadless);
+    }
+
     glfwTerminate();
 
     return 0;
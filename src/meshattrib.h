@@ -0,0 +1,615 @@
+#ifndef __MESH_ATTRIB_
+#define __MESH_ATTRIB_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include <glad/gl.h>
+
+#include "utils.h"
+#include "meshregistry.h"
+#include "meshindex.h"
+
+// Triangles or vertices per thread below which work isn`t split further
+#define MA_MIN_TRIANGLES 4096
+// Floats per generated vertex
+#define MA_VERTEX_FLOATS 12
+
+/**
+ * @brief How missing normals and UVs are generated
+ */
+enum MeshNormals {
+    MASmooth,
+    MAFlat
+};
+
+enum MeshUVs {
+    MAPlanar,
+    MASpherical
+};
+
+/**
+ * @brief Generated interleaved vertices of registry meshes, alive until MRUpload
+ *
+ * Every vertex is 48 bytes:
+ * layout(location = 0) in vec4 iPos;      // xyz
+ * layout(location = 1) in vec3 iNormal;
+ * layout(location = 2) in vec2 iUV;
+ * layout(location = 3) in vec4 iTangent;  // bitangent = iTangent.w * cross(iNormal, iTangent.xyz)
+ */
+typedef struct MeshAttributes_s {
+    IndexedMesh_t mMeshes[MR_MAX_MESHES];
+    uint32_t mCount;
+} MeshAttributes_t;
+
+/**
+ * @brief Parse "<smooth|flat>,<planar|spherical>", either part may be left out
+ *
+ * @param spec
+ * @param pNormals
+ * @param pUVs
+ * @return true
+ * @return false unknown word
+ */
+bool MAParse(const char* spec, int* pNormals, int* pUVs) {
+    char words[64];
+    snprintf(words, sizeof(words), "%s", spec);
+
+    *pNormals = MASmooth;
+    *pUVs = MAPlanar;
+
+    for(char* pWord = strtok(words, ","); pWord; pWord = strtok(nullptr, ",")) {
+        if(strcmp(pWord, "smooth") == 0 || strcmp(pWord, "flat") == 0) {
+            *pNormals = strcmp(pWord, "flat") == 0 ? MAFlat : MASmooth;
+        }
+        else if(strcmp(pWord, "planar") == 0 || strcmp(pWord, "spherical") == 0) {
+            *pUVs = strcmp(pWord, "spherical") == 0 ? MASpherical : MAPlanar;
+        }
+        else {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Mesh data shared by every pass, passes split triangles or vertices into ranges
+ */
+typedef struct __MAContext_s {
+    const float* pPositions;
+    // Source normals and UVs, nullptr when they are generated
+    const float* pNormals;
+    const float* pUVs;
+    const uint32_t* pIndices;
+    int mNormals;
+    int mUVs;
+    float mMin[3], mMax[3];
+
+    // Area weighted face normal of every triangle
+    float* pFaceNormals;
+    // Triangles around every welded position (CSR), smooth normal of every welded position
+    const uint32_t* pPositionIds;
+    const uint32_t* pPositionOffsets;
+    const uint32_t* pPositionTriangles;
+    float* pSmoothNormals;
+
+    // Corner vertices before weld and angle weighted tangent of every corner
+    float* pCorners;
+    float* pCornerTangents;
+
+    // Welded vertices and corners of every vertex (CSR)
+    float* pVertices;
+    const uint32_t* pVertexOffsets;
+    const uint32_t* pVertexCorners;
+} __MAContext_t;
+
+void __MASub(const float* a, const float* b, float* pOut) {
+    pOut[0] = a[0] - b[0];
+    pOut[1] = a[1] - b[1];
+    pOut[2] = a[2] - b[2];
+}
+
+void __MACross(const float* a, const float* b, float* pOut) {
+    pOut[0] = a[1] * b[2] - a[2] * b[1];
+    pOut[1] = a[2] * b[0] - a[0] * b[2];
+    pOut[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+float __MADot(const float* a, const float* b) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+bool __MANormalize(float* v) {
+    float length = sqrtf(__MADot(v, v));
+
+    if(length <= 1e-20f) {
+        return false;
+    }
+
+    v[0] /= length;
+    v[1] /= length;
+    v[2] /= length;
+
+    return true;
+}
+
+/**
+ * @brief Any unit vector perpendicular to normal, for tangents of triangles without UV area
+ */
+void __MAPerpendicular(const float* n, float* pOut) {
+    float axis[3] = {fabsf(n[0]) < 0.9f ? 1.0f : 0.0f, fabsf(n[0]) < 0.9f ? 0.0f : 1.0f, 0.0f};
+
+    __MACross(axis, n, pOut);
+    __MANormalize(pOut);
+}
+
+void __MAFaceNormals(uint32_t begin, uint32_t end, void* pData) {
+    __MAContext_t* pContext = (__MAContext_t*)pData;
+
+    for(uint32_t t = begin; t < end; t++) {
+        const uint32_t* pTriangle = &pContext->pIndices[(uint64_t)t * 3];
+        float e0[3], e1[3];
+
+        __MASub(&pContext->pPositions[(uint64_t)pTriangle[1] * 3], &pContext->pPositions[(uint64_t)pTriangle[0] * 3], e0);
+        __MASub(&pContext->pPositions[(uint64_t)pTriangle[2] * 3], &pContext->pPositions[(uint64_t)pTriangle[0] * 3], e1);
+        __MACross(e0, e1, &pContext->pFaceNormals[(uint64_t)t * 3]);
+    }
+}
+
+void __MASmoothNormals(uint32_t begin, uint32_t end, void* pData) {
+    __MAContext_t* pContext = (__MAContext_t*)pData;
+
+    for(uint32_t p = begin; p < end; p++) {
+        float* pNormal = &pContext->pSmoothNormals[(uint64_t)p * 3];
+
+        pNormal[0] = pNormal[1] = pNormal[2] = 0.0f;
+
+        for(uint32_t j = pContext->pPositionOffsets[p]; j < pContext->pPositionOffsets[p + 1]; j++) {
+            const float* pFace = &pContext->pFaceNormals[(uint64_t)pContext->pPositionTriangles[j] * 3];
+
+            pNormal[0] += pFace[0];
+            pNormal[1] += pFace[1];
+            pNormal[2] += pFace[2];
+        }
+
+        if(!__MANormalize(pNormal)) {
+            pNormal[1] = 1.0f;
+        }
+    }
+}
+
+/**
+ * @brief UV of position generated from mesh bounds
+ */
+void __MAGenerateUV(const __MAContext_t* pContext, const float* p, float* pOut) {
+    float extent[3], center[3];
+
+    for(uint32_t c = 0; c < 3; c++) {
+        extent[c] = pContext->mMax[c] - pContext->mMin[c];
+        center[c] = (pContext->mMin[c] + pContext->mMax[c]) * 0.5f;
+    }
+
+    if(pContext->mUVs == MASpherical) {
+        float d[3] = {p[0] - center[0], p[1] - center[1], p[2] - center[2]};
+        float length = sqrtf(__MADot(d, d));
+
+        pOut[0] = 0.5f + atan2f(d[2], d[0]) / 6.28318530718f;
+        pOut[1] = length > 0.0f ? 0.5f + asinf(fminf(fmaxf(d[1] / length, -1.0f), 1.0f)) / 3.14159265359f : 0.5f;
+
+        return;
+    }
+
+    // Planar UVs span two largest axes of bounds
+    uint32_t smallest = extent[0] <= extent[1] && extent[0] <= extent[2] ? 0 : (extent[1] <= extent[2] ? 1 : 2);
+    uint32_t u = smallest == 0 ? 1 : 0, v = smallest == 2 ? 1 : 2;
+
+    pOut[0] = extent[u] > 0.0f ? (p[u] - pContext->mMin[u]) / extent[u] : 0.0f;
+    pOut[1] = extent[v] > 0.0f ? (p[v] - pContext->mMin[v]) / extent[v] : 0.0f;
+}
+
+/**
+ * @brief Corner vertices of triangle range, tangent of corner is face tangent projected onto corner normal and weighted by corner angle (MikkTSpace)
+ */
+void __MACorners(uint32_t begin, uint32_t end, void* pData) {
+    __MAContext_t* pContext = (__MAContext_t*)pData;
+
+    for(uint32_t t = begin; t < end; t++) {
+        const uint32_t* pTriangle = &pContext->pIndices[(uint64_t)t * 3];
+        float* pCorner[3];
+        const float* p[3];
+
+        for(uint32_t k = 0; k < 3; k++) {
+            uint32_t vertex = pTriangle[k];
+
+            pCorner[k] = &pContext->pCorners[((uint64_t)t * 3 + k) * MA_VERTEX_FLOATS];
+            p[k] = &pContext->pPositions[(uint64_t)vertex * 3];
+
+            memcpy(pCorner[k], p[k], 3 * sizeof(float));
+
+            if(pContext->pNormals) {
+                memcpy(pCorner[k] + 3, &pContext->pNormals[(uint64_t)vertex * 3], 3 * sizeof(float));
+            }
+            else if(pContext->mNormals == MAFlat) {
+                memcpy(pCorner[k] + 3, &pContext->pFaceNormals[(uint64_t)t * 3], 3 * sizeof(float));
+
+                if(!__MANormalize(pCorner[k] + 3)) {
+                    pCorner[k][3] = pCorner[k][5] = 0.0f;
+                    pCorner[k][4] = 1.0f;
+                }
+            }
+            else {
+                memcpy(pCorner[k] + 3, &pContext->pSmoothNormals[(uint64_t)pContext->pPositionIds[vertex] * 3], 3 * sizeof(float));
+            }
+
+            if(pContext->pUVs) {
+                memcpy(pCorner[k] + 6, &pContext->pUVs[(uint64_t)vertex * 2], 2 * sizeof(float));
+            }
+            else {
+                __MAGenerateUV(pContext, p[k], pCorner[k] + 6);
+            }
+        }
+
+        // Spherical U wraps, triangle crossing seam gets U past 1 instead of spanning whole texture
+        if(!pContext->pUVs && pContext->mUVs == MASpherical) {
+            float low = fminf(fminf(pCorner[0][6], pCorner[1][6]), pCorner[2][6]);
+            float high = fmaxf(fmaxf(pCorner[0][6], pCorner[1][6]), pCorner[2][6]);
+
+            for(uint32_t k = 0; k < 3 && high - low > 0.5f; k++) {
+                pCorner[k][6] += pCorner[k][6] < 0.5f ? 1.0f : 0.0f;
+            }
+        }
+
+        // Face tangent and bitangent from UV gradients
+        float e0[3], e1[3], tangent[3], bitangent[3];
+        float du0 = pCorner[1][6] - pCorner[0][6], dv0 = pCorner[1][7] - pCorner[0][7];
+        float du1 = pCorner[2][6] - pCorner[0][6], dv1 = pCorner[2][7] - pCorner[0][7];
+        float area = du0 * dv1 - du1 * dv0;
+        float orientation = area < 0.0f ? -1.0f : 1.0f;
+
+        __MASub(p[1], p[0], e0);
+        __MASub(p[2], p[0], e1);
+
+        for(uint32_t c = 0; c < 3; c++) {
+            tangent[c] = (e0[c] * dv1 - e1[c] * dv0) * orientation;
+            bitangent[c] = (e1[c] * du0 - e0[c] * du1) * orientation;
+        }
+
+        for(uint32_t k = 0; k < 3; k++) {
+            const float* n = pCorner[k] + 3;
+            float* pTangent = &pContext->pCornerTangents[((uint64_t)t * 3 + k) * 3];
+            float projected[3], a[3], b[3];
+            float d = __MADot(n, tangent);
+
+            for(uint32_t c = 0; c < 3; c++) {
+                projected[c] = tangent[c] - n[c] * d;
+            }
+
+            if(fabsf(area) <= 1e-20f || !__MANormalize(projected)) {
+                __MAPerpendicular(n, projected);
+            }
+
+            // Corner angle weight, corners of degenerate triangle add nothing
+            __MASub(p[(k + 1) % 3], p[k], a);
+            __MASub(p[(k + 2) % 3], p[k], b);
+
+            float angle = __MANormalize(a) && __MANormalize(b) ? acosf(fminf(fmaxf(__MADot(a, b), -1.0f), 1.0f)) : 0.0f;
+
+            pTangent[0] = projected[0] * angle;
+            pTangent[1] = projected[1] * angle;
+            pTangent[2] = projected[2] * angle;
+
+            // Handedness is part of weld key, so mirrored UVs split vertices like MikkTSpace does
+            float cross[3];
+            __MACross(n, projected, cross);
+
+            pCorner[k][8] = pCorner[k][9] = pCorner[k][10] = 0.0f;
+            pCorner[k][11] = fabsf(area) > 1e-20f && __MADot(cross, bitangent) < 0.0f ? -1.0f : 1.0f;
+
+            // Weld compares bytes, negative zero would keep equal corners apart (bit test survives -Ofast)
+            for(uint32_t c = 0; c < MA_VERTEX_FLOATS; c++) {
+                uint32_t bits;
+                memcpy(&bits, &pCorner[k][c], sizeof(bits));
+
+                if((bits & 0x7FFFFFFF) == 0) {
+                    pCorner[k][c] = 0.0f;
+                }
+            }
+        }
+    }
+}
+
+void __MATangents(uint32_t begin, uint32_t end, void* pData) {
+    __MAContext_t* pContext = (__MAContext_t*)pData;
+
+    for(uint32_t v = begin; v < end; v++) {
+        float* pVertex = &pContext->pVertices[(uint64_t)v * MA_VERTEX_FLOATS];
+        const float* n = pVertex + 3;
+        float tangent[3] = {0.0f, 0.0f, 0.0f};
+
+        for(uint32_t j = pContext->pVertexOffsets[v]; j < pContext->pVertexOffsets[v + 1]; j++) {
+            const float* pCorner = &pContext->pCornerTangents[(uint64_t)pContext->pVertexCorners[j] * 3];
+
+            tangent[0] += pCorner[0];
+            tangent[1] += pCorner[1];
+            tangent[2] += pCorner[2];
+        }
+
+        // Gram-Schmidt against normal
+        float d = __MADot(n, tangent);
+
+        for(uint32_t c = 0; c < 3; c++) {
+            tangent[c] -= n[c] * d;
+        }
+
+        if(!__MANormalize(tangent)) {
+            __MAPerpendicular(n, tangent);
+        }
+
+        memcpy(pVertex + 8, tangent, sizeof(tangent));
+    }
+}
+
+/**
+ * @brief Build CSR list of items of every key
+ *
+ * @param pKeys key of every item
+ * @param count
+ * @param keyCount
+ * @param pOffsets output, keyCount + 1
+ * @param pItems output, count
+ */
+void __MAGroup(const uint32_t* pKeys, uint32_t count, uint32_t keyCount, uint32_t* pOffsets, uint32_t* pItems) {
+    memset(pOffsets, 0, ((uint64_t)keyCount + 1) * sizeof(uint32_t));
+
+    for(uint32_t i = 0; i < count; i++) {
+        pOffsets[pKeys[i] + 1]++;
+    }
+
+    for(uint32_t k = 0; k < keyCount; k++) {
+        pOffsets[k + 1] += pOffsets[k];
+    }
+
+    for(uint32_t i = 0; i < count; i++) {
+        pItems[pOffsets[pKeys[i]]++] = i;
+    }
+
+    // Fill moved every offset to start of next key
+    for(uint32_t k = keyCount; k > 0; k--) {
+        pOffsets[k] = pOffsets[k - 1];
+    }
+
+    pOffsets[0] = 0;
+}
+
+/**
+ * @brief Generate normals, UVs and tangents of triangle list into interleaved indexed mesh, normals and UVs mesh already has are kept
+ *
+ * Face normals, corners and tangents run in parallel over triangle ranges, vertices with equal position, normal, UV and handedness are welded and reordered for vertex cache
+ *
+ * @param pPositions packed float3, vertexCount of them
+ * @param vertexCount
+ * @param pIndices 32-bit triangle list
+ * @param indexCount
+ * @param pNormals optional source float3 normals
+ * @param pUVs optional source float2 UVs
+ * @param normals MeshNormals
+ * @param uvs MeshUVs
+ * @param pMin bounds of positions
+ * @param pMax
+ * @param pOut output, free with MIFree
+ * @return uint32_t threads used, 0 when out of memory
+ */
+uint32_t MAGenerate(const float* pPositions, uint32_t vertexCount, const uint32_t* pIndices, uint32_t indexCount, const float* pNormals, const float* pUVs, int normals, int uvs, const float* pMin, const float* pMax, IndexedMesh_t* pOut) {
+    memset(pOut, 0, sizeof(IndexedMesh_t));
+
+    uint32_t triangles = indexCount / 3;
+    uint32_t corners = triangles * 3;
+    uint32_t threads = 1, used = 1;
+
+    __MAContext_t context = {
+        .pPositions = pPositions,
+        .pNormals = pNormals,
+        .pUVs = pUVs,
+        .pIndices = pIndices,
+        .mNormals = normals,
+        .mUVs = uvs
+    };
+
+    memcpy(context.mMin, pMin, sizeof(context.mMin));
+    memcpy(context.mMax, pMax, sizeof(context.mMax));
+
+    float* pFaceNormals = (float*)malloc((uint64_t)(triangles ? triangles : 1) * 3 * sizeof(float));
+    uint32_t* pPositionIds = (uint32_t*)malloc((uint64_t)(vertexCount ? vertexCount : 1) * sizeof(uint32_t));
+    float* pUnique = (float*)malloc((uint64_t)(vertexCount ? vertexCount : 1) * 3 * sizeof(float));
+    uint32_t* pCornerPositions = (uint32_t*)malloc((uint64_t)(corners ? corners : 1) * sizeof(uint32_t));
+    uint32_t* pOffsets = (uint32_t*)malloc(((uint64_t)(vertexCount > corners ? vertexCount : corners) + 1) * sizeof(uint32_t));
+    uint32_t* pItems = (uint32_t*)malloc((uint64_t)(corners ? corners : 1) * sizeof(uint32_t));
+    float* pSmoothNormals = (float*)malloc((uint64_t)(vertexCount ? vertexCount : 1) * 3 * sizeof(float));
+    float* pCorners = (float*)malloc((uint64_t)(corners ? corners : 1) * MA_VERTEX_FLOATS * sizeof(float));
+    float* pCornerTangents = (float*)malloc((uint64_t)(corners ? corners : 1) * 3 * sizeof(float));
+    float* pVertices = (float*)malloc((uint64_t)(corners ? corners : 1) * MA_VERTEX_FLOATS * sizeof(float));
+    uint32_t* pCornerVertices = (uint32_t*)malloc((uint64_t)(corners ? corners : 1) * sizeof(uint32_t));
+
+    bool result = pFaceNormals && pPositionIds && pUnique && pCornerPositions && pOffsets && pItems && pSmoothNormals && pCorners && pCornerTangents && pVertices && pCornerVertices;
+
+    if(result) {
+        context.pFaceNormals = pFaceNormals;
+        threads = UTParallelFor(triangles, MA_MIN_TRIANGLES, __MAFaceNormals, &context);
+
+        // Smooth normals are shared by vertices at same position, so UV seams don`t show in shading
+        if(!pNormals && normals == MASmooth) {
+            uint32_t positions = MIWeld(pPositions, vertexCount, 3 * sizeof(float), pUnique, pPositionIds);
+
+            for(uint32_t i = 0; i < corners; i++) {
+                pCornerPositions[i] = pPositionIds[pIndices[i]];
+            }
+
+            __MAGroup(pCornerPositions, corners, positions, pOffsets, pItems);
+
+            // Corner to triangle in place, lists only need triangles
+            for(uint32_t i = 0; i < corners; i++) {
+                pItems[i] /= 3;
+            }
+
+            context.pPositionIds = pPositionIds;
+            context.pPositionOffsets = pOffsets;
+            context.pPositionTriangles = pItems;
+            context.pSmoothNormals = pSmoothNormals;
+
+            used = UTParallelFor(positions, MA_MIN_TRIANGLES, __MASmoothNormals, &context);
+            threads = used > threads ? used : threads;
+        }
+
+        context.pCorners = pCorners;
+        context.pCornerTangents = pCornerTangents;
+
+        used = UTParallelFor(triangles, MA_MIN_TRIANGLES, __MACorners, &context);
+        threads = used > threads ? used : threads;
+
+        uint32_t unique = MIWeld(pCorners, corners, MA_VERTEX_FLOATS * sizeof(float), pVertices, pCornerVertices);
+
+        __MAGroup(pCornerVertices, corners, unique, pOffsets, pItems);
+
+        context.pVertices = pVertices;
+        context.pVertexOffsets = pOffsets;
+        context.pVertexCorners = pItems;
+
+        used = UTParallelFor(unique, MA_MIN_TRIANGLES, __MATangents, &context);
+        threads = used > threads ? used : threads;
+
+        MeshDesc_t desc = {
+            .mPrimitive = GL_TRIANGLES,
+            .mStride = MA_VERTEX_FLOATS * sizeof(float),
+            .mAttributes = {
+                {.mLocation = 0, .mComponents = 3, .mType = GL_FLOAT, .mNormalized = false, .mOffset = 0},
+                {.mLocation = 1, .mComponents = 3, .mType = GL_FLOAT, .mNormalized = false, .mOffset = 3 * sizeof(float)},
+                {.mLocation = 2, .mComponents = 2, .mType = GL_FLOAT, .mNormalized = false, .mOffset = 6 * sizeof(float)},
+                {.mLocation = 3, .mComponents = 4, .mType = GL_FLOAT, .mNormalized = false, .mOffset = 8 * sizeof(float)}
+            },
+            .mAttributeCount = 4
+        };
+
+        void* pShrunk = realloc(pVertices, (uint64_t)(unique ? unique : 1) * MA_VERTEX_FLOATS * sizeof(float));
+
+        // Mesh takes vertices and indices
+        MIFinish(pOut, pShrunk ? pShrunk : pVertices, unique, pCornerVertices, corners, &desc, nullptr);
+        pVertices = nullptr;
+        pCornerVertices = nullptr;
+    }
+
+    free(pFaceNormals);
+    free(pPositionIds);
+    free(pUnique);
+    free(pCornerPositions);
+    free(pOffsets);
+    free(pItems);
+    free(pSmoothNormals);
+    free(pCorners);
+    free(pCornerTangents);
+    free(pVertices);
+    free(pCornerVertices);
+
+    return result ? threads : 0;
+}
+
+/**
+ * @brief Float attribute of mesh at location as packed array
+ *
+ * @return float* malloc`d, nullptr when mesh has no such float attribute
+ */
+float* __MAReadAttribute(const MeshEntry_t* pMesh, uint32_t location, uint32_t components) {
+    for(uint32_t i = 0; i < pMesh->mDesc.mAttributeCount; i++) {
+        const MeshAttribute_t* pAttribute = &pMesh->mDesc.mAttributes[i];
+
+        if(pAttribute->mLocation != location || pAttribute->mType != GL_FLOAT || pAttribute->mComponents != components) {
+            continue;
+        }
+
+        float* pOut = (float*)malloc((uint64_t)(pMesh->mDesc.mVertexCount ? pMesh->mDesc.mVertexCount : 1) * components * sizeof(float));
+
+        for(uint32_t v = 0; pOut && v < pMesh->mDesc.mVertexCount; v++) {
+            memcpy(&pOut[(uint64_t)v * components], (const uint8_t*)pMesh->pVertices + (uint64_t)v * pMesh->mDesc.mStride + pAttribute->mOffset, components * sizeof(float));
+        }
+
+        return pOut;
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief Replace every triangle mesh of registry by interleaved mesh with normals, UVs and tangents
+ *
+ * Call after all meshes are added and before MQQuantizeRegistry, MSBuildLods and MLBuild, generated meshes stay alive until MAReleaseVertices
+ *
+ * @param pAttributes
+ * @param pRegistry
+ * @param normals MeshNormals
+ * @param uvs MeshUVs
+ * @return true
+ * @return false nothing was generated
+ */
+bool MABuildRegistry(MeshAttributes_t* pAttributes, MeshRegistry_t* pRegistry, int normals, int uvs) {
+    memset(pAttributes, 0, sizeof(MeshAttributes_t));
+
+    for(uint32_t m = 0; m < pRegistry->mCount; m++) {
+        MeshEntry_t* pMesh = &pRegistry->mMeshes[m];
+
+        if(!pMesh->pVertices || pMesh->mDesc.mPrimitive != GL_TRIANGLES || pRegistry->mBuffer) {
+            continue;
+        }
+
+        double start = UTGetTimeMs();
+        uint32_t sourceVertices = pMesh->mDesc.mVertexCount;
+        uint32_t indexCount = pMesh->mDesc.mIndexType ? pMesh->mDesc.mIndexCount : pMesh->mDesc.mVertexCount;
+        uint32_t* pIndices = (uint32_t*)malloc((uint64_t)(indexCount ? indexCount : 1) * sizeof(uint32_t));
+        float* pPositions = MRDecodePositions(pMesh);
+        float* pNormals = __MAReadAttribute(pMesh, 1, 3);
+        float* pUVs = __MAReadAttribute(pMesh, 2, 2);
+        uint32_t threads = 0;
+
+        if(pIndices && pPositions) {
+            // Not indexed meshes are lists of consecutive vertices
+            for(uint32_t i = 0; i < indexCount; i++) {
+                pIndices[i] = pMesh->mDesc.mIndexType == GL_UNSIGNED_SHORT ? ((const uint16_t*)pMesh->pIndices)[i] : (pMesh->mDesc.mIndexType ? ((const uint32_t*)pMesh->pIndices)[i] : i);
+            }
+
+            threads = MAGenerate(pPositions, pMesh->mDesc.mVertexCount, pIndices, indexCount, pNormals, pUVs, normals, uvs, pMesh->mMin, pMesh->mMax, &pAttributes->mMeshes[m]);
+        }
+
+        IndexedMesh_t* pGenerated = &pAttributes->mMeshes[m];
+
+        if(threads && MRReplace(pRegistry, m, pGenerated->pVertices, pGenerated->pIndices, &pGenerated->mDesc)) {
+            printf("[INFO]: Attributes of %-16s %6u -> %6u vertices, %s normals, %s UVs, %.2f ms on %u threads\n", pMesh->mName, sourceVertices, pGenerated->mDesc.mVertexCount, pNormals ? "source" : (normals == MAFlat ? "flat" : "smooth"), pUVs ? "source" : (uvs == MASpherical ? "spherical" : "planar"), UTGetTimeMs() - start, threads);
+            pAttributes->mCount++;
+        }
+        else {
+            printf("[INFO]: Cannot generate attributes of <%s>\n", pMesh->mName);
+            MIFree(pGenerated);
+        }
+
+        free(pIndices);
+        free(pPositions);
+        free(pNormals);
+        free(pUVs);
+    }
+
+    return pAttributes->mCount > 0;
+}
+
+/**
+ * @brief Free generated meshes, call after MRUpload
+ *
+ * @param pAttributes
+ */
+void MAReleaseVertices(MeshAttributes_t* pAttributes) {
+    for(uint32_t m = 0; m < MR_MAX_MESHES; m++) {
+        MIFree(&pAttributes->mMeshes[m]);
+    }
+}
+
+#endif
@@ -0,0 +1,338 @@
+#ifndef __MESH_CACHE_
+#define __MESH_CACHE_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <glad/gl.h>
+
+#include "utils.h"
+#include "meshregistry.h"
+#include "meshindex.h"
+
+#define MC_MAGIC 0x434D5347u // "GSMC"
+#define MC_VERSION 1u
+// Streams start on this boundary so mapped pointers are aligned for any attribute type
+#define MC_ALIGNMENT 64
+// Source is hashed in blocks of this size in parallel, hash of file is hash of block hashes
+#define MC_HASH_BLOCK (1024 * 1024)
+// Directory + "/" + file name
+#define MC_PATH_LENGTH (1024 + 1 + 256)
+
+/**
+ * @brief Attribute as stored in file, fixed size fields so layout doesn`t depend on compiler
+ */
+typedef struct MeshCacheAttribute_s {
+    uint32_t mLocation;
+    uint32_t mComponents;
+    uint32_t mType;
+    uint32_t mNormalized;
+    uint32_t mOffset;
+} MeshCacheAttribute_t;
+
+/**
+ * @brief Byte range of stream inside cache file
+ */
+typedef struct MeshCacheStream_s {
+    uint64_t mOffset;
+    uint64_t mLength;
+} MeshCacheStream_t;
+
+/**
+ * @brief Header at start of cache file, followed by interleaved vertex stream and index stream
+ */
+typedef struct MeshCacheHeader_s {
+    uint32_t mMagic;
+    uint32_t mVersion;
+    uint64_t mSourceHash;
+    uint64_t mSourceLength;
+
+    uint32_t mPrimitive;
+    uint32_t mVertexCount;
+    uint32_t mStride;
+    uint32_t mAttributeCount;
+    MeshCacheAttribute_t mAttributes[MR_MAX_ATTRIBUTES];
+    uint32_t mIndexType;
+    uint32_t mIndexCount;
+
+    float mMin[3], mMax[3];
+
+    MeshCacheStream_t mVertices;
+    MeshCacheStream_t mIndices;
+} MeshCacheHeader_t;
+
+/**
+ * @brief Cache file mapped into memory, vertex and index pointers point straight into mapping
+ */
+typedef struct MeshCacheFile_s {
+    UTMappedFile_t mFile;
+    MeshDesc_t mDesc;
+    const void* pVertices;
+    const void* pIndices;
+    float mMin[3], mMax[3];
+
+    // Filled even when cache misses so it can be written without hashing source again
+    uint64_t mSourceHash;
+    uint64_t mSourceLength;
+} MeshCacheFile_t;
+
+typedef struct __MCHashContext_s {
+    const UTMappedFile_t* pFile;
+    uint64_t* pBlocks;
+} __MCHashContext_t;
+
+void __MCHashBlocks(uint32_t begin, uint32_t end, void* pData) {
+    __MCHashContext_t* pContext = (__MCHashContext_t*)pData;
+
+    for(uint32_t i = begin; i < end; i++) {
+        uint64_t offset = (uint64_t)i * MC_HASH_BLOCK;
+        uint64_t length = pContext->pFile->mLength - offset < MC_HASH_BLOCK ? pContext->pFile->mLength - offset : MC_HASH_BLOCK;
+
+        pContext->pBlocks[i] = UTHash(pContext->pFile->pData + offset, length, UT_HASH_SEED);
+    }
+}
+
+/**
+ * @brief Hash source file, blocks are hashed on all cores
+ *
+ * @param path
+ * @param pHash
+ * @param pLength
+ * @return true
+ * @return false file can`t be opened
+ */
+bool MCHashFile(const char* path, uint64_t* pHash, uint64_t* pLength) {
+    UTMappedFile_t file;
+
+    if(!UTMapFile(path, &file)) {
+        return false;
+    }
+
+    uint32_t blocks = (uint32_t)((file.mLength + MC_HASH_BLOCK - 1) / MC_HASH_BLOCK);
+    __MCHashContext_t context = {&file, (uint64_t*)malloc(blocks * sizeof(uint64_t))};
+
+    if(!context.pBlocks) {
+        UTUnmapFile(&file);
+
+        return false;
+    }
+
+    UTParallelFor(blocks, 4, __MCHashBlocks, &context);
+
+    *pHash = UTHash(context.pBlocks, blocks * sizeof(uint64_t), UT_HASH_SEED);
+    *pLength = file.mLength;
+
+    free(context.pBlocks);
+    UTUnmapFile(&file);
+
+    return true;
+}
+
+/**
+ * @brief Cache file of source, name is hash of source path
+ *
+ * @param directory
+ * @param source
+ * @param path output, MC_PATH_LENGTH bytes
+ */
+void __MCPath(const char* directory, const char* source, char* path) {
+    snprintf(path, MC_PATH_LENGTH, "%s/%016llx.mesh", directory, (unsigned long long)UTHashString(source, UT_HASH_SEED));
+}
+
+/**
+ * @brief Unmap cache, call after MRUpload copied it
+ *
+ * @param pCache
+ */
+void MCClose(MeshCacheFile_t* pCache) {
+    if(pCache->mFile.pData) {
+        UTUnmapFile(&pCache->mFile);
+    }
+
+    pCache->pVertices = nullptr;
+    pCache->pIndices = nullptr;
+}
+
+/**
+ * @brief Map cache of source file when it exists and source didn`t change since it was written
+ *
+ * @param directory
+ * @param source imported mesh file
+ * @param pCache output, close with MCClose, source hash is valid even when cache misses
+ * @return true cache hit, pCache->pVertices and pCache->pIndices can be added to registry
+ * @return false missing, stale or broken cache
+ */
+bool MCLoad(const char* directory, const char* source, MeshCacheFile_t* pCache) {
+    memset(pCache, 0, sizeof(MeshCacheFile_t));
+
+    double start = UTGetTimeMs();
+
+    if(!MCHashFile(source, &pCache->mSourceHash, &pCache->mSourceLength)) {
+        return false;
+    }
+
+    double hashMs = UTGetTimeMs() - start;
+
+    char path[MC_PATH_LENGTH];
+    __MCPath(directory, source, path);
+
+    if(!UTMapFile(path, &pCache->mFile)) {
+        return false;
+    }
+
+    const MeshCacheHeader_t* pHeader = (const MeshCacheHeader_t*)pCache->mFile.pData;
+    uint64_t length = pCache->mFile.mLength;
+    bool valid = length >= sizeof(MeshCacheHeader_t) && pHeader->mMagic == MC_MAGIC && pHeader->mVersion == MC_VERSION;
+
+    if(valid && (pHeader->mSourceHash != pCache->mSourceHash || pHeader->mSourceLength != pCache->mSourceLength)) {
+        printf("[INFO]: Mesh cache of <%s> is stale, importing again\n", source);
+        valid = false;
+    }
+
+    valid = valid && pHeader->mAttributeCount <= MR_MAX_ATTRIBUTES && pHeader->mStride > 0;
+    valid = valid && pHeader->mVertices.mOffset <= length && pHeader->mVertices.mLength <= length - pHeader->mVertices.mOffset && pHeader->mVertices.mLength == (uint64_t)pHeader->mVertexCount * pHeader->mStride;
+    valid = valid && (pHeader->mIndexType == 0 || MRIndexSize(pHeader->mIndexType)) && (pHeader->mIndexType == 0) == (pHeader->mIndexCount == 0);
+    valid = valid && pHeader->mIndices.mOffset <= length && pHeader->mIndices.mLength <= length - pHeader->mIndices.mOffset && pHeader->mIndices.mLength == (uint64_t)pHeader->mIndexCount * MRIndexSize(pHeader->mIndexType);
+
+    // Every attribute has to be known type and lie inside vertex
+    for(uint32_t i = 0; valid && i < pHeader->mAttributeCount; i++) {
+        const MeshCacheAttribute_t* pAttribute = &pHeader->mAttributes[i];
+        uint32_t size = MRTypeSize(pAttribute->mType);
+
+        valid = size && pAttribute->mComponents >= 1 && pAttribute->mComponents <= 4 && (uint64_t)pAttribute->mOffset + pAttribute->mComponents * size <= pHeader->mStride;
+    }
+
+    if(!valid) {
+        MCClose(pCache);
+
+        return false;
+    }
+
+    pCache->mDesc = (MeshDesc_t){
+        .mPrimitive = pHeader->mPrimitive,
+        .mVertexCount = pHeader->mVertexCount,
+        .mStride = pHeader->mStride,
+        .mAttributeCount = pHeader->mAttributeCount,
+        .mIndexType = pHeader->mIndexType,
+        .mIndexCount = pHeader->mIndexCount
+    };
+
+    for(uint32_t i = 0; i < pHeader->mAttributeCount; i++) {
+        const MeshCacheAttribute_t* pAttribute = &pHeader->mAttributes[i];
+
+        pCache->mDesc.mAttributes[i] = (MeshAttribute_t){
+            .mLocation = pAttribute->mLocation,
+            .mComponents = pAttribute->mComponents,
+            .mType = pAttribute->mType,
+            .mNormalized = pAttribute->mNormalized != 0,
+            .mOffset = pAttribute->mOffset
+        };
+    }
+
+    memcpy(pCache->mMin, pHeader->mMin, sizeof(pCache->mMin));
+    memcpy(pCache->mMax, pHeader->mMax, sizeof(pCache->mMax));
+
+    pCache->pVertices = pCache->mFile.pData + pHeader->mVertices.mOffset;
+    pCache->pIndices = pHeader->mIndexCount ? pCache->mFile.pData + pHeader->mIndices.mOffset : nullptr;
+
+    printf("[INFO]: Mesh cache hit <%s>: %u vertices, %u triangles, %.1f KiB mapped in %.2f ms (source hash %.2f ms)\n", source, pHeader->mVertexCount, pHeader->mIndexCount / 3, length / 1024.0, UTGetTimeMs() - start, hashMs);
+
+    return true;
+}
+
+/**
+ * @brief Write imported mesh so next run can map it instead of parsing source, file is written under temporary name and renamed
+ *
+ * @param directory
+ * @param source imported mesh file
+ * @param sourceHash from MCLoad
+ * @param sourceLength from MCLoad
+ * @param pMesh
+ * @return true
+ * @return false
+ */
+bool MCWrite(const char* directory, const char* source, uint64_t sourceHash, uint64_t sourceLength, const IndexedMesh_t* pMesh) {
+    // Without length of source there is nothing to validate cache against later
+    if(sourceLength == 0) {
+        printf("[INFO]: Mesh cache not written <%s>: source <%s> was not read\n", directory, source);
+
+        return false;
+    }
+
+    if(!UTMakeDirectory(directory)) {
+        printf("[INFO]: Cannot create mesh cache directory <%s>\n", directory);
+
+        return false;
+    }
+
+    const MeshDesc_t* pDesc = &pMesh->mDesc;
+    MeshCacheHeader_t header = {
+        .mMagic = MC_MAGIC,
+        .mVersion = MC_VERSION,
+        .mSourceHash = sourceHash,
+        .mSourceLength = sourceLength,
+        .mPrimitive = pDesc->mPrimitive,
+        .mVertexCount = pDesc->mVertexCount,
+        .mStride = pDesc->mStride,
+        .mAttributeCount = pDesc->mAttributeCount,
+        .mIndexType = pDesc->mIndexType,
+        .mIndexCount = pDesc->mIndexType ? pDesc->mIndexCount : 0
+    };
+
+    for(uint32_t i = 0; i < pDesc->mAttributeCount; i++) {
+        const MeshAttribute_t* pAttribute = &pDesc->mAttributes[i];
+
+        header.mAttributes[i] = (MeshCacheAttribute_t){pAttribute->mLocation, pAttribute->mComponents, pAttribute->mType, pAttribute->mNormalized, pAttribute->mOffset};
+    }
+
+    MRBounds(pMesh->pVertices, pDesc, header.mMin, header.mMax);
+
+    header.mVertices.mOffset = (sizeof(MeshCacheHeader_t) + MC_ALIGNMENT - 1) / MC_ALIGNMENT * MC_ALIGNMENT;
+    header.mVertices.mLength = (uint64_t)pDesc->mVertexCount * pDesc->mStride;
+    header.mIndices.mOffset = (header.mVertices.mOffset + header.mVertices.mLength + MC_ALIGNMENT - 1) / MC_ALIGNMENT * MC_ALIGNMENT;
+    header.mIndices.mLength = (uint64_t)header.mIndexCount * MRIndexSize(header.mIndexType);
+
+    char path[MC_PATH_LENGTH], temporary[MC_PATH_LENGTH + 4];
+    __MCPath(directory, source, path);
+    snprintf(temporary, sizeof(temporary), "%s.tmp", path);
+
+    FILE* pFile = fopen(temporary, "wb");
+
+    if(!pFile) {
+        printf("[INFO]: Cannot write mesh cache <%s>\n", path);
+
+        return false;
+    }
+
+    const uint8_t padding[MC_ALIGNMENT] = {0};
+    uint64_t vertexPadding = header.mVertices.mOffset - sizeof(MeshCacheHeader_t);
+    uint64_t indexPadding = header.mIndices.mOffset - header.mVertices.mOffset - header.mVertices.mLength;
+
+    bool written = fwrite(&header, sizeof(header), 1, pFile) == 1;
+    written = written && fwrite(padding, 1, vertexPadding, pFile) == vertexPadding;
+    written = written && fwrite(pMesh->pVertices, 1, header.mVertices.mLength, pFile) == header.mVertices.mLength;
+    written = written && fwrite(padding, 1, indexPadding, pFile) == indexPadding;
+    written = written && (header.mIndices.mLength == 0 || fwrite(pMesh->pIndices, 1, header.mIndices.mLength, pFile) == header.mIndices.mLength);
+    written = fclose(pFile) == 0 && written;
+
+#ifdef _WIN32
+    // Windows rename doesn`t replace existing file
+    remove(path);
+#endif
+
+    // Rename replaces old cache at once so reader never maps half written file
+    if(!written || rename(temporary, path) != 0) {
+        remove(temporary);
+        printf("[INFO]: Cannot write mesh cache <%s>\n", path);
+
+        return false;
+    }
+
+    printf("[INFO]: Mesh cache written <%s>, %.1f KiB\n", path, (header.mIndices.mOffset + header.mIndices.mLength) / 1024.0);
+
+    return true;
+}
+
+#endif
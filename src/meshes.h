@@ -1,631 +1,12 @@
 #ifndef __MESHES_
 #define __MESHES_
 
+// Plane and Plane10 are generated grids (grid:1x1 and grid:10x10), Custom is shape given by --shape generator string or mesh file
 enum Shape {
     Plane,
     Plane10,
-    Cube
-};
-
-float gPlaneVertices[] = {
-    1.0f, 0.0f, 1.0f,
-    -1.0f, 0.0f, 1.0f,
-    1.0f, 0.0f, -1.0f,
-    -1.0f, 0.0f, 1.0f,
-    1.0f, 0.0f, -1.0f,
-    -1.0f, 0.0f, -1.0f
-};
-
-float gPlane10Vertices[] = {
-    -0.8f, 0.0f, -0.8f,
-    -1.0f, 0.0f, -0.8f,
-    -0.8f, 0.0f, -1.0f,
-    -1.0f, 0.0f, -0.8f,
-    -0.8f, 0.0f, -1.0f,
-    -1.0f, 0.0f, -1.0f,
-    -0.6f, 0.0f, -0.8f,
-    -0.8f, 0.0f, -0.8f,
-    -0.6f, 0.0f, -1.0f,
-    -0.8f, 0.0f, -0.8f,
-    -0.6f, 0.0f, -1.0f,
-    -0.8f, 0.0f, -1.0f,
-    -0.4f, 0.0f, -0.8f,
-    -0.6f, 0.0f, -0.8f,
-    -0.4f, 0.0f, -1.0f,
-    -0.6f, 0.0f, -0.8f,
-    -0.4f, 0.0f, -1.0f,
-    -0.6f, 0.0f, -1.0f,
-    -0.2f, 0.0f, -0.8f,
-    -0.4f, 0.0f, -0.8f,
-    -0.2f, 0.0f, -1.0f,
-    -0.4f, 0.0f, -0.8f,
-    -0.2f, 0.0f, -1.0f,
-    -0.4f, 0.0f, -1.0f,
-     0.0f, 0.0f, -0.8f,
-    -0.2f, 0.0f, -0.8f,
-     0.0f, 0.0f, -1.0f,
-    -0.2f, 0.0f, -0.8f,
-     0.0f, 0.0f, -1.0f,
-    -0.2f, 0.0f, -1.0f,
-     0.2f, 0.0f, -0.8f,
-     0.0f, 0.0f, -0.8f,
-     0.2f, 0.0f, -1.0f,
-     0.0f, 0.0f, -0.8f,
-     0.2f, 0.0f, -1.0f,
-     0.0f, 0.0f, -1.0f,
-     0.4f, 0.0f, -0.8f,
-     0.2f, 0.0f, -0.8f,
-     0.4f, 0.0f, -1.0f,
-     0.2f, 0.0f, -0.8f,
-     0.4f, 0.0f, -1.0f,
-     0.2f, 0.0f, -1.0f,
-     0.6f, 0.0f, -0.8f,
-     0.4f, 0.0f, -0.8f,
-     0.6f, 0.0f, -1.0f,
-     0.4f, 0.0f, -0.8f,
-     0.6f, 0.0f, -1.0f,
-     0.4f, 0.0f, -1.0f,
-     0.8f, 0.0f, -0.8f,
-     0.6f, 0.0f, -0.8f,
-     0.8f, 0.0f, -1.0f,
-     0.6f, 0.0f, -0.8f,
-     0.8f, 0.0f, -1.0f,
-     0.6f, 0.0f, -1.0f,
-     1.0f, 0.0f, -0.8f,
-     0.8f, 0.0f, -0.8f,
-     1.0f, 0.0f, -1.0f,
-     0.8f, 0.0f, -0.8f,
-     1.0f, 0.0f, -1.0f,
-     0.8f, 0.0f, -1.0f,
-
-    -0.8f, 0.0f, -0.8f + 0.2f,
-    -1.0f, 0.0f, -0.8f + 0.2f,
-    -0.8f, 0.0f, -1.0f + 0.2f,
-    -1.0f, 0.0f, -0.8f + 0.2f,
-    -0.8f, 0.0f, -1.0f + 0.2f,
-    -1.0f, 0.0f, -1.0f + 0.2f,
-    -0.6f, 0.0f, -0.8f + 0.2f,
-    -0.8f, 0.0f, -0.8f + 0.2f,
-    -0.6f, 0.0f, -1.0f + 0.2f,
-    -0.8f, 0.0f, -0.8f + 0.2f,
-    -0.6f, 0.0f, -1.0f + 0.2f,
-    -0.8f, 0.0f, -1.0f + 0.2f,
-    -0.4f, 0.0f, -0.8f + 0.2f,
-    -0.6f, 0.0f, -0.8f + 0.2f,
-    -0.4f, 0.0f, -1.0f + 0.2f,
-    -0.6f, 0.0f, -0.8f + 0.2f,
-    -0.4f, 0.0f, -1.0f + 0.2f,
-    -0.6f, 0.0f, -1.0f + 0.2f,
-    -0.2f, 0.0f, -0.8f + 0.2f,
-    -0.4f, 0.0f, -0.8f + 0.2f,
-    -0.2f, 0.0f, -1.0f + 0.2f,
-    -0.4f, 0.0f, -0.8f + 0.2f,
-    -0.2f, 0.0f, -1.0f + 0.2f,
-    -0.4f, 0.0f, -1.0f + 0.2f,
-     0.0f, 0.0f, -0.8f + 0.2f,
-    -0.2f, 0.0f, -0.8f + 0.2f,
-     0.0f, 0.0f, -1.0f + 0.2f,
-    -0.2f, 0.0f, -0.8f + 0.2f,
-     0.0f, 0.0f, -1.0f + 0.2f,
-    -0.2f, 0.0f, -1.0f + 0.2f,
-     0.2f, 0.0f, -0.8f + 0.2f,
-     0.0f, 0.0f, -0.8f + 0.2f,
-     0.2f, 0.0f, -1.0f + 0.2f,
-     0.0f, 0.0f, -0.8f + 0.2f,
-     0.2f, 0.0f, -1.0f + 0.2f,
-     0.0f, 0.0f, -1.0f + 0.2f,
-     0.4f, 0.0f, -0.8f + 0.2f,
-     0.2f, 0.0f, -0.8f + 0.2f,
-     0.4f, 0.0f, -1.0f + 0.2f,
-     0.2f, 0.0f, -0.8f + 0.2f,
-     0.4f, 0.0f, -1.0f + 0.2f,
-     0.2f, 0.0f, -1.0f + 0.2f,
-     0.6f, 0.0f, -0.8f + 0.2f,
-     0.4f, 0.0f, -0.8f + 0.2f,
-     0.6f, 0.0f, -1.0f + 0.2f,
-     0.4f, 0.0f, -0.8f + 0.2f,
-     0.6f, 0.0f, -1.0f + 0.2f,
-     0.4f, 0.0f, -1.0f + 0.2f,
-     0.8f, 0.0f, -0.8f + 0.2f,
-     0.6f, 0.0f, -0.8f + 0.2f,
-     0.8f, 0.0f, -1.0f + 0.2f,
-     0.6f, 0.0f, -0.8f + 0.2f,
-     0.8f, 0.0f, -1.0f + 0.2f,
-     0.6f, 0.0f, -1.0f + 0.2f,
-     1.0f, 0.0f, -0.8f + 0.2f,
-     0.8f, 0.0f, -0.8f + 0.2f,
-     1.0f, 0.0f, -1.0f + 0.2f,
-     0.8f, 0.0f, -0.8f + 0.2f,
-     1.0f, 0.0f, -1.0f + 0.2f,
-     0.8f, 0.0f, -1.0f + 0.2f,
-
-    -0.8f, 0.0f, -0.8f + 0.4f,
-    -1.0f, 0.0f, -0.8f + 0.4f,
-    -0.8f, 0.0f, -1.0f + 0.4f,
-    -1.0f, 0.0f, -0.8f + 0.4f,
-    -0.8f, 0.0f, -1.0f + 0.4f,
-    -1.0f, 0.0f, -1.0f + 0.4f,
-    -0.6f, 0.0f, -0.8f + 0.4f,
-    -0.8f, 0.0f, -0.8f + 0.4f,
-    -0.6f, 0.0f, -1.0f + 0.4f,
-    -0.8f, 0.0f, -0.8f + 0.4f,
-    -0.6f, 0.0f, -1.0f + 0.4f,
-    -0.8f, 0.0f, -1.0f + 0.4f,
-    -0.4f, 0.0f, -0.8f + 0.4f,
-    -0.6f, 0.0f, -0.8f + 0.4f,
-    -0.4f, 0.0f, -1.0f + 0.4f,
-    -0.6f, 0.0f, -0.8f + 0.4f,
-    -0.4f, 0.0f, -1.0f + 0.4f,
-    -0.6f, 0.0f, -1.0f + 0.4f,
-    -0.2f, 0.0f, -0.8f + 0.4f,
-    -0.4f, 0.0f, -0.8f + 0.4f,
-    -0.2f, 0.0f, -1.0f + 0.4f,
-    -0.4f, 0.0f, -0.8f + 0.4f,
-    -0.2f, 0.0f, -1.0f + 0.4f,
-    -0.4f, 0.0f, -1.0f + 0.4f,
-     0.0f, 0.0f, -0.8f + 0.4f,
-    -0.2f, 0.0f, -0.8f + 0.4f,
-     0.0f, 0.0f, -1.0f + 0.4f,
-    -0.2f, 0.0f, -0.8f + 0.4f,
-     0.0f, 0.0f, -1.0f + 0.4f,
-    -0.2f, 0.0f, -1.0f + 0.4f,
-     0.2f, 0.0f, -0.8f + 0.4f,
-     0.0f, 0.0f, -0.8f + 0.4f,
-     0.2f, 0.0f, -1.0f + 0.4f,
-     0.0f, 0.0f, -0.8f + 0.4f,
-     0.2f, 0.0f, -1.0f + 0.4f,
-     0.0f, 0.0f, -1.0f + 0.4f,
-     0.4f, 0.0f, -0.8f + 0.4f,
-     0.2f, 0.0f, -0.8f + 0.4f,
-     0.4f, 0.0f, -1.0f + 0.4f,
-     0.2f, 0.0f, -0.8f + 0.4f,
-     0.4f, 0.0f, -1.0f + 0.4f,
-     0.2f, 0.0f, -1.0f + 0.4f,
-     0.6f, 0.0f, -0.8f + 0.4f,
-     0.4f, 0.0f, -0.8f + 0.4f,
-     0.6f, 0.0f, -1.0f + 0.4f,
-     0.4f, 0.0f, -0.8f + 0.4f,
-     0.6f, 0.0f, -1.0f + 0.4f,
-     0.4f, 0.0f, -1.0f + 0.4f,
-     0.8f, 0.0f, -0.8f + 0.4f,
-     0.6f, 0.0f, -0.8f + 0.4f,
-     0.8f, 0.0f, -1.0f + 0.4f,
-     0.6f, 0.0f, -0.8f + 0.4f,
-     0.8f, 0.0f, -1.0f + 0.4f,
-     0.6f, 0.0f, -1.0f + 0.4f,
-     1.0f, 0.0f, -0.8f + 0.4f,
-     0.8f, 0.0f, -0.8f + 0.4f,
-     1.0f, 0.0f, -1.0f + 0.4f,
-     0.8f, 0.0f, -0.8f + 0.4f,
-     1.0f, 0.0f, -1.0f + 0.4f,
-     0.8f, 0.0f, -1.0f + 0.4f,
-
-    -0.8f, 0.0f, -0.8f + 0.6f,
-    -1.0f, 0.0f, -0.8f + 0.6f,
-    -0.8f, 0.0f, -1.0f + 0.6f,
-    -1.0f, 0.0f, -0.8f + 0.6f,
-    -0.8f, 0.0f, -1.0f + 0.6f,
-    -1.0f, 0.0f, -1.0f + 0.6f,
-    -0.6f, 0.0f, -0.8f + 0.6f,
-    -0.8f, 0.0f, -0.8f + 0.6f,
-    -0.6f, 0.0f, -1.0f + 0.6f,
-    -0.8f, 0.0f, -0.8f + 0.6f,
-    -0.6f, 0.0f, -1.0f + 0.6f,
-    -0.8f, 0.0f, -1.0f + 0.6f,
-    -0.4f, 0.0f, -0.8f + 0.6f,
-    -0.6f, 0.0f, -0.8f + 0.6f,
-    -0.4f, 0.0f, -1.0f + 0.6f,
-    -0.6f, 0.0f, -0.8f + 0.6f,
-    -0.4f, 0.0f, -1.0f + 0.6f,
-    -0.6f, 0.0f, -1.0f + 0.6f,
-    -0.2f, 0.0f, -0.8f + 0.6f,
-    -0.4f, 0.0f, -0.8f + 0.6f,
-    -0.2f, 0.0f, -1.0f + 0.6f,
-    -0.4f, 0.0f, -0.8f + 0.6f,
-    -0.2f, 0.0f, -1.0f + 0.6f,
-    -0.4f, 0.0f, -1.0f + 0.6f,
-     0.0f, 0.0f, -0.8f + 0.6f,
-    -0.2f, 0.0f, -0.8f + 0.6f,
-     0.0f, 0.0f, -1.0f + 0.6f,
-    -0.2f, 0.0f, -0.8f + 0.6f,
-     0.0f, 0.0f, -1.0f + 0.6f,
-    -0.2f, 0.0f, -1.0f + 0.6f,
-     0.2f, 0.0f, -0.8f + 0.6f,
-     0.0f, 0.0f, -0.8f + 0.6f,
-     0.2f, 0.0f, -1.0f + 0.6f,
-     0.0f, 0.0f, -0.8f + 0.6f,
-     0.2f, 0.0f, -1.0f + 0.6f,
-     0.0f, 0.0f, -1.0f + 0.6f,
-     0.4f, 0.0f, -0.8f + 0.6f,
-     0.2f, 0.0f, -0.8f + 0.6f,
-     0.4f, 0.0f, -1.0f + 0.6f,
-     0.2f, 0.0f, -0.8f + 0.6f,
-     0.4f, 0.0f, -1.0f + 0.6f,
-     0.2f, 0.0f, -1.0f + 0.6f,
-     0.6f, 0.0f, -0.8f + 0.6f,
-     0.4f, 0.0f, -0.8f + 0.6f,
-     0.6f, 0.0f, -1.0f + 0.6f,
-     0.4f, 0.0f, -0.8f + 0.6f,
-     0.6f, 0.0f, -1.0f + 0.6f,
-     0.4f, 0.0f, -1.0f + 0.6f,
-     0.8f, 0.0f, -0.8f + 0.6f,
-     0.6f, 0.0f, -0.8f + 0.6f,
-     0.8f, 0.0f, -1.0f + 0.6f,
-     0.6f, 0.0f, -0.8f + 0.6f,
-     0.8f, 0.0f, -1.0f + 0.6f,
-     0.6f, 0.0f, -1.0f + 0.6f,
-     1.0f, 0.0f, -0.8f + 0.6f,
-     0.8f, 0.0f, -0.8f + 0.6f,
-     1.0f, 0.0f, -1.0f + 0.6f,
-     0.8f, 0.0f, -0.8f + 0.6f,
-     1.0f, 0.0f, -1.0f + 0.6f,
-     0.8f, 0.0f, -1.0f + 0.6f,
-
-    -0.8f, 0.0f, -0.8f + 0.8f,
-    -1.0f, 0.0f, -0.8f + 0.8f,
-    -0.8f, 0.0f, -1.0f + 0.8f,
-    -1.0f, 0.0f, -0.8f + 0.8f,
-    -0.8f, 0.0f, -1.0f + 0.8f,
-    -1.0f, 0.0f, -1.0f + 0.8f,
-    -0.6f, 0.0f, -0.8f + 0.8f,
-    -0.8f, 0.0f, -0.8f + 0.8f,
-    -0.6f, 0.0f, -1.0f + 0.8f,
-    -0.8f, 0.0f, -0.8f + 0.8f,
-    -0.6f, 0.0f, -1.0f + 0.8f,
-    -0.8f, 0.0f, -1.0f + 0.8f,
-    -0.4f, 0.0f, -0.8f + 0.8f,
-    -0.6f, 0.0f, -0.8f + 0.8f,
-    -0.4f, 0.0f, -1.0f + 0.8f,
-    -0.6f, 0.0f, -0.8f + 0.8f,
-    -0.4f, 0.0f, -1.0f + 0.8f,
-    -0.6f, 0.0f, -1.0f + 0.8f,
-    -0.2f, 0.0f, -0.8f + 0.8f,
-    -0.4f, 0.0f, -0.8f + 0.8f,
-    -0.2f, 0.0f, -1.0f + 0.8f,
-    -0.4f, 0.0f, -0.8f + 0.8f,
-    -0.2f, 0.0f, -1.0f + 0.8f,
-    -0.4f, 0.0f, -1.0f + 0.8f,
-     0.0f, 0.0f, -0.8f + 0.8f,
-    -0.2f, 0.0f, -0.8f + 0.8f,
-     0.0f, 0.0f, -1.0f + 0.8f,
-    -0.2f, 0.0f, -0.8f + 0.8f,
-     0.0f, 0.0f, -1.0f + 0.8f,
-    -0.2f, 0.0f, -1.0f + 0.8f,
-     0.2f, 0.0f, -0.8f + 0.8f,
-     0.0f, 0.0f, -0.8f + 0.8f,
-     0.2f, 0.0f, -1.0f + 0.8f,
-     0.0f, 0.0f, -0.8f + 0.8f,
-     0.2f, 0.0f, -1.0f + 0.8f,
-     0.0f, 0.0f, -1.0f + 0.8f,
-     0.4f, 0.0f, -0.8f + 0.8f,
-     0.2f, 0.0f, -0.8f + 0.8f,
-     0.4f, 0.0f, -1.0f + 0.8f,
-     0.2f, 0.0f, -0.8f + 0.8f,
-     0.4f, 0.0f, -1.0f + 0.8f,
-     0.2f, 0.0f, -1.0f + 0.8f,
-     0.6f, 0.0f, -0.8f + 0.8f,
-     0.4f, 0.0f, -0.8f + 0.8f,
-     0.6f, 0.0f, -1.0f + 0.8f,
-     0.4f, 0.0f, -0.8f + 0.8f,
-     0.6f, 0.0f, -1.0f + 0.8f,
-     0.4f, 0.0f, -1.0f + 0.8f,
-     0.8f, 0.0f, -0.8f + 0.8f,
-     0.6f, 0.0f, -0.8f + 0.8f,
-     0.8f, 0.0f, -1.0f + 0.8f,
-     0.6f, 0.0f, -0.8f + 0.8f,
-     0.8f, 0.0f, -1.0f + 0.8f,
-     0.6f, 0.0f, -1.0f + 0.8f,
-     1.0f, 0.0f, -0.8f + 0.8f,
-     0.8f, 0.0f, -0.8f + 0.8f,
-     1.0f, 0.0f, -1.0f + 0.8f,
-     0.8f, 0.0f, -0.8f + 0.8f,
-     1.0f, 0.0f, -1.0f + 0.8f,
-     0.8f, 0.0f, -1.0f + 0.8f,
-
-    -0.8f, 0.0f, -0.8f + 1.0f,
-    -1.0f, 0.0f, -0.8f + 1.0f,
-    -0.8f, 0.0f, -1.0f + 1.0f,
-    -1.0f, 0.0f, -0.8f + 1.0f,
-    -0.8f, 0.0f, -1.0f + 1.0f,
-    -1.0f, 0.0f, -1.0f + 1.0f,
-    -0.6f, 0.0f, -0.8f + 1.0f,
-    -0.8f, 0.0f, -0.8f + 1.0f,
-    -0.6f, 0.0f, -1.0f + 1.0f,
-    -0.8f, 0.0f, -0.8f + 1.0f,
-    -0.6f, 0.0f, -1.0f + 1.0f,
-    -0.8f, 0.0f, -1.0f + 1.0f,
-    -0.4f, 0.0f, -0.8f + 1.0f,
-    -0.6f, 0.0f, -0.8f + 1.0f,
-    -0.4f, 0.0f, -1.0f + 1.0f,
-    -0.6f, 0.0f, -0.8f + 1.0f,
-    -0.4f, 0.0f, -1.0f + 1.0f,
-    -0.6f, 0.0f, -1.0f + 1.0f,
-    -0.2f, 0.0f, -0.8f + 1.0f,
-    -0.4f, 0.0f, -0.8f + 1.0f,
-    -0.2f, 0.0f, -1.0f + 1.0f,
-    -0.4f, 0.0f, -0.8f + 1.0f,
-    -0.2f, 0.0f, -1.0f + 1.0f,
-    -0.4f, 0.0f, -1.0f + 1.0f,
-     0.0f, 0.0f, -0.8f + 1.0f,
-    -0.2f, 0.0f, -0.8f + 1.0f,
-     0.0f, 0.0f, -1.0f + 1.0f,
-    -0.2f, 0.0f, -0.8f + 1.0f,
-     0.0f, 0.0f, -1.0f + 1.0f,
-    -0.2f, 0.0f, -1.0f + 1.0f,
-     0.2f, 0.0f, -0.8f + 1.0f,
-     0.0f, 0.0f, -0.8f + 1.0f,
-     0.2f, 0.0f, -1.0f + 1.0f,
-     0.0f, 0.0f, -0.8f + 1.0f,
-     0.2f, 0.0f, -1.0f + 1.0f,
-     0.0f, 0.0f, -1.0f + 1.0f,
-     0.4f, 0.0f, -0.8f + 1.0f,
-     0.2f, 0.0f, -0.8f + 1.0f,
-     0.4f, 0.0f, -1.0f + 1.0f,
-     0.2f, 0.0f, -0.8f + 1.0f,
-     0.4f, 0.0f, -1.0f + 1.0f,
-     0.2f, 0.0f, -1.0f + 1.0f,
-     0.6f, 0.0f, -0.8f + 1.0f,
-     0.4f, 0.0f, -0.8f + 1.0f,
-     0.6f, 0.0f, -1.0f + 1.0f,
-     0.4f, 0.0f, -0.8f + 1.0f,
-     0.6f, 0.0f, -1.0f + 1.0f,
-     0.4f, 0.0f, -1.0f + 1.0f,
-     0.8f, 0.0f, -0.8f + 1.0f,
-     0.6f, 0.0f, -0.8f + 1.0f,
-     0.8f, 0.0f, -1.0f + 1.0f,
-     0.6f, 0.0f, -0.8f + 1.0f,
-     0.8f, 0.0f, -1.0f + 1.0f,
-     0.6f, 0.0f, -1.0f + 1.0f,
-     1.0f, 0.0f, -0.8f + 1.0f,
-     0.8f, 0.0f, -0.8f + 1.0f,
-     1.0f, 0.0f, -1.0f + 1.0f,
-     0.8f, 0.0f, -0.8f + 1.0f,
-     1.0f, 0.0f, -1.0f + 1.0f,
-     0.8f, 0.0f, -1.0f + 1.0f,
-
-    -0.8f, 0.0f, -0.8f + 1.2f,
-    -1.0f, 0.0f, -0.8f + 1.2f,
-    -0.8f, 0.0f, -1.0f + 1.2f,
-    -1.0f, 0.0f, -0.8f + 1.2f,
-    -0.8f, 0.0f, -1.0f + 1.2f,
-    -1.0f, 0.0f, -1.0f + 1.2f,
-    -0.6f, 0.0f, -0.8f + 1.2f,
-    -0.8f, 0.0f, -0.8f + 1.2f,
-    -0.6f, 0.0f, -1.0f + 1.2f,
-    -0.8f, 0.0f, -0.8f + 1.2f,
-    -0.6f, 0.0f, -1.0f + 1.2f,
-    -0.8f, 0.0f, -1.0f + 1.2f,
-    -0.4f, 0.0f, -0.8f + 1.2f,
-    -0.6f, 0.0f, -0.8f + 1.2f,
-    -0.4f, 0.0f, -1.0f + 1.2f,
-    -0.6f, 0.0f, -0.8f + 1.2f,
-    -0.4f, 0.0f, -1.0f + 1.2f,
-    -0.6f, 0.0f, -1.0f + 1.2f,
-    -0.2f, 0.0f, -0.8f + 1.2f,
-    -0.4f, 0.0f, -0.8f + 1.2f,
-    -0.2f, 0.0f, -1.0f + 1.2f,
-    -0.4f, 0.0f, -0.8f + 1.2f,
-    -0.2f, 0.0f, -1.0f + 1.2f,
-    -0.4f, 0.0f, -1.0f + 1.2f,
-     0.0f, 0.0f, -0.8f + 1.2f,
-    -0.2f, 0.0f, -0.8f + 1.2f,
-     0.0f, 0.0f, -1.0f + 1.2f,
-    -0.2f, 0.0f, -0.8f + 1.2f,
-     0.0f, 0.0f, -1.0f + 1.2f,
-    -0.2f, 0.0f, -1.0f + 1.2f,
-     0.2f, 0.0f, -0.8f + 1.2f,
-     0.0f, 0.0f, -0.8f + 1.2f,
-     0.2f, 0.0f, -1.0f + 1.2f,
-     0.0f, 0.0f, -0.8f + 1.2f,
-     0.2f, 0.0f, -1.0f + 1.2f,
-     0.0f, 0.0f, -1.0f + 1.2f,
-     0.4f, 0.0f, -0.8f + 1.2f,
-     0.2f, 0.0f, -0.8f + 1.2f,
-     0.4f, 0.0f, -1.0f + 1.2f,
-     0.2f, 0.0f, -0.8f + 1.2f,
-     0.4f, 0.0f, -1.0f + 1.2f,
-     0.2f, 0.0f, -1.0f + 1.2f,
-     0.6f, 0.0f, -0.8f + 1.2f,
-     0.4f, 0.0f, -0.8f + 1.2f,
-     0.6f, 0.0f, -1.0f + 1.2f,
-     0.4f, 0.0f, -0.8f + 1.2f,
-     0.6f, 0.0f, -1.0f + 1.2f,
-     0.4f, 0.0f, -1.0f + 1.2f,
-     0.8f, 0.0f, -0.8f + 1.2f,
-     0.6f, 0.0f, -0.8f + 1.2f,
-     0.8f, 0.0f, -1.0f + 1.2f,
-     0.6f, 0.0f, -0.8f + 1.2f,
-     0.8f, 0.0f, -1.0f + 1.2f,
-     0.6f, 0.0f, -1.0f + 1.2f,
-     1.0f, 0.0f, -0.8f + 1.2f,
-     0.8f, 0.0f, -0.8f + 1.2f,
-     1.0f, 0.0f, -1.0f + 1.2f,
-     0.8f, 0.0f, -0.8f + 1.2f,
-     1.0f, 0.0f, -1.0f + 1.2f,
-     0.8f, 0.0f, -1.0f + 1.2f,
-
-    -0.8f, 0.0f, -0.8f + 1.4f,
-    -1.0f, 0.0f, -0.8f + 1.4f,
-    -0.8f, 0.0f, -1.0f + 1.4f,
-    -1.0f, 0.0f, -0.8f + 1.4f,
-    -0.8f, 0.0f, -1.0f + 1.4f,
-    -1.0f, 0.0f, -1.0f + 1.4f,
-    -0.6f, 0.0f, -0.8f + 1.4f,
-    -0.8f, 0.0f, -0.8f + 1.4f,
-    -0.6f, 0.0f, -1.0f + 1.4f,
-    -0.8f, 0.0f, -0.8f + 1.4f,
-    -0.6f, 0.0f, -1.0f + 1.4f,
-    -0.8f, 0.0f, -1.0f + 1.4f,
-    -0.4f, 0.0f, -0.8f + 1.4f,
-    -0.6f, 0.0f, -0.8f + 1.4f,
-    -0.4f, 0.0f, -1.0f + 1.4f,
-    -0.6f, 0.0f, -0.8f + 1.4f,
-    -0.4f, 0.0f, -1.0f + 1.4f,
-    -0.6f, 0.0f, -1.0f + 1.4f,
-    -0.2f, 0.0f, -0.8f + 1.4f,
-    -0.4f, 0.0f, -0.8f + 1.4f,
-    -0.2f, 0.0f, -1.0f + 1.4f,
-    -0.4f, 0.0f, -0.8f + 1.4f,
-    -0.2f, 0.0f, -1.0f + 1.4f,
-    -0.4f, 0.0f, -1.0f + 1.4f,
-     0.0f, 0.0f, -0.8f + 1.4f,
-    -0.2f, 0.0f, -0.8f + 1.4f,
-     0.0f, 0.0f, -1.0f + 1.4f,
-    -0.2f, 0.0f, -0.8f + 1.4f,
-     0.0f, 0.0f, -1.0f + 1.4f,
-    -0.2f, 0.0f, -1.0f + 1.4f,
-     0.2f, 0.0f, -0.8f + 1.4f,
-     0.0f, 0.0f, -0.8f + 1.4f,
-     0.2f, 0.0f, -1.0f + 1.4f,
-     0.0f, 0.0f, -0.8f + 1.4f,
-     0.2f, 0.0f, -1.0f + 1.4f,
-     0.0f, 0.0f, -1.0f + 1.4f,
-     0.4f, 0.0f, -0.8f + 1.4f,
-     0.2f, 0.0f, -0.8f + 1.4f,
-     0.4f, 0.0f, -1.0f + 1.4f,
-     0.2f, 0.0f, -0.8f + 1.4f,
-     0.4f, 0.0f, -1.0f + 1.4f,
-     0.2f, 0.0f, -1.0f + 1.4f,
-     0.6f, 0.0f, -0.8f + 1.4f,
-     0.4f, 0.0f, -0.8f + 1.4f,
-     0.6f, 0.0f, -1.0f + 1.4f,
-     0.4f, 0.0f, -0.8f + 1.4f,
-     0.6f, 0.0f, -1.0f + 1.4f,
-     0.4f, 0.0f, -1.0f + 1.4f,
-     0.8f, 0.0f, -0.8f + 1.4f,
-     0.6f, 0.0f, -0.8f + 1.4f,
-     0.8f, 0.0f, -1.0f + 1.4f,
-     0.6f, 0.0f, -0.8f + 1.4f,
-     0.8f, 0.0f, -1.0f + 1.4f,
-     0.6f, 0.0f, -1.0f + 1.4f,
-     1.0f, 0.0f, -0.8f + 1.4f,
-     0.8f, 0.0f, -0.8f + 1.4f,
-     1.0f, 0.0f, -1.0f + 1.4f,
-     0.8f, 0.0f, -0.8f + 1.4f,
-     1.0f, 0.0f, -1.0f + 1.4f,
-     0.8f, 0.0f, -1.0f + 1.4f,
-
-    -0.8f, 0.0f, -0.8f + 1.6f,
-    -1.0f, 0.0f, -0.8f + 1.6f,
-    -0.8f, 0.0f, -1.0f + 1.6f,
-    -1.0f, 0.0f, -0.8f + 1.6f,
-    -0.8f, 0.0f, -1.0f + 1.6f,
-    -1.0f, 0.0f, -1.0f + 1.6f,
-    -0.6f, 0.0f, -0.8f + 1.6f,
-    -0.8f, 0.0f, -0.8f + 1.6f,
-    -0.6f, 0.0f, -1.0f + 1.6f,
-    -0.8f, 0.0f, -0.8f + 1.6f,
-    -0.6f, 0.0f, -1.0f + 1.6f,
-    -0.8f, 0.0f, -1.0f + 1.6f,
-    -0.4f, 0.0f, -0.8f + 1.6f,
-    -0.6f, 0.0f, -0.8f + 1.6f,
-    -0.4f, 0.0f, -1.0f + 1.6f,
-    -0.6f, 0.0f, -0.8f + 1.6f,
-    -0.4f, 0.0f, -1.0f + 1.6f,
-    -0.6f, 0.0f, -1.0f + 1.6f,
-    -0.2f, 0.0f, -0.8f + 1.6f,
-    -0.4f, 0.0f, -0.8f + 1.6f,
-    -0.2f, 0.0f, -1.0f + 1.6f,
-    -0.4f, 0.0f, -0.8f + 1.6f,
-    -0.2f, 0.0f, -1.0f + 1.6f,
-    -0.4f, 0.0f, -1.0f + 1.6f,
-     0.0f, 0.0f, -0.8f + 1.6f,
-    -0.2f, 0.0f, -0.8f + 1.6f,
-     0.0f, 0.0f, -1.0f + 1.6f,
-    -0.2f, 0.0f, -0.8f + 1.6f,
-     0.0f, 0.0f, -1.0f + 1.6f,
-    -0.2f, 0.0f, -1.0f + 1.6f,
-     0.2f, 0.0f, -0.8f + 1.6f,
-     0.0f, 0.0f, -0.8f + 1.6f,
-     0.2f, 0.0f, -1.0f + 1.6f,
-     0.0f, 0.0f, -0.8f + 1.6f,
-     0.2f, 0.0f, -1.0f + 1.6f,
-     0.0f, 0.0f, -1.0f + 1.6f,
-     0.4f, 0.0f, -0.8f + 1.6f,
-     0.2f, 0.0f, -0.8f + 1.6f,
-     0.4f, 0.0f, -1.0f + 1.6f,
-     0.2f, 0.0f, -0.8f + 1.6f,
-     0.4f, 0.0f, -1.0f + 1.6f,
-     0.2f, 0.0f, -1.0f + 1.6f,
-     0.6f, 0.0f, -0.8f + 1.6f,
-     0.4f, 0.0f, -0.8f + 1.6f,
-     0.6f, 0.0f, -1.0f + 1.6f,
-     0.4f, 0.0f, -0.8f + 1.6f,
-     0.6f, 0.0f, -1.0f + 1.6f,
-     0.4f, 0.0f, -1.0f + 1.6f,
-     0.8f, 0.0f, -0.8f + 1.6f,
-     0.6f, 0.0f, -0.8f + 1.6f,
-     0.8f, 0.0f, -1.0f + 1.6f,
-     0.6f, 0.0f, -0.8f + 1.6f,
-     0.8f, 0.0f, -1.0f + 1.6f,
-     0.6f, 0.0f, -1.0f + 1.6f,
-     1.0f, 0.0f, -0.8f + 1.6f,
-     0.8f, 0.0f, -0.8f + 1.6f,
-     1.0f, 0.0f, -1.0f + 1.6f,
-     0.8f, 0.0f, -0.8f + 1.6f,
-     1.0f, 0.0f, -1.0f + 1.6f,
-     0.8f, 0.0f, -1.0f + 1.6f,
-
-    -0.8f, 0.0f, -0.8f + 1.8f,
-    -1.0f, 0.0f, -0.8f + 1.8f,
-    -0.8f, 0.0f, -1.0f + 1.8f,
-    -1.0f, 0.0f, -0.8f + 1.8f,
-    -0.8f, 0.0f, -1.0f + 1.8f,
-    -1.0f, 0.0f, -1.0f + 1.8f,
-    -0.6f, 0.0f, -0.8f + 1.8f,
-    -0.8f, 0.0f, -0.8f + 1.8f,
-    -0.6f, 0.0f, -1.0f + 1.8f,
-    -0.8f, 0.0f, -0.8f + 1.8f,
-    -0.6f, 0.0f, -1.0f + 1.8f,
-    -0.8f, 0.0f, -1.0f + 1.8f,
-    -0.4f, 0.0f, -0.8f + 1.8f,
-    -0.6f, 0.0f, -0.8f + 1.8f,
-    -0.4f, 0.0f, -1.0f + 1.8f,
-    -0.6f, 0.0f, -0.8f + 1.8f,
-    -0.4f, 0.0f, -1.0f + 1.8f,
-    -0.6f, 0.0f, -1.0f + 1.8f,
-    -0.2f, 0.0f, -0.8f + 1.8f,
-    -0.4f, 0.0f, -0.8f + 1.8f,
-    -0.2f, 0.0f, -1.0f + 1.8f,
-    -0.4f, 0.0f, -0.8f + 1.8f,
-    -0.2f, 0.0f, -1.0f + 1.8f,
-    -0.4f, 0.0f, -1.0f + 1.8f,
-     0.0f, 0.0f, -0.8f + 1.8f,
-    -0.2f, 0.0f, -0.8f + 1.8f,
-     0.0f, 0.0f, -1.0f + 1.8f,
-    -0.2f, 0.0f, -0.8f + 1.8f,
-     0.0f, 0.0f, -1.0f + 1.8f,
-    -0.2f, 0.0f, -1.0f + 1.8f,
-     0.2f, 0.0f, -0.8f + 1.8f,
-     0.0f, 0.0f, -0.8f + 1.8f,
-     0.2f, 0.0f, -1.0f + 1.8f,
-     0.0f, 0.0f, -0.8f + 1.8f,
-     0.2f, 0.0f, -1.0f + 1.8f,
-     0.0f, 0.0f, -1.0f + 1.8f,
-     0.4f, 0.0f, -0.8f + 1.8f,
-     0.2f, 0.0f, -0.8f + 1.8f,
-     0.4f, 0.0f, -1.0f + 1.8f,
-     0.2f, 0.0f, -0.8f + 1.8f,
-     0.4f, 0.0f, -1.0f + 1.8f,
-     0.2f, 0.0f, -1.0f + 1.8f,
-     0.6f, 0.0f, -0.8f + 1.8f,
-     0.4f, 0.0f, -0.8f + 1.8f,
-     0.6f, 0.0f, -1.0f + 1.8f,
-     0.4f, 0.0f, -0.8f + 1.8f,
-     0.6f, 0.0f, -1.0f + 1.8f,
-     0.4f, 0.0f, -1.0f + 1.8f,
-     0.8f, 0.0f, -0.8f + 1.8f,
-     0.6f, 0.0f, -0.8f + 1.8f,
-     0.8f, 0.0f, -1.0f + 1.8f,
-     0.6f, 0.0f, -0.8f + 1.8f,
-     0.8f, 0.0f, -1.0f + 1.8f,
-     0.6f, 0.0f, -1.0f + 1.8f,
-     1.0f, 0.0f, -0.8f + 1.8f,
-     0.8f, 0.0f, -0.8f + 1.8f,
-     1.0f, 0.0f, -1.0f + 1.8f,
-     0.8f, 0.0f, -0.8f + 1.8f,
-     1.0f, 0.0f, -1.0f + 1.8f,
-     0.8f, 0.0f, -1.0f + 1.8f
+    Cube,
+    Custom
 };
 
 float gCubeVertices[] = {
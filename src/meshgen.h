@@ -0,0 +1,247 @@
+#ifndef __MESH_GEN_
+#define __MESH_GEN_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include <glad/gl.h>
+
+#include "utils.h"
+#include "meshregistry.h"
+#include "meshindex.h"
+
+// Rows per thread below which generation isn`t split further
+#define MG_MIN_ROWS 16
+
+/**
+ * @brief Procedural surface kinds, all are (u, v) grids of vertices
+ */
+enum MeshGenType {
+    MGGrid,
+    MGSphere,
+    MGTorus,
+    MGCylinder
+};
+
+/**
+ * @brief Generator parameters parsed from shape string
+ */
+typedef struct MeshGenDesc_s {
+    int mType;
+    // Segments along u (around) and v (along)
+    uint32_t mSegmentsU, mSegmentsV;
+    float mScale;
+} MeshGenDesc_t;
+
+/**
+ * @brief Parse "grid:WxH", "sphere:N", "torus:N" or "torus:MxN", "cylinder:N" or "cylinder:NxH"
+ *
+ * @param spec
+ * @param scale multiplies every position
+ * @param pDesc
+ * @return true
+ * @return false unknown shape or bad size
+ */
+bool MGParse(const char* spec, float scale, MeshGenDesc_t* pDesc) {
+    const char* names[] = {"grid:", "sphere:", "torus:", "cylinder:"};
+    uint64_t a = 0, b = 0, u = 0, v = 0;
+
+    memset(pDesc, 0, sizeof(MeshGenDesc_t));
+    pDesc->mScale = scale;
+    pDesc->mType = -1;
+
+    for(int i = 0; i < 4; i++) {
+        if(strncmp(spec, names[i], strlen(names[i])) == 0) {
+            pDesc->mType = i;
+
+            // strtoull would wrap "-1" into huge count, sign is not a digit so it is rejected
+            const char* p = spec + strlen(names[i]);
+            char* pEnd = nullptr;
+
+            a = *p >= '0' && *p <= '9' ? strtoull(p, &pEnd, 10) : 0;
+
+            if(a && *pEnd == 'x') {
+                p = pEnd + 1;
+                b = *p >= '0' && *p <= '9' ? strtoull(p, &pEnd, 10) : 0;
+            }
+        }
+    }
+
+    if(pDesc->mType < 0 || a == 0) {
+        printf("[INFO]: Unknown shape <%s>\n", spec);
+
+        return false;
+    }
+
+    switch(pDesc->mType) {
+        case MGGrid:
+            u = a;
+            v = b ? b : a;
+            break;
+        case MGSphere:
+            u = a < 3 ? 3 : a;
+            v = u / 2 < 2 ? 2 : u / 2;
+            break;
+        case MGTorus:
+            u = a < 3 ? 3 : a;
+            v = b < 3 ? (a / 2 < 3 ? 3 : a / 2) : b;
+            break;
+        case MGCylinder:
+            // Extra first and last row collapse into cap centers
+            u = a < 3 ? 3 : a;
+            v = (b ? b : 1) + 2;
+            break;
+    }
+
+    // Rows * columns must fit in 32-bit indices, counts are checked before products so they can`t wrap
+    if(u >= 0xFFFFFFFFull || v >= 0xFFFFFFFFull || (u + 1) * (v + 1) > 0xFFFFFFFFull || u * v * 6 > 0xFFFFFFFFull) {
+        printf("[INFO]: Shape <%s> is too big\n", spec);
+
+        return false;
+    }
+
+    pDesc->mSegmentsU = (uint32_t)u;
+    pDesc->mSegmentsV = (uint32_t)v;
+
+    return true;
+}
+
+/**
+ * @brief Shared state of generator threads
+ */
+typedef struct __MGContext_s {
+    const MeshGenDesc_t* pDesc;
+    float* pPositions;
+    void* pIndices;
+    bool mShortIndices;
+} __MGContext_t;
+
+/**
+ * @brief Position of surface point
+ *
+ * @param pDesc
+ * @param u 0 - 1 around
+ * @param v 0 - 1 along
+ * @param pOut
+ */
+void __MGPosition(const MeshGenDesc_t* pDesc, float u, float v, float* pOut) {
+    const float pi = 3.14159265359f;
+
+    switch(pDesc->mType) {
+        case MGGrid:
+            // Same orientation as old hand written planes, y up, [-1, 1] on x and z
+            pOut[0] = u * 2.0f - 1.0f;
+            pOut[1] = 0.0f;
+            pOut[2] = v * 2.0f - 1.0f;
+            break;
+        case MGSphere:
+            pOut[0] = sinf(v * pi) * cosf(u * 2.0f * pi);
+            pOut[1] = cosf(v * pi);
+            pOut[2] = sinf(v * pi) * sinf(u * 2.0f * pi);
+            break;
+        case MGTorus: {
+            float ring = 1.0f + 0.35f * cosf(v * 2.0f * pi);
+
+            pOut[0] = ring * cosf(u * 2.0f * pi);
+            pOut[1] = 0.35f * sinf(v * 2.0f * pi);
+            pOut[2] = ring * sinf(u * 2.0f * pi);
+            break;
+        }
+        case MGCylinder: {
+            // Row 0 and last row are cap centers, rows between go from bottom to top rim
+            uint32_t row = (uint32_t)(v * pDesc->mSegmentsV + 0.5f);
+            bool cap = row == 0 || row == pDesc->mSegmentsV;
+            float height = cap ? (row == 0 ? -1.0f : 1.0f) : (float)(row - 1) / (pDesc->mSegmentsV - 2) * 2.0f - 1.0f;
+
+            pOut[0] = cap ? 0.0f : cosf(u * 2.0f * pi);
+            pOut[1] = height;
+            pOut[2] = cap ? 0.0f : sinf(u * 2.0f * pi);
+            break;
+        }
+    }
+
+    pOut[0] *= pDesc->mScale;
+    pOut[1] *= pDesc->mScale;
+    pOut[2] *= pDesc->mScale;
+}
+
+void __MGVertexRows(uint32_t begin, uint32_t end, void* pData) {
+    __MGContext_t* pContext = (__MGContext_t*)pData;
+    const MeshGenDesc_t* pDesc = pContext->pDesc;
+    uint32_t columns = pDesc->mSegmentsU + 1;
+
+    for(uint32_t y = begin; y < end; y++) {
+        for(uint32_t x = 0; x < columns; x++) {
+            __MGPosition(pDesc, (float)x / pDesc->mSegmentsU, (float)y / pDesc->mSegmentsV, &pContext->pPositions[((uint64_t)y * columns + x) * 3]);
+        }
+    }
+}
+
+void __MGIndexRows(uint32_t begin, uint32_t end, void* pData) {
+    __MGContext_t* pContext = (__MGContext_t*)pData;
+    uint32_t columns = pContext->pDesc->mSegmentsU + 1;
+
+    for(uint32_t y = begin; y < end; y++) {
+        for(uint32_t x = 0; x < pContext->pDesc->mSegmentsU; x++) {
+            uint32_t a = y * columns + x, b = a + 1, c = a + columns, d = c + 1;
+            uint32_t quad[6] = {b, a, d, a, c, d};
+            uint64_t offset = ((uint64_t)y * pContext->pDesc->mSegmentsU + x) * 6;
+
+            for(uint32_t i = 0; i < 6; i++) {
+                if(pContext->mShortIndices) {
+                    ((uint16_t*)pContext->pIndices)[offset + i] = (uint16_t)quad[i];
+                }
+                else {
+                    ((uint32_t*)pContext->pIndices)[offset + i] = quad[i];
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Generate indexed mesh, rows of vertices and indices are generated in parallel
+ *
+ * @param name used in log
+ * @param pDesc
+ * @param pMesh output, free with MIFree
+ * @return true
+ * @return false out of memory
+ */
+bool MGGenerate(const char* name, const MeshGenDesc_t* pDesc, IndexedMesh_t* pMesh) {
+    memset(pMesh, 0, sizeof(IndexedMesh_t));
+
+    double start = UTGetTimeMs();
+
+    uint32_t vertexCount = (pDesc->mSegmentsU + 1) * (pDesc->mSegmentsV + 1);
+    uint32_t indexCount = pDesc->mSegmentsU * pDesc->mSegmentsV * 6;
+    bool shortIndices = vertexCount <= 0x10000;
+
+    pMesh->mDesc = MRDescPositions(vertexCount);
+    pMesh->mDesc.mIndexCount = indexCount;
+    pMesh->mDesc.mIndexType = shortIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+
+    pMesh->pVertices = malloc((uint64_t)vertexCount * 3 * sizeof(float));
+    pMesh->pIndices = malloc((uint64_t)indexCount * (shortIndices ? sizeof(uint16_t) : sizeof(uint32_t)));
+
+    if(!pMesh->pVertices || !pMesh->pIndices) {
+        printf("[INFO]: Not enough memory to generate %s\n", name);
+        MIFree(pMesh);
+
+        return false;
+    }
+
+    __MGContext_t context = {pDesc, (float*)pMesh->pVertices, pMesh->pIndices, shortIndices};
+
+    uint32_t threads = UTParallelFor(pDesc->mSegmentsV + 1, MG_MIN_ROWS, __MGVertexRows, &context);
+    UTParallelFor(pDesc->mSegmentsV, MG_MIN_ROWS, __MGIndexRows, &context);
+
+    printf("[INFO]: Generated %s: %u vertices, %u triangles, %s indices in %.2f ms on %u threads\n", name, vertexCount, indexCount / 3, shortIndices ? "16-bit" : "32-bit", UTGetTimeMs() - start, threads);
+
+    return true;
+}
+
+#endif
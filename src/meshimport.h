@@ -0,0 +1,1417 @@
+#ifndef __MESH_IMPORT_
+#define __MESH_IMPORT_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include <glad/gl.h>
+
+#include "utils.h"
+#include "meshregistry.h"
+#include "meshindex.h"
+
+// Smallest part of file worth own parse task
+#define IM_MIN_CHUNK_BYTES (256 * 1024)
+// Chunks per core, more chunks than cores evens out chunks with more faces than others
+#define IM_CHUNKS_PER_CORE 4
+#define IM_MAX_CHUNKS 256
+#define IM_PLY_MAX_ELEMENTS 16
+#define IM_PLY_MAX_PROPERTIES 32
+// Index component which was not in file (face without uv or normal)
+#define IM_MISSING INT32_MIN
+
+/**
+ * @brief Growable array of fixed size elements
+ */
+typedef struct IMArray_s {
+    uint8_t* pData;
+    uint64_t mCount, mCapacity;
+    uint32_t mElementSize;
+} IMArray_t;
+
+/**
+ * @brief Append uninitialized elements
+ *
+ * @param pArray
+ * @param count
+ * @return void* first appended element, nullptr when out of memory
+ */
+void* __IMArrayPush(IMArray_t* pArray, uint64_t count) {
+    if(pArray->mCount + count > pArray->mCapacity) {
+        uint64_t capacity = pArray->mCapacity ? pArray->mCapacity * 2 : 1024;
+
+        while(capacity < pArray->mCount + count) {
+            capacity *= 2;
+        }
+
+        uint8_t* pData = (uint8_t*)realloc(pArray->pData, capacity * pArray->mElementSize);
+
+        if(!pData) {
+            return nullptr;
+        }
+
+        pArray->pData = pData;
+        pArray->mCapacity = capacity;
+    }
+
+    void* pElement = pArray->pData + pArray->mCount * pArray->mElementSize;
+    pArray->mCount += count;
+
+    return pElement;
+}
+
+/**
+ * @brief Part of file parsed by one task, results are merged in chunk order
+ */
+typedef struct __IMChunk_s {
+    const char* pBegin;
+    const char* pEnd;
+
+    // float3, float3 and float2 in order they appear in chunk
+    IMArray_t mPositions, mNormals, mUVs;
+    // int32 (position, uv, normal) per triangle corner, 0 based or IM_MISSING
+    IMArray_t mCorners;
+    // uint8 per corner, bit k set when component k is relative to counts at end of previous chunks
+    IMArray_t mRelative;
+    bool mError;
+} __IMChunk_t;
+
+void __IMChunkInit(__IMChunk_t* pChunk, const char* pBegin, const char* pEnd) {
+    memset(pChunk, 0, sizeof(__IMChunk_t));
+
+    pChunk->pBegin = pBegin;
+    pChunk->pEnd = pEnd;
+    pChunk->mPositions.mElementSize = 3 * sizeof(float);
+    pChunk->mNormals.mElementSize = 3 * sizeof(float);
+    pChunk->mUVs.mElementSize = 2 * sizeof(float);
+    pChunk->mCorners.mElementSize = 3 * sizeof(int32_t);
+    pChunk->mRelative.mElementSize = sizeof(uint8_t);
+}
+
+void __IMChunkFree(__IMChunk_t* pChunk) {
+    free(pChunk->mPositions.pData);
+    free(pChunk->mNormals.pData);
+    free(pChunk->mUVs.pData);
+    free(pChunk->mCorners.pData);
+    free(pChunk->mRelative.pData);
+
+    memset(pChunk, 0, sizeof(__IMChunk_t));
+}
+
+/**
+ * @brief Split text into chunks, every chunk ends after newline so no line is split between two chunks
+ *
+ * @param pBegin
+ * @param pEnd
+ * @param pChunks
+ * @param maxChunks
+ * @return uint32_t chunks used
+ */
+uint32_t __IMSplit(const char* pBegin, const char* pEnd, __IMChunk_t* pChunks, uint32_t maxChunks) {
+    uint64_t length = pEnd - pBegin;
+    uint64_t count = (uint64_t)UTCoreCount() * IM_CHUNKS_PER_CORE;
+
+    count = count > maxChunks ? maxChunks : count;
+    count = length / IM_MIN_CHUNK_BYTES + 1 < count ? length / IM_MIN_CHUNK_BYTES + 1 : count;
+
+    const char* p = pBegin;
+
+    for(uint32_t i = 0; i < count; i++) {
+        const char* pSplit = i + 1 == count ? pEnd : pBegin + length * (i + 1) / count;
+
+        if(pSplit < p) {
+            pSplit = p;
+        }
+
+        if(pSplit < pEnd) {
+            const char* pLine = (const char*)memchr(pSplit, '\n', pEnd - pSplit);
+            pSplit = pLine ? pLine + 1 : pEnd;
+        }
+
+        __IMChunkInit(&pChunks[i], p, pSplit);
+        p = pSplit;
+    }
+
+    return (uint32_t)count;
+}
+
+/**
+ * @brief Skip whole lines
+ *
+ * @param p
+ * @param pEnd
+ * @param count
+ * @return const char* start of line after skipped ones, pEnd when text ended first
+ */
+const char* __IMSkipLines(const char* p, const char* pEnd, uint64_t count) {
+    for(uint64_t i = 0; i < count && p < pEnd; i++) {
+        const char* pLine = (const char*)memchr(p, '\n', pEnd - p);
+        p = pLine ? pLine + 1 : pEnd;
+    }
+
+    return p;
+}
+
+const char* __IMSkipSpaces(const char* p, const char* pEnd) {
+    while(p < pEnd && (*p == ' ' || *p == '\t' || *p == '\r')) {
+        p++;
+    }
+
+    return p;
+}
+
+double __IMPow10(int32_t exponent) {
+    static const double table[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    return exponent < 23 ? table[exponent] : pow(10.0, exponent);
+}
+
+/**
+ * @brief Parse decimal float without locale and null terminator, much faster than strtod on usual mesh numbers
+ *
+ * @param ppCursor moved after number
+ * @param pEnd
+ * @param pOut
+ * @return true
+ * @return false no number before end of line
+ */
+bool __IMParseFloat(const char** ppCursor, const char* pEnd, float* pOut) {
+    const char* p = __IMSkipSpaces(*ppCursor, pEnd);
+    const char* pStart = p;
+    bool negative = false;
+
+    if(p < pEnd && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        p++;
+    }
+
+    double mantissa = 0.0;
+    int32_t exponent = 0;
+    bool digits = false;
+
+    while(p < pEnd && *p >= '0' && *p <= '9') {
+        mantissa = mantissa * 10.0 + (*p++ - '0');
+        digits = true;
+    }
+
+    if(p < pEnd && *p == '.') {
+        p++;
+
+        while(p < pEnd && *p >= '0' && *p <= '9') {
+            mantissa = mantissa * 10.0 + (*p++ - '0');
+            exponent--;
+            digits = true;
+        }
+    }
+
+    if(!digits) {
+        // nan, inf and other rare spellings, strtod needs terminated copy
+        char buffer[64];
+        uint32_t length = 0;
+
+        for(p = pStart; p < pEnd && length < sizeof(buffer) - 1 && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n'; p++) {
+            buffer[length++] = *p;
+        }
+
+        buffer[length] = 0;
+
+        char* pParsed = nullptr;
+        double value = strtod(buffer, &pParsed);
+
+        if(pParsed == buffer) {
+            return false;
+        }
+
+        *pOut = (float)value;
+        *ppCursor = pStart + (pParsed - buffer);
+
+        return true;
+    }
+
+    if(p < pEnd && (*p == 'e' || *p == 'E')) {
+        const char* pExponent = p + 1;
+        bool negativeExponent = false;
+        int32_t value = 0;
+
+        if(pExponent < pEnd && (*pExponent == '-' || *pExponent == '+')) {
+            negativeExponent = *pExponent == '-';
+            pExponent++;
+        }
+
+        if(pExponent < pEnd && *pExponent >= '0' && *pExponent <= '9') {
+            while(pExponent < pEnd && *pExponent >= '0' && *pExponent <= '9') {
+                value = value < 10000 ? value * 10 + (*pExponent - '0') : value;
+                pExponent++;
+            }
+
+            exponent += negativeExponent ? -value : value;
+            p = pExponent;
+        }
+    }
+
+    double value = exponent < 0 ? mantissa / __IMPow10(-exponent) : mantissa * __IMPow10(exponent);
+
+    *pOut = (float)(negative ? -value : value);
+    *ppCursor = p;
+
+    return true;
+}
+
+/**
+ * @brief Parse decimal integer
+ *
+ * @param ppCursor moved after number
+ * @param pEnd
+ * @param pOut
+ * @return true
+ * @return false no number or it doesn`t fit 32 bits
+ */
+bool __IMParseInt(const char** ppCursor, const char* pEnd, int64_t* pOut) {
+    const char* p = __IMSkipSpaces(*ppCursor, pEnd);
+    bool negative = false;
+
+    if(p < pEnd && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        p++;
+    }
+
+    if(p >= pEnd || *p < '0' || *p > '9') {
+        return false;
+    }
+
+    int64_t value = 0;
+
+    while(p < pEnd && *p >= '0' && *p <= '9') {
+        value = value * 10 + (*p++ - '0');
+
+        if(value > INT32_MAX) {
+            return false;
+        }
+    }
+
+    *pOut = negative ? -value : value;
+    *ppCursor = p;
+
+    return true;
+}
+
+/**
+ * @brief Append triangle made of three corners
+ *
+ * @param pChunk
+ * @param pA
+ * @param pB
+ * @param pC
+ * @param relative relative bits of a, b and c
+ * @return true
+ * @return false out of memory
+ */
+bool __IMPushTriangle(__IMChunk_t* pChunk, const int32_t* pA, const int32_t* pB, const int32_t* pC, const uint8_t* pRelative) {
+    int32_t* pCorners = (int32_t*)__IMArrayPush(&pChunk->mCorners, 3);
+    uint8_t* pFlags = (uint8_t*)__IMArrayPush(&pChunk->mRelative, 3);
+
+    if(!pCorners || !pFlags) {
+        return false;
+    }
+
+    memcpy(&pCorners[0], pA, 3 * sizeof(int32_t));
+    memcpy(&pCorners[3], pB, 3 * sizeof(int32_t));
+    memcpy(&pCorners[6], pC, 3 * sizeof(int32_t));
+    memcpy(pFlags, pRelative, 3);
+
+    return true;
+}
+
+/**
+ * @brief Parse "f" line, polygons are triangulated as fan around first corner
+ *
+ * @param pChunk
+ * @param p after "f"
+ * @param pEnd end of line
+ * @return true
+ * @return false bad index or out of memory
+ */
+bool __IMObjFace(__IMChunk_t* pChunk, const char* p, const char* pEnd) {
+    // Negative indices count back from last element so far, in chunk they are relative to chunk start until merge
+    int64_t counts[3] = {pChunk->mPositions.mCount, pChunk->mUVs.mCount, pChunk->mNormals.mCount};
+    int32_t corners[3][3];
+    uint8_t relative[3];
+    uint32_t count = 0;
+
+    for(;;) {
+        int64_t values[3] = {0, 0, 0};
+
+        if(!__IMParseInt(&p, pEnd, &values[0])) {
+            break;
+        }
+
+        if(p < pEnd && *p == '/') {
+            p++;
+
+            if(p < pEnd && *p != '/') {
+                __IMParseInt(&p, pEnd, &values[1]);
+            }
+
+            if(p < pEnd && *p == '/') {
+                p++;
+                __IMParseInt(&p, pEnd, &values[2]);
+            }
+        }
+
+        // Corner 0 is first of fan, 1 previous and 2 current
+        uint32_t slot = count < 2 ? count : 2;
+        relative[slot] = 0;
+
+        for(uint32_t k = 0; k < 3; k++) {
+            if(values[k] > 0) {
+                corners[slot][k] = (int32_t)(values[k] - 1);
+            }
+            else if(values[k] < 0) {
+                corners[slot][k] = (int32_t)(counts[k] + values[k]);
+                relative[slot] |= 1 << k;
+            }
+            else {
+                corners[slot][k] = IM_MISSING;
+            }
+        }
+
+        if(corners[slot][0] == IM_MISSING) {
+            return false;
+        }
+
+        if(count >= 2) {
+            if(!__IMPushTriangle(pChunk, corners[0], corners[1], corners[2], relative)) {
+                return false;
+            }
+
+            memcpy(corners[1], corners[2], sizeof(corners[1]));
+            relative[1] = relative[2];
+        }
+
+        count++;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Parse v, vn, vt and f lines of chunk, everything else (groups, materials, lines) is ignored
+ *
+ * @param pChunk
+ */
+void __IMObjParse(__IMChunk_t* pChunk) {
+    const char* p = pChunk->pBegin;
+    const char* pEnd = pChunk->pEnd;
+
+    while(p < pEnd && !pChunk->mError) {
+        const char* pLine = (const char*)memchr(p, '\n', pEnd - p);
+        const char* pLineEnd = pLine ? pLine : pEnd;
+
+        p = __IMSkipSpaces(p, pLineEnd);
+
+        if(pLineEnd - p >= 2 && p[0] == 'v' && (p[1] == ' ' || p[1] == '\t')) {
+            float* pPosition = (float*)__IMArrayPush(&pChunk->mPositions, 1);
+            p += 2;
+
+            pChunk->mError = !pPosition || !__IMParseFloat(&p, pLineEnd, &pPosition[0]) || !__IMParseFloat(&p, pLineEnd, &pPosition[1]) || !__IMParseFloat(&p, pLineEnd, &pPosition[2]);
+        }
+        else if(pLineEnd - p >= 3 && p[0] == 'v' && p[1] == 'n' && (p[2] == ' ' || p[2] == '\t')) {
+            float* pNormal = (float*)__IMArrayPush(&pChunk->mNormals, 1);
+            p += 3;
+
+            pChunk->mError = !pNormal || !__IMParseFloat(&p, pLineEnd, &pNormal[0]) || !__IMParseFloat(&p, pLineEnd, &pNormal[1]) || !__IMParseFloat(&p, pLineEnd, &pNormal[2]);
+        }
+        else if(pLineEnd - p >= 3 && p[0] == 'v' && p[1] == 't' && (p[2] == ' ' || p[2] == '\t')) {
+            float* pUV = (float*)__IMArrayPush(&pChunk->mUVs, 1);
+            p += 3;
+
+            pChunk->mError = !pUV || !__IMParseFloat(&p, pLineEnd, &pUV[0]);
+
+            // v is optional in 1D textures
+            if(!pChunk->mError && !__IMParseFloat(&p, pLineEnd, &pUV[1])) {
+                pUV[1] = 0.0f;
+            }
+        }
+        else if(pLineEnd - p >= 2 && p[0] == 'f' && (p[1] == ' ' || p[1] == '\t')) {
+            pChunk->mError = !__IMObjFace(pChunk, p + 2, pLineEnd);
+        }
+
+        p = pLine ? pLine + 1 : pEnd;
+    }
+}
+
+void __IMObjChunks(uint32_t begin, uint32_t end, void* pData) {
+    __IMChunk_t* pChunks = (__IMChunk_t*)pData;
+
+    for(uint32_t i = begin; i < end; i++) {
+        __IMObjParse(&pChunks[i]);
+    }
+}
+
+/**
+ * @brief Chunk results concatenated in file order
+ */
+typedef struct __IMMerge_s {
+    __IMChunk_t* pChunks;
+    // Elements before chunk, last entry is total, components are positions, uvs, normals and corners
+    uint64_t mBase[IM_MAX_CHUNKS + 1][4];
+
+    float* pPositions;
+    float* pUVs;
+    float* pNormals;
+    // Resolved (position, uv, normal) per corner, missing component is ~0u
+    uint32_t* pKeys;
+} __IMMerge_t;
+
+void __IMMergeChunks(uint32_t begin, uint32_t end, void* pData) {
+    __IMMerge_t* pMerge = (__IMMerge_t*)pData;
+    const uint64_t* pTotal = pMerge->mBase[IM_MAX_CHUNKS];
+
+    for(uint32_t i = begin; i < end; i++) {
+        __IMChunk_t* pChunk = &pMerge->pChunks[i];
+        const uint64_t* pBase = pMerge->mBase[i];
+
+        if(pChunk->mPositions.mCount) {
+            memcpy(pMerge->pPositions + pBase[0] * 3, pChunk->mPositions.pData, pChunk->mPositions.mCount * 3 * sizeof(float));
+        }
+
+        if(pChunk->mUVs.mCount) {
+            memcpy(pMerge->pUVs + pBase[1] * 2, pChunk->mUVs.pData, pChunk->mUVs.mCount * 2 * sizeof(float));
+        }
+
+        if(pChunk->mNormals.mCount) {
+            memcpy(pMerge->pNormals + pBase[2] * 3, pChunk->mNormals.pData, pChunk->mNormals.mCount * 3 * sizeof(float));
+        }
+
+        const int32_t* pCorners = (const int32_t*)pChunk->mCorners.pData;
+        const uint8_t* pRelative = pChunk->mRelative.pData;
+        uint32_t* pKeys = pMerge->pKeys + pBase[3] * 3;
+
+        for(uint64_t c = 0; c < pChunk->mCorners.mCount; c++) {
+            for(uint32_t k = 0; k < 3; k++) {
+                int32_t value = pCorners[c * 3 + k];
+
+                if(value == IM_MISSING) {
+                    pKeys[c * 3 + k] = ~0u;
+
+                    continue;
+                }
+
+                int64_t index = (pRelative && (pRelative[c] & (1 << k))) ? (int64_t)pBase[k] + value : value;
+
+                if(index < 0 || (uint64_t)index >= pTotal[k]) {
+                    pChunk->mError = true;
+                    index = 0;
+                }
+
+                pKeys[c * 3 + k] = (uint32_t)index;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Concatenate chunk attributes and resolve corner indices, runs in parallel over chunks
+ *
+ * @param pChunks
+ * @param count
+ * @param pMerge output, free with __IMMergeFree
+ * @param pThreads max threads used so far, updated
+ * @return true
+ * @return false out of memory, bad index or mesh too big
+ */
+bool __IMMerge(__IMChunk_t* pChunks, uint32_t count, __IMMerge_t* pMerge, uint32_t* pThreads) {
+    memset(pMerge, 0, sizeof(__IMMerge_t));
+
+    pMerge->pChunks = pChunks;
+
+    uint64_t total[4] = {0, 0, 0, 0};
+
+    for(uint32_t i = 0; i < count; i++) {
+        memcpy(pMerge->mBase[i], total, sizeof(total));
+
+        total[0] += pChunks[i].mPositions.mCount;
+        total[1] += pChunks[i].mUVs.mCount;
+        total[2] += pChunks[i].mNormals.mCount;
+        total[3] += pChunks[i].mCorners.mCount;
+    }
+
+    memcpy(pMerge->mBase[IM_MAX_CHUNKS], total, sizeof(total));
+
+    // Keys use ~0u as missing and MIWeld counts in 32 bits
+    if(total[0] >= 0xFFFFFFFFull || total[1] >= 0xFFFFFFFFull || total[2] >= 0xFFFFFFFFull || total[3] >= 0xFFFFFFFFull) {
+        printf("[INFO]: Mesh is too big\n");
+
+        return false;
+    }
+
+    pMerge->pPositions = (float*)malloc((total[0] ? total[0] : 1) * 3 * sizeof(float));
+    pMerge->pUVs = (float*)malloc((total[1] ? total[1] : 1) * 2 * sizeof(float));
+    pMerge->pNormals = (float*)malloc((total[2] ? total[2] : 1) * 3 * sizeof(float));
+    pMerge->pKeys = (uint32_t*)malloc((total[3] ? total[3] : 1) * 3 * sizeof(uint32_t));
+
+    if(!pMerge->pPositions || !pMerge->pUVs || !pMerge->pNormals || !pMerge->pKeys) {
+        printf("[INFO]: Not enough memory to import mesh\n");
+
+        return false;
+    }
+
+    uint32_t threads = UTParallelFor(count, 1, __IMMergeChunks, pMerge);
+    *pThreads = threads > *pThreads ? threads : *pThreads;
+
+    for(uint32_t i = 0; i < count; i++) {
+        if(pChunks[i].mError) {
+            printf("[INFO]: Face index out of range\n");
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void __IMMergeFree(__IMMerge_t* pMerge) {
+    free(pMerge->pPositions);
+    free(pMerge->pUVs);
+    free(pMerge->pNormals);
+    free(pMerge->pKeys);
+
+    pMerge->pPositions = nullptr;
+    pMerge->pUVs = nullptr;
+    pMerge->pNormals = nullptr;
+    pMerge->pKeys = nullptr;
+}
+
+/**
+ * @brief Shared state of interleaving threads
+ */
+typedef struct __IMInterleave_s {
+    const __IMMerge_t* pMerge;
+    // Unique (position, uv, normal) keys, nullptr when vertex i uses attributes i
+    const uint32_t* pKeys;
+    uint8_t* pVertices;
+    uint32_t mStride;
+    bool mNormals, mUVs;
+} __IMInterleave_t;
+
+void __IMInterleaveVertices(uint32_t begin, uint32_t end, void* pData) {
+    __IMInterleave_t* pContext = (__IMInterleave_t*)pData;
+    const __IMMerge_t* pMerge = pContext->pMerge;
+
+    for(uint32_t i = begin; i < end; i++) {
+        uint32_t key[3] = {i, pContext->mUVs ? i : ~0u, pContext->mNormals ? i : ~0u};
+
+        if(pContext->pKeys) {
+            memcpy(key, &pContext->pKeys[(uint64_t)i * 3], sizeof(key));
+        }
+
+        float* pVertex = (float*)(pContext->pVertices + (uint64_t)i * pContext->mStride);
+        float* pAttribute = pVertex + 3;
+
+        memcpy(pVertex, &pMerge->pPositions[(uint64_t)key[0] * 3], 3 * sizeof(float));
+
+        if(pContext->mNormals) {
+            if(key[2] != ~0u) {
+                memcpy(pAttribute, &pMerge->pNormals[(uint64_t)key[2] * 3], 3 * sizeof(float));
+            }
+            else {
+                memset(pAttribute, 0, 3 * sizeof(float));
+            }
+
+            pAttribute += 3;
+        }
+
+        if(pContext->mUVs) {
+            if(key[1] != ~0u) {
+                memcpy(pAttribute, &pMerge->pUVs[(uint64_t)key[1] * 2], 2 * sizeof(float));
+            }
+            else {
+                memset(pAttribute, 0, 2 * sizeof(float));
+            }
+        }
+    }
+}
+
+/**
+ * @brief Interleaved layout, position at location 0, normal at location 1 and uv at location 2 when mesh has them
+ *
+ * @param normals
+ * @param uvs
+ * @return MeshDesc_t
+ */
+MeshDesc_t __IMDesc(bool normals, bool uvs) {
+    MeshDesc_t desc = MRDescPositions(0);
+
+    if(normals) {
+        desc.mAttributes[desc.mAttributeCount++] = (MeshAttribute_t){.mLocation = 1, .mComponents = 3, .mType = GL_FLOAT, .mNormalized = false, .mOffset = desc.mStride};
+        desc.mStride += 3 * sizeof(float);
+    }
+
+    if(uvs) {
+        desc.mAttributes[desc.mAttributeCount++] = (MeshAttribute_t){.mLocation = 2, .mComponents = 2, .mType = GL_FLOAT, .mNormalized = false, .mOffset = desc.mStride};
+        desc.mStride += 2 * sizeof(float);
+    }
+
+    return desc;
+}
+
+/**
+ * @brief Build interleaved vertices in parallel and hand them with indices to MIFinish
+ *
+ * @param pMerge
+ * @param pKeys unique keys, nullptr to use merged attributes as they are
+ * @param vertexCount
+ * @param pIndices malloc`d, ownership goes to mesh
+ * @param indexCount
+ * @param pMesh
+ * @param pStats
+ * @param pThreads
+ * @return true
+ * @return false out of memory
+ */
+bool __IMBuild(const __IMMerge_t* pMerge, const uint32_t* pKeys, uint32_t vertexCount, uint32_t* pIndices, uint32_t indexCount, IndexedMesh_t* pMesh, float* pStats, uint32_t* pThreads) {
+    const uint64_t* pTotal = pMerge->mBase[IM_MAX_CHUNKS];
+    MeshDesc_t desc = __IMDesc(pTotal[2] > 0, pTotal[1] > 0);
+
+    __IMInterleave_t context = {
+        .pMerge = pMerge,
+        .pKeys = pKeys,
+        .pVertices = (uint8_t*)malloc((uint64_t)vertexCount * desc.mStride),
+        .mStride = desc.mStride,
+        .mNormals = pTotal[2] > 0,
+        .mUVs = pTotal[1] > 0
+    };
+
+    if(!context.pVertices) {
+        printf("[INFO]: Not enough memory to import mesh\n");
+        free(pIndices);
+
+        return false;
+    }
+
+    uint32_t threads = UTParallelFor(vertexCount, 4096, __IMInterleaveVertices, &context);
+    *pThreads = threads > *pThreads ? threads : *pThreads;
+
+    MIFinish(pMesh, context.pVertices, vertexCount, pIndices, indexCount, &desc, pStats);
+
+    return true;
+}
+
+/**
+ * @brief Parse OBJ in parallel chunks, weld (position, uv, normal) corners into vertices
+ *
+ * @param pFile
+ * @param pMesh
+ * @param pStats
+ * @param pThreads
+ * @return true
+ * @return false
+ */
+bool __IMLoadObj(const UTMappedFile_t* pFile, IndexedMesh_t* pMesh, float* pStats, uint32_t* pThreads) {
+    __IMChunk_t* pChunks = (__IMChunk_t*)malloc(IM_MAX_CHUNKS * sizeof(__IMChunk_t));
+    __IMMerge_t* pMerge = (__IMMerge_t*)calloc(1, sizeof(__IMMerge_t));
+
+    if(!pChunks || !pMerge) {
+        free(pChunks);
+        free(pMerge);
+
+        return false;
+    }
+
+    const char* pText = (const char*)pFile->pData;
+    uint32_t count = __IMSplit(pText, pText + pFile->mLength, pChunks, IM_MAX_CHUNKS);
+
+    *pThreads = UTParallelFor(count, 1, __IMObjChunks, pChunks);
+
+    bool result = true;
+
+    for(uint32_t i = 0; i < count; i++) {
+        if(pChunks[i].mError) {
+            printf("[INFO]: Bad OBJ line or not enough memory\n");
+            result = false;
+
+            break;
+        }
+    }
+
+    result = result && __IMMerge(pChunks, count, pMerge, pThreads);
+
+    for(uint32_t i = 0; i < count; i++) {
+        __IMChunkFree(&pChunks[i]);
+    }
+
+    uint32_t corners = (uint32_t)pMerge->mBase[IM_MAX_CHUNKS][3];
+
+    if(result && corners == 0) {
+        printf("[INFO]: OBJ has no faces\n");
+        result = false;
+    }
+
+    if(result) {
+        uint32_t* pUnique = (uint32_t*)malloc((uint64_t)corners * 3 * sizeof(uint32_t));
+        uint32_t* pIndices = (uint32_t*)malloc((uint64_t)corners * sizeof(uint32_t));
+        uint32_t unique = pUnique && pIndices ? MIWeld(pMerge->pKeys, corners, 3 * sizeof(uint32_t), pUnique, pIndices) : 0;
+
+        if(unique == 0) {
+            printf("[INFO]: Not enough memory to import mesh\n");
+            free(pIndices);
+            result = false;
+        }
+        else {
+            result = __IMBuild(pMerge, pUnique, unique, pIndices, corners, pMesh, pStats, pThreads);
+        }
+
+        free(pUnique);
+    }
+
+    __IMMergeFree(pMerge);
+    free(pMerge);
+    free(pChunks);
+
+    return result;
+}
+
+enum IMPlyType {
+    IMPlyInt8,
+    IMPlyUInt8,
+    IMPlyInt16,
+    IMPlyUInt16,
+    IMPlyInt32,
+    IMPlyUInt32,
+    IMPlyFloat32,
+    IMPlyFloat64
+};
+
+/**
+ * @brief What property feeds, position, normal and uv components in vertex element, indices in face element
+ */
+enum IMPlyTarget {
+    IMPlyIgnored = -1,
+    IMPlyX,
+    IMPlyY,
+    IMPlyZ,
+    IMPlyNX,
+    IMPlyNY,
+    IMPlyNZ,
+    IMPlyU,
+    IMPlyV,
+    IMPlyIndices
+};
+
+typedef struct __IMPlyProperty_s {
+    int mType;
+    // Type of list length, -1 for scalar property
+    int mCountType;
+    int mTarget;
+    // Byte offset in fixed size binary element
+    uint32_t mOffset;
+} __IMPlyProperty_t;
+
+typedef struct __IMPlyElement_s {
+    char mName[64];
+    uint64_t mCount;
+    __IMPlyProperty_t mProperties[IM_PLY_MAX_PROPERTIES];
+    uint32_t mPropertyCount;
+    // Bytes of binary element, 0 when it has lists
+    uint32_t mStride;
+} __IMPlyElement_t;
+
+typedef struct __IMPlyContext_s {
+    const __IMPlyElement_t* pElement;
+    __IMChunk_t* pChunks;
+    bool mBinary;
+    // File byte order differs from host
+    bool mSwap;
+    bool mNormals, mUVs;
+} __IMPlyContext_t;
+
+uint32_t __IMPlySize(int type) {
+    const uint32_t sizes[] = {1, 1, 2, 2, 4, 4, 4, 8};
+
+    return sizes[type];
+}
+
+/**
+ * @brief Type from PLY type name, both old (uchar) and new (uint8) names
+ *
+ * @param name
+ * @return int IMPlyType, -1 unknown
+ */
+int __IMPlyParseType(const char* name) {
+    const char* names[][2] = {{"char", "int8"}, {"uchar", "uint8"}, {"short", "int16"}, {"ushort", "uint16"}, {"int", "int32"}, {"uint", "uint32"}, {"float", "float32"}, {"double", "float64"}};
+
+    for(int i = 0; i < 8; i++) {
+        if(strcmp(name, names[i][0]) == 0 || strcmp(name, names[i][1]) == 0) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+int __IMPlyParseTarget(const char* element, const char* name) {
+    if(strcmp(element, "vertex") == 0) {
+        const char* names[][4] = {{"x"}, {"y"}, {"z"}, {"nx"}, {"ny"}, {"nz"}, {"u", "s", "texture_u", "texture_s"}, {"v", "t", "texture_v", "texture_t"}};
+
+        for(int i = 0; i < 8; i++) {
+            for(int j = 0; j < 4 && names[i][j]; j++) {
+                if(strcmp(name, names[i][j]) == 0) {
+                    return i;
+                }
+            }
+        }
+    }
+    else if(strcmp(element, "face") == 0 && (strcmp(name, "vertex_indices") == 0 || strcmp(name, "vertex_index") == 0)) {
+        return IMPlyIndices;
+    }
+
+    return IMPlyIgnored;
+}
+
+/**
+ * @brief Read binary value
+ *
+ * @param p
+ * @param type
+ * @param swap
+ * @return double
+ */
+double __IMPlyRead(const uint8_t* p, int type, bool swap) {
+    uint8_t bytes[8];
+    uint32_t size = __IMPlySize(type);
+
+    for(uint32_t i = 0; i < size; i++) {
+        bytes[i] = swap ? p[size - 1 - i] : p[i];
+    }
+
+    switch(type) {
+        case IMPlyInt8: { int8_t v; memcpy(&v, bytes, 1); return v; }
+        case IMPlyUInt8: { uint8_t v; memcpy(&v, bytes, 1); return v; }
+        case IMPlyInt16: { int16_t v; memcpy(&v, bytes, 2); return v; }
+        case IMPlyUInt16: { uint16_t v; memcpy(&v, bytes, 2); return v; }
+        case IMPlyInt32: { int32_t v; memcpy(&v, bytes, 4); return v; }
+        case IMPlyUInt32: { uint32_t v; memcpy(&v, bytes, 4); return v; }
+        case IMPlyFloat32: { float v; memcpy(&v, bytes, 4); return v; }
+        default: { double v; memcpy(&v, bytes, 8); return v; }
+    }
+}
+
+/**
+ * @brief Parse header
+ *
+ * @param pFile
+ * @param pElements
+ * @param pElementCount
+ * @param pBinary
+ * @param pSwap
+ * @return const char* first byte after header, nullptr when header is bad
+ */
+const char* __IMPlyParseHeader(const UTMappedFile_t* pFile, __IMPlyElement_t* pElements, uint32_t* pElementCount, bool* pBinary, bool* pSwap) {
+    const char* p = (const char*)pFile->pData;
+    const char* pEnd = p + pFile->mLength;
+    const uint16_t probe = 1;
+    bool hostLittle = *(const uint8_t*)&probe == 1;
+    bool format = false;
+
+    *pElementCount = 0;
+
+    while(p < pEnd) {
+        const char* pLine = (const char*)memchr(p, '\n', pEnd - p);
+
+        if(!pLine) {
+            return nullptr;
+        }
+
+        char line[256], keyword[64] = {0}, a[64] = {0}, b[64] = {0}, c[64] = {0}, d[64] = {0};
+        uint64_t length = pLine - p < (int64_t)sizeof(line) - 1 ? (uint64_t)(pLine - p) : sizeof(line) - 1;
+
+        memcpy(line, p, length);
+        line[length] = 0;
+        p = pLine + 1;
+
+        int read = sscanf(line, "%63s %63s %63s %63s %63s", keyword, a, b, c, d);
+
+        if(read <= 0 || strcmp(keyword, "ply") == 0 || strcmp(keyword, "comment") == 0 || strcmp(keyword, "obj_info") == 0) {
+            continue;
+        }
+
+        if(strcmp(keyword, "end_header") == 0) {
+            return format ? p : nullptr;
+        }
+
+        if(strcmp(keyword, "format") == 0 && read >= 2) {
+            format = true;
+            *pBinary = strcmp(a, "ascii") != 0;
+            *pSwap = *pBinary && (strcmp(a, "binary_little_endian") == 0) != hostLittle;
+
+            if(*pBinary && strcmp(a, "binary_little_endian") != 0 && strcmp(a, "binary_big_endian") != 0) {
+                return nullptr;
+            }
+        }
+        else if(strcmp(keyword, "element") == 0 && read >= 3 && *pElementCount < IM_PLY_MAX_ELEMENTS) {
+            __IMPlyElement_t* pElement = &pElements[(*pElementCount)++];
+
+            memset(pElement, 0, sizeof(__IMPlyElement_t));
+            snprintf(pElement->mName, sizeof(pElement->mName), "%s", a);
+            pElement->mCount = strtoull(b, nullptr, 10);
+        }
+        else if(strcmp(keyword, "property") == 0 && *pElementCount > 0) {
+            __IMPlyElement_t* pElement = &pElements[*pElementCount - 1];
+
+            if(pElement->mPropertyCount >= IM_PLY_MAX_PROPERTIES) {
+                return nullptr;
+            }
+
+            __IMPlyProperty_t* pProperty = &pElement->mProperties[pElement->mPropertyCount++];
+            bool list = strcmp(a, "list") == 0;
+
+            pProperty->mCountType = list ? __IMPlyParseType(b) : -1;
+            pProperty->mType = __IMPlyParseType(list ? c : a);
+            pProperty->mTarget = __IMPlyParseTarget(pElement->mName, list ? d : b);
+
+            if(pProperty->mType < 0 || (list && pProperty->mCountType < 0)) {
+                return nullptr;
+            }
+        }
+        else {
+            return nullptr;
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief Fan triangulation of one polygon, corners keep only position
+ *
+ * @param pChunk
+ * @param pFan first and previous index, updated
+ * @param position index of polygon
+ * @param index
+ * @return true
+ * @return false out of memory or bad index
+ */
+bool __IMPlyCorner(__IMChunk_t* pChunk, int32_t* pFan, uint32_t position, double index) {
+    if(index < 0.0 || index >= (double)INT32_MAX) {
+        return false;
+    }
+
+    int32_t corner[3] = {(int32_t)index, IM_MISSING, IM_MISSING};
+    const uint8_t relative[3] = {0, 0, 0};
+
+    if(position >= 2) {
+        int32_t first[3] = {pFan[0], IM_MISSING, IM_MISSING};
+        int32_t previous[3] = {pFan[1], IM_MISSING, IM_MISSING};
+
+        if(!__IMPushTriangle(pChunk, first, previous, corner, relative)) {
+            return false;
+        }
+    }
+
+    pFan[position == 0 ? 0 : 1] = corner[0];
+
+    return true;
+}
+
+/**
+ * @brief Store vertex attributes gathered by target
+ *
+ * @param pContext
+ * @param pChunk
+ * @param pValues x, y, z, nx, ny, nz, u, v
+ * @return true
+ * @return false out of memory
+ */
+bool __IMPlyVertex(const __IMPlyContext_t* pContext, __IMChunk_t* pChunk, const float* pValues) {
+    float* pPosition = (float*)__IMArrayPush(&pChunk->mPositions, 1);
+
+    if(!pPosition) {
+        return false;
+    }
+
+    memcpy(pPosition, &pValues[IMPlyX], 3 * sizeof(float));
+
+    if(pContext->mNormals) {
+        float* pNormal = (float*)__IMArrayPush(&pChunk->mNormals, 1);
+
+        if(!pNormal) {
+            return false;
+        }
+
+        memcpy(pNormal, &pValues[IMPlyNX], 3 * sizeof(float));
+    }
+
+    if(pContext->mUVs) {
+        float* pUV = (float*)__IMArrayPush(&pChunk->mUVs, 1);
+
+        if(!pUV) {
+            return false;
+        }
+
+        memcpy(pUV, &pValues[IMPlyU], 2 * sizeof(float));
+    }
+
+    return true;
+}
+
+/**
+ * @brief Parse element records of chunk, text lines or fixed size binary records
+ *
+ * @param pContext
+ * @param pChunk
+ */
+void __IMPlyParse(const __IMPlyContext_t* pContext, __IMChunk_t* pChunk) {
+    const __IMPlyElement_t* pElement = pContext->pElement;
+    bool vertex = strcmp(pElement->mName, "vertex") == 0;
+    const char* p = pChunk->pBegin;
+
+    while(p < pChunk->pEnd && !pChunk->mError) {
+        float values[8] = {0};
+        const char* pLineEnd = pChunk->pEnd;
+
+        if(pContext->mBinary) {
+            // Only fixed size vertex records are split into chunks
+            for(uint32_t i = 0; i < pElement->mPropertyCount; i++) {
+                const __IMPlyProperty_t* pProperty = &pElement->mProperties[i];
+
+                if(pProperty->mTarget >= IMPlyX && pProperty->mTarget <= IMPlyV) {
+                    values[pProperty->mTarget] = (float)__IMPlyRead((const uint8_t*)p + pProperty->mOffset, pProperty->mType, pContext->mSwap);
+                }
+            }
+
+            p += pElement->mStride;
+        }
+        else {
+            const char* pLine = (const char*)memchr(p, '\n', pChunk->pEnd - p);
+            pLineEnd = pLine ? pLine : pChunk->pEnd;
+
+            for(uint32_t i = 0; i < pElement->mPropertyCount && !pChunk->mError; i++) {
+                const __IMPlyProperty_t* pProperty = &pElement->mProperties[i];
+                float value = 0.0f;
+
+                if(pProperty->mCountType >= 0) {
+                    // Counts and indices are integers, float would round indices above 2^24
+                    int64_t count = 0;
+                    int32_t fan[2] = {0, 0};
+
+                    pChunk->mError = !__IMParseInt(&p, pLineEnd, &count) || count < 0;
+
+                    for(int64_t j = 0; j < count && !pChunk->mError; j++) {
+                        if(pProperty->mTarget == IMPlyIndices) {
+                            int64_t index = 0;
+
+                            pChunk->mError = !__IMParseInt(&p, pLineEnd, &index) || !__IMPlyCorner(pChunk, fan, (uint32_t)j, (double)index);
+                        }
+                        else {
+                            pChunk->mError = !__IMParseFloat(&p, pLineEnd, &value);
+                        }
+                    }
+                }
+                else {
+                    pChunk->mError = !__IMParseFloat(&p, pLineEnd, &value);
+
+                    if(pProperty->mTarget >= IMPlyX && pProperty->mTarget <= IMPlyV) {
+                        values[pProperty->mTarget] = value;
+                    }
+                }
+            }
+
+            p = pLine ? pLine + 1 : pChunk->pEnd;
+        }
+
+        if(vertex && !pChunk->mError) {
+            pChunk->mError = !__IMPlyVertex(pContext, pChunk, values);
+        }
+    }
+}
+
+void __IMPlyChunks(uint32_t begin, uint32_t end, void* pData) {
+    __IMPlyContext_t* pContext = (__IMPlyContext_t*)pData;
+
+    for(uint32_t i = begin; i < end; i++) {
+        __IMPlyParse(pContext, &pContext->pChunks[i]);
+    }
+}
+
+/**
+ * @brief Walk binary element with lists, faces go to chunk and other elements are skipped
+ *
+ * @param pContext
+ * @param pChunk
+ * @param p
+ * @param pEnd
+ * @return const char* after element, nullptr when file is truncated or out of memory
+ */
+const char* __IMPlyBinaryElement(const __IMPlyContext_t* pContext, __IMChunk_t* pChunk, const char* p, const char* pEnd) {
+    const __IMPlyElement_t* pElement = pContext->pElement;
+
+    for(uint64_t f = 0; f < pElement->mCount; f++) {
+        for(uint32_t i = 0; i < pElement->mPropertyCount; i++) {
+            const __IMPlyProperty_t* pProperty = &pElement->mProperties[i];
+            uint32_t size = __IMPlySize(pProperty->mType);
+
+            if(pProperty->mCountType < 0) {
+                if((uint64_t)(pEnd - p) < size) {
+                    return nullptr;
+                }
+
+                p += size;
+
+                continue;
+            }
+
+            uint32_t countSize = __IMPlySize(pProperty->mCountType);
+
+            if((uint64_t)(pEnd - p) < countSize) {
+                return nullptr;
+            }
+
+            double count = __IMPlyRead((const uint8_t*)p, pProperty->mCountType, pContext->mSwap);
+            p += countSize;
+
+            if(count < 0.0 || (double)(pEnd - p) < count * size) {
+                return nullptr;
+            }
+
+            if(pProperty->mTarget == IMPlyIndices) {
+                int32_t fan[2] = {0, 0};
+
+                for(uint32_t j = 0; j < (uint32_t)count; j++) {
+                    if(!__IMPlyCorner(pChunk, fan, j, __IMPlyRead((const uint8_t*)p + j * size, pProperty->mType, pContext->mSwap))) {
+                        return nullptr;
+                    }
+                }
+            }
+
+            p += (uint64_t)count * size;
+        }
+    }
+
+    return p;
+}
+
+/**
+ * @brief Parse PLY, vertex records and ASCII faces in parallel chunks, binary faces in one pass
+ *
+ * @param pFile
+ * @param pMesh
+ * @param pStats
+ * @param pThreads
+ * @return true
+ * @return false
+ */
+bool __IMLoadPly(const UTMappedFile_t* pFile, IndexedMesh_t* pMesh, float* pStats, uint32_t* pThreads) {
+    __IMPlyElement_t elements[IM_PLY_MAX_ELEMENTS];
+    uint32_t elementCount = 0;
+    bool binary = false, swap = false;
+
+    const char* p = __IMPlyParseHeader(pFile, elements, &elementCount, &binary, &swap);
+    const char* pEnd = (const char*)pFile->pData + pFile->mLength;
+
+    if(!p) {
+        printf("[INFO]: Bad PLY header\n");
+
+        return false;
+    }
+
+    __IMChunk_t* pChunks = (__IMChunk_t*)malloc(IM_MAX_CHUNKS * sizeof(__IMChunk_t));
+    __IMMerge_t* pMerge = (__IMMerge_t*)calloc(1, sizeof(__IMMerge_t));
+
+    if(!pChunks || !pMerge) {
+        free(pChunks);
+        free(pMerge);
+
+        return false;
+    }
+
+    uint32_t count = 0;
+    bool result = true;
+
+    // Every face element needs at least one chunk, vertices split into the rest
+    uint32_t faceElements = 0;
+
+    for(uint32_t e = 0; e < elementCount; e++) {
+        faceElements += strcmp(elements[e].mName, "face") == 0;
+    }
+
+    for(uint32_t e = 0; e < elementCount && result; e++) {
+        __IMPlyElement_t* pElement = &elements[e];
+        __IMPlyContext_t context = {.pElement = pElement, .pChunks = &pChunks[count], .mBinary = binary, .mSwap = swap};
+        bool face = strcmp(pElement->mName, "face") == 0;
+        bool parsed = strcmp(pElement->mName, "vertex") == 0 || face;
+        const char* pBlockEnd = nullptr;
+
+        faceElements -= face;
+
+        uint32_t available = IM_MAX_CHUNKS - count > faceElements ? IM_MAX_CHUNKS - count - faceElements : 0;
+
+        if(parsed && !available) {
+            printf("[INFO]: PLY has too many elements, no chunk left for %s\n", pElement->mName);
+            result = false;
+
+            break;
+        }
+
+        bool fixed = true;
+
+        for(uint32_t i = 0; i < pElement->mPropertyCount; i++) {
+            __IMPlyProperty_t* pProperty = &pElement->mProperties[i];
+
+            context.mNormals |= pProperty->mTarget >= IMPlyNX && pProperty->mTarget <= IMPlyNZ;
+            context.mUVs |= pProperty->mTarget == IMPlyU || pProperty->mTarget == IMPlyV;
+
+            pProperty->mOffset = pElement->mStride;
+            pElement->mStride += __IMPlySize(pProperty->mType);
+            fixed = fixed && pProperty->mCountType < 0;
+        }
+
+        // Records with lists have no fixed size
+        pElement->mStride = fixed ? pElement->mStride : 0;
+
+        if(!binary) {
+            pBlockEnd = __IMSkipLines(p, pEnd, pElement->mCount);
+        }
+        else if(pElement->mStride) {
+            pBlockEnd = (uint64_t)(pEnd - p) / pElement->mStride >= pElement->mCount ? p + pElement->mCount * pElement->mStride : nullptr;
+        }
+        else if(strcmp(pElement->mName, "vertex") == 0) {
+            printf("[INFO]: PLY vertex lists are not supported\n");
+            result = false;
+
+            break;
+        }
+        else {
+            // Lists have variable size so records can`t be found without walking them, faces are parsed in one pass
+            if(parsed) {
+                __IMChunkInit(&pChunks[count], p, p);
+            }
+
+            pBlockEnd = __IMPlyBinaryElement(&context, parsed ? &pChunks[count++] : nullptr, p, pEnd);
+            parsed = false;
+        }
+
+        if(!pBlockEnd) {
+            printf("[INFO]: PLY %s is truncated or not enough memory\n", pElement->mName);
+            result = false;
+
+            break;
+        }
+
+        if(parsed) {
+            uint32_t used = 0;
+
+            if(binary) {
+                // Fixed size records split at record boundaries
+                uint64_t records = pElement->mCount;
+                uint64_t perChunk = IM_MIN_CHUNK_BYTES / pElement->mStride + 1;
+
+                used = UTCoreCount() * IM_CHUNKS_PER_CORE;
+                used = used > available ? available : used;
+                used = records / perChunk + 1 < used ? (uint32_t)(records / perChunk + 1) : used;
+
+                for(uint32_t i = 0; i < used; i++) {
+                    __IMChunkInit(&pChunks[count + i], p + records * i / used * pElement->mStride, p + records * (i + 1) / used * pElement->mStride);
+                }
+            }
+            else {
+                used = __IMSplit(p, pBlockEnd, &pChunks[count], available);
+            }
+
+            uint32_t threads = UTParallelFor(used, 1, __IMPlyChunks, &context);
+            *pThreads = threads > *pThreads ? threads : *pThreads;
+
+            for(uint32_t i = 0; i < used; i++) {
+                result = result && !pChunks[count + i].mError;
+            }
+
+            count += used;
+
+            if(!result) {
+                printf("[INFO]: Bad PLY %s or not enough memory\n", pElement->mName);
+            }
+        }
+
+        p = pBlockEnd;
+    }
+
+    result = result && __IMMerge(pChunks, count, pMerge, pThreads);
+
+    for(uint32_t i = 0; i < count; i++) {
+        __IMChunkFree(&pChunks[i]);
+    }
+
+    uint64_t vertices = pMerge->mBase[IM_MAX_CHUNKS][0];
+    uint64_t corners = pMerge->mBase[IM_MAX_CHUNKS][3];
+
+    if(result && corners == 0) {
+        printf("[INFO]: PLY has no faces\n");
+        result = false;
+    }
+
+    if(result) {
+        // PLY vertices are unique already, corners only keep position index
+        uint32_t* pIndices = (uint32_t*)malloc(corners * sizeof(uint32_t));
+
+        if(pIndices) {
+            for(uint64_t c = 0; c < corners; c++) {
+                pIndices[c] = pMerge->pKeys[c * 3];
+            }
+
+            result = __IMBuild(pMerge, nullptr, (uint32_t)vertices, pIndices, (uint32_t)corners, pMesh, pStats, pThreads);
+        }
+        else {
+            result = false;
+        }
+    }
+
+    __IMMergeFree(pMerge);
+    free(pMerge);
+    free(pChunks);
+
+    return result;
+}
+
+/**
+ * @brief Import Wavefront OBJ or PLY (ASCII, binary little or big endian), file is memory mapped and parsed in parallel
+ *
+ * @param path
+ * @param pMesh output, free with MIFree
+ * @return true
+ * @return false
+ */
+bool IMLoad(const char* path, IndexedMesh_t* pMesh) {
+    memset(pMesh, 0, sizeof(IndexedMesh_t));
+
+    double start = UTGetTimeMs();
+    UTMappedFile_t file;
+
+    if(!UTMapFile(path, &file)) {
+        printf("[INFO]: Cannot open mesh <%s>\n", path);
+
+        return false;
+    }
+
+    float stats[4] = {0};
+    uint32_t threads = 1;
+    bool ply = file.mLength >= 4 && memcmp(file.pData, "ply", 3) == 0 && (file.pData[3] == '\n' || file.pData[3] == '\r');
+    bool result = ply ? __IMLoadPly(&file, pMesh, stats, &threads) : __IMLoadObj(&file, pMesh, stats, &threads);
+
+    UTUnmapFile(&file);
+
+    if(!result) {
+        printf("[INFO]: Cannot import mesh <%s>\n", path);
+        MIFree(pMesh);
+
+        return false;
+    }
+
+    printf("[INFO]: Imported %s: %u vertices, %u triangles%s%s, %s indices in %.2f ms on %u threads\n", path, pMesh->mDesc.mVertexCount, pMesh->mDesc.mIndexCount / 3, pMesh->mDesc.mAttributeCount > 1 && pMesh->mDesc.mAttributes[1].mLocation == 1 ? ", normals" : "", pMesh->mDesc.mAttributes[pMesh->mDesc.mAttributeCount - 1].mLocation == 2 ? ", uvs" : "", pMesh->mDesc.mIndexType == GL_UNSIGNED_SHORT ? "16-bit" : "32-bit", UTGetTimeMs() - start, threads);
+    printf("[INFO]:     ACMR %.3f -> %.3f, ATVR %.3f -> %.3f (FIFO %u)\n", stats[0], stats[2], stats[1], stats[3], MI_FIFO_SIZE);
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,400 @@
+#ifndef __MESH_INDEX_
+#define __MESH_INDEX_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include <glad/gl.h>
+
+#include "utils.h"
+#include "meshregistry.h"
+
+// Cache modeled by Forsyth optimizer
+#define MI_CACHE_SIZE 32
+// FIFO post-transform cache used for ACMR/ATVR, conservative size of real hardware
+#define MI_FIFO_SIZE 16
+
+/**
+ * @brief Mesh after welding, owns its vertices and indices
+ */
+typedef struct IndexedMesh_s {
+    void* pVertices;
+    void* pIndices;
+    MeshDesc_t mDesc;
+} IndexedMesh_t;
+
+/**
+ * @brief Weld byte identical vertices with open addressing hash map
+ *
+ * @param pVertices
+ * @param vertexCount
+ * @param stride
+ * @param pUnique output, room for vertexCount vertices
+ * @param pIndices output, vertexCount indices
+ * @return uint32_t unique vertex count
+ */
+uint32_t MIWeld(const void* pVertices, uint32_t vertexCount, uint32_t stride, void* pUnique, uint32_t* pIndices) {
+    uint32_t tableSize = 1;
+
+    while(tableSize < vertexCount * 2) {
+        tableSize <<= 1;
+    }
+
+    uint32_t* pTable = (uint32_t*)malloc(tableSize * sizeof(uint32_t));
+
+    if(!pTable) {
+        return 0;
+    }
+
+    memset(pTable, 0xFF, tableSize * sizeof(uint32_t));
+
+    const uint8_t* pSource = (const uint8_t*)pVertices;
+    uint8_t* pDestination = (uint8_t*)pUnique;
+    uint32_t unique = 0;
+
+    for(uint32_t i = 0; i < vertexCount; i++) {
+        const uint8_t* pVertex = pSource + (uint64_t)i * stride;
+        uint32_t slot = UTHash(pVertex, stride, UT_HASH_SEED) & (tableSize - 1);
+
+        // Linear probing until same vertex or empty slot
+        while(pTable[slot] != ~0u && memcmp(pDestination + (uint64_t)pTable[slot] * stride, pVertex, stride) != 0) {
+            slot = (slot + 1) & (tableSize - 1);
+        }
+
+        if(pTable[slot] == ~0u) {
+            memcpy(pDestination + (uint64_t)unique * stride, pVertex, stride);
+            pTable[slot] = unique++;
+        }
+
+        pIndices[i] = pTable[slot];
+    }
+
+    free(pTable);
+
+    return unique;
+}
+
+/**
+ * @brief Simulate FIFO post-transform cache
+ *
+ * @param pIndices
+ * @param indexCount
+ * @param vertexCount
+ * @param pAcmr average cache miss ratio, transformed vertices per triangle (0.5 - 3.0)
+ * @param pAtvr average transformed vertex ratio, transformed vertices per unique vertex (1.0 is ideal)
+ */
+void MICacheStats(const uint32_t* pIndices, uint32_t indexCount, uint32_t vertexCount, float* pAcmr, float* pAtvr) {
+    // Miss counter when vertex entered cache, 0 never
+    uint32_t* pStamps = (uint32_t*)calloc(vertexCount ? vertexCount : 1, sizeof(uint32_t));
+    uint32_t misses = 0;
+
+    if(!pStamps) {
+        return;
+    }
+
+    for(uint32_t i = 0; i < indexCount; i++) {
+        uint32_t v = pIndices[i];
+
+        if(pStamps[v] == 0 || misses - pStamps[v] >= MI_FIFO_SIZE) {
+            misses++;
+            pStamps[v] = misses;
+        }
+    }
+
+    free(pStamps);
+
+    *pAcmr = indexCount ? (float)misses / (indexCount / 3) : 0.0f;
+    *pAtvr = vertexCount ? (float)misses / vertexCount : 0.0f;
+}
+
+/**
+ * @brief Forsyth vertex score, higher is better to draw now
+ *
+ * @param cachePosition -1 when not in cache
+ * @param remaining triangles not drawn yet which use vertex
+ * @return float
+ */
+float __MIVertexScore(int32_t cachePosition, uint32_t remaining) {
+    if(remaining == 0) {
+        return -1.0f;
+    }
+
+    float score = 0.0f;
+
+    if(cachePosition >= 0) {
+        // Vertices of last triangle get fixed score so next triangle doesn`t just reuse its edge
+        if(cachePosition < 3) {
+            score = 0.75f;
+        }
+        else {
+            score = powf(1.0f - (float)(cachePosition - 3) / (MI_CACHE_SIZE - 3), 1.5f);
+        }
+    }
+
+    // Boost vertices with few triangles left so they are finished and don`t leave lonely triangles behind
+    return score + 2.0f / sqrtf((float)remaining);
+}
+
+/**
+ * @brief Reorder triangles for post-transform cache (Tom Forsyth, Linear-Speed Vertex Cache Optimisation)
+ *
+ * @param pIndices triangle list, reordered in place
+ * @param indexCount
+ * @param vertexCount
+ * @return true
+ * @return false out of memory, indices are untouched
+ */
+bool MIOptimize(uint32_t* pIndices, uint32_t indexCount, uint32_t vertexCount) {
+    uint32_t triangleCount = indexCount / 3;
+
+    uint32_t* pOffsets = (uint32_t*)calloc(vertexCount + 1, sizeof(uint32_t));
+    uint32_t* pRemaining = (uint32_t*)calloc(vertexCount + 1, sizeof(uint32_t));
+    uint32_t* pAdjacency = (uint32_t*)malloc((indexCount + 1) * sizeof(uint32_t));
+    int32_t* pCachePositions = (int32_t*)malloc((vertexCount + 1) * sizeof(int32_t));
+    float* pVertexScores = (float*)malloc((vertexCount + 1) * sizeof(float));
+    float* pTriangleScores = (float*)malloc((triangleCount + 1) * sizeof(float));
+    bool* pAdded = (bool*)calloc(triangleCount + 1, sizeof(bool));
+    uint32_t* pOutput = (uint32_t*)malloc((indexCount + 1) * sizeof(uint32_t));
+
+    bool result = pOffsets && pRemaining && pAdjacency && pCachePositions && pVertexScores && pTriangleScores && pAdded && pOutput;
+
+    if(result) {
+        // Triangles of every vertex
+        for(uint32_t i = 0; i < triangleCount * 3; i++) {
+            pRemaining[pIndices[i]]++;
+        }
+
+        for(uint32_t v = 0; v < vertexCount; v++) {
+            pOffsets[v + 1] = pOffsets[v] + pRemaining[v];
+            pRemaining[v] = 0;
+        }
+
+        for(uint32_t i = 0; i < triangleCount * 3; i++) {
+            uint32_t v = pIndices[i];
+
+            pAdjacency[pOffsets[v] + pRemaining[v]++] = i / 3;
+        }
+
+        for(uint32_t v = 0; v < vertexCount; v++) {
+            pCachePositions[v] = -1;
+            pVertexScores[v] = __MIVertexScore(-1, pRemaining[v]);
+        }
+
+        int64_t best = -1;
+        float bestScore = -1.0f;
+
+        for(uint32_t t = 0; t < triangleCount; t++) {
+            pTriangleScores[t] = pVertexScores[pIndices[t * 3]] + pVertexScores[pIndices[t * 3 + 1]] + pVertexScores[pIndices[t * 3 + 2]];
+
+            if(pTriangleScores[t] > bestScore) {
+                bestScore = pTriangleScores[t];
+                best = t;
+            }
+        }
+
+        uint32_t cache[MI_CACHE_SIZE + 3];
+        uint32_t cacheCount = 0;
+        uint32_t cursor = 0;
+
+        for(uint32_t out = 0; out < triangleCount; out++) {
+            // Dead end, nothing in cache touches remaining triangles, continue with next one in input order
+            if(best < 0) {
+                while(pAdded[cursor]) {
+                    cursor++;
+                }
+
+                best = cursor;
+            }
+
+            const uint32_t* pTriangle = &pIndices[best * 3];
+
+            pAdded[best] = true;
+            memcpy(&pOutput[out * 3], pTriangle, 3 * sizeof(uint32_t));
+
+            // Drop triangle from adjacency of its vertices
+            for(uint32_t k = 0; k < 3; k++) {
+                uint32_t v = pTriangle[k];
+                uint32_t* pList = &pAdjacency[pOffsets[v]];
+
+                for(uint32_t j = 0; j < pRemaining[v]; j++) {
+                    if(pList[j] == best) {
+                        pList[j] = pList[--pRemaining[v]];
+
+                        break;
+                    }
+                }
+            }
+
+            // Drawn triangle goes to front of cache
+            uint32_t newCache[MI_CACHE_SIZE + 3];
+            uint32_t newCount = 0;
+
+            for(uint32_t k = 0; k < 3; k++) {
+                newCache[newCount++] = pTriangle[k];
+            }
+
+            for(uint32_t k = 0; k < cacheCount; k++) {
+                uint32_t v = cache[k];
+
+                if(v != pTriangle[0] && v != pTriangle[1] && v != pTriangle[2]) {
+                    newCache[newCount++] = v;
+                }
+            }
+
+            // Rescore everything which was or is in cache, triangle scores follow vertex score changes
+            for(uint32_t k = 0; k < newCount; k++) {
+                uint32_t v = newCache[k];
+                int32_t position = k < MI_CACHE_SIZE ? (int32_t)k : -1;
+
+                pCachePositions[v] = position;
+
+                float score = __MIVertexScore(position, pRemaining[v]);
+                float delta = score - pVertexScores[v];
+
+                pVertexScores[v] = score;
+
+                for(uint32_t j = 0; j < pRemaining[v]; j++) {
+                    pTriangleScores[pAdjacency[pOffsets[v] + j]] += delta;
+                }
+            }
+
+            cacheCount = newCount < MI_CACHE_SIZE ? newCount : MI_CACHE_SIZE;
+            memcpy(cache, newCache, cacheCount * sizeof(uint32_t));
+
+            // Next triangle is best one touching cache
+            best = -1;
+            bestScore = -1.0f;
+
+            for(uint32_t k = 0; k < cacheCount; k++) {
+                uint32_t v = cache[k];
+
+                for(uint32_t j = 0; j < pRemaining[v]; j++) {
+                    uint32_t t = pAdjacency[pOffsets[v] + j];
+
+                    if(pTriangleScores[t] > bestScore) {
+                        bestScore = pTriangleScores[t];
+                        best = t;
+                    }
+                }
+            }
+        }
+
+        memcpy(pIndices, pOutput, triangleCount * 3 * sizeof(uint32_t));
+    }
+
+    free(pOffsets);
+    free(pRemaining);
+    free(pAdjacency);
+    free(pCachePositions);
+    free(pVertexScores);
+    free(pTriangleScores);
+    free(pAdded);
+    free(pOutput);
+
+    return result;
+}
+
+/**
+ * @brief Reorder indexed triangle list for vertex cache and pick smallest index type, takes ownership of both buffers
+ *
+ * @param pMesh output, free with MIFree
+ * @param pVertices malloc`d unique vertices
+ * @param vertexCount
+ * @param pIndices malloc`d 32-bit indices
+ * @param indexCount
+ * @param pDesc vertex layout and primitive
+ * @param pStats optional, receives ACMR and ATVR before ([0], [1]) and after ([2], [3]) reorder
+ */
+void MIFinish(IndexedMesh_t* pMesh, void* pVertices, uint32_t vertexCount, uint32_t* pIndices, uint32_t indexCount, const MeshDesc_t* pDesc, float* pStats) {
+    float stats[4] = {0};
+
+    MICacheStats(pIndices, indexCount, vertexCount, &stats[0], &stats[1]);
+    MIOptimize(pIndices, indexCount, vertexCount);
+    MICacheStats(pIndices, indexCount, vertexCount, &stats[2], &stats[3]);
+
+    if(pStats) {
+        memcpy(pStats, stats, sizeof(stats));
+    }
+
+    pMesh->mDesc = *pDesc;
+    pMesh->mDesc.mVertexCount = vertexCount;
+    pMesh->mDesc.mIndexCount = indexCount;
+    pMesh->pVertices = pVertices;
+
+    if(vertexCount <= 0x10000) {
+        uint16_t* pShort = (uint16_t*)pIndices;
+
+        // Narrowing in place is safe, write position never passes read position
+        for(uint32_t i = 0; i < indexCount; i++) {
+            pShort[i] = (uint16_t)pIndices[i];
+        }
+
+        pMesh->mDesc.mIndexType = GL_UNSIGNED_SHORT;
+    }
+    else {
+        pMesh->mDesc.mIndexType = GL_UNSIGNED_INT;
+    }
+
+    pMesh->pIndices = pIndices;
+}
+
+/**
+ * @brief Weld triangle soup, reorder it for vertex cache and pick smallest index type, prints cache stats before and after
+ *
+ * @param name used in log
+ * @param pVertices
+ * @param pDesc unindexed triangle list
+ * @param pMesh output, free with MIFree
+ * @return true
+ * @return false mesh can`t be indexed (not triangle list or out of memory)
+ */
+bool MIIndexMesh(const char* name, const void* pVertices, const MeshDesc_t* pDesc, IndexedMesh_t* pMesh) {
+    memset(pMesh, 0, sizeof(IndexedMesh_t));
+
+    uint32_t count = pDesc->mVertexCount;
+
+    if(pDesc->mPrimitive != GL_TRIANGLES || pDesc->mIndexType != 0 || count == 0 || count % 3 != 0) {
+        return false;
+    }
+
+    double start = UTGetTimeMs();
+
+    uint8_t* pUnique = (uint8_t*)malloc((uint64_t)count * pDesc->mStride);
+    uint32_t* pIndices = (uint32_t*)malloc(count * sizeof(uint32_t));
+
+    if(!pUnique || !pIndices) {
+        free(pUnique);
+        free(pIndices);
+
+        return false;
+    }
+
+    uint32_t unique = MIWeld(pVertices, count, pDesc->mStride, pUnique, pIndices);
+    void* pShrunk = realloc(pUnique, (uint64_t)unique * pDesc->mStride);
+
+    float stats[4];
+    MIFinish(pMesh, pShrunk ? pShrunk : pUnique, unique, pIndices, count, pDesc, stats);
+
+    // Triangle soup transforms every vertex of every triangle
+    printf("[INFO]: Indexed %s: %u -> %u vertices, %s indices, %.2f ms\n", name, count, unique, unique <= 0x10000 ? "16-bit" : "32-bit", UTGetTimeMs() - start);
+    printf("[INFO]:     ACMR %.3f (soup) %.3f (welded) %.3f (optimized), ATVR %.3f %.3f %.3f (FIFO %u)\n", 3.0f, stats[0], stats[2], (float)count / unique, stats[1], stats[3], MI_FIFO_SIZE);
+
+    return true;
+}
+
+/**
+ * @brief Free indexed mesh data
+ *
+ * @param pMesh
+ */
+void MIFree(IndexedMesh_t* pMesh) {
+    free(pMesh->pVertices);
+    free(pMesh->pIndices);
+
+    memset(pMesh, 0, sizeof(IndexedMesh_t));
+}
+
+#endif
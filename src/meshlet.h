@@ -0,0 +1,691 @@
+#ifndef __MESHLET_
+#define __MESHLET_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include <glad/gl.h>
+
+#include "utils.h"
+#include "meshregistry.h"
+#include "shaderbuild.h"
+
+#define ML_MAX_VERTICES 64
+#define ML_MAX_TRIANGLES 124
+// Meshlets per thread below which bounds computation isn`t split further
+#define ML_MIN_MESHLETS 256
+#define ML_GROUP_SIZE 64
+// Cones wider than this (dot of axis and most distant normal) can`t be back-facing as whole
+#define ML_CONE_MIN_DOT 0.1f
+// Meshes enclosing less of their bounding box are treated as open, both of their sides can be seen
+#define ML_CLOSED_VOLUME 0.01f
+// Frames counters are read after, same as frame data ring
+#define ML_READBACK_FRAMES 3
+
+#define ML_MESHLET_BINDING 3
+#define ML_COMMAND_BINDING 4
+#define ML_COUNTER_BINDING 5
+
+/**
+ * @brief Cluster of consecutive triangles in mesh index buffer, std430 layout of Meshlets buffer
+ */
+typedef struct Meshlet_s {
+    // Bounding sphere in object space
+    float mCenter[3];
+    float mRadius;
+    // Average triangle normal and sine of cone angle, 1 when cone can`t be culled
+    float mConeAxis[3];
+    float mConeCutoff;
+    // Ready to use as DrawElementsIndirectCommand fields
+    uint32_t mFirstIndex;
+    uint32_t mIndexCount;
+    int32_t mBaseVertex;
+    uint32_t mVertexCount;
+} Meshlet_t;
+
+/**
+ * @brief Counters written by culling pass
+ */
+typedef struct MeshletCounters_s {
+    uint32_t mDrawn;
+    uint32_t mFrustumCulled;
+    uint32_t mConeCulled;
+    uint32_t mTriangles;
+} MeshletCounters_t;
+
+/**
+ * @brief Meshlets of every indexed triangle mesh in registry and GPU culling pass drawing them
+ */
+typedef struct Meshlets_s {
+    // Meshlets of registry mesh i are [mFirst[i], mFirst[i] + mCount[i]), count 0 when mesh can`t be split
+    uint32_t mFirst[MR_MAX_MESHES];
+    uint32_t mCount[MR_MAX_MESHES];
+    uint32_t mTotal;
+    uint32_t mMaxCount;
+    // Meshlet ordered copies of registry indices, needed until MRUpload
+    void* pIndices[MR_MAX_MESHES];
+
+    uint32_t mProgram;
+    uint32_t mMeshletBuffer;
+    uint32_t mCommandBuffer;
+
+    // Persistently mapped counters, one slot per frame in flight
+    uint32_t mCounterBuffer;
+    uint8_t* pCounters;
+    uint32_t mCounterStride;
+    GLsync mFences[ML_READBACK_FRAMES];
+    uint32_t mFrame;
+
+    // Sums since last MLPrintStats
+    uint64_t mDrawn, mFrustumCulled, mConeCulled, mTriangles;
+    uint32_t mFrames;
+} Meshlets_t;
+
+// Culling runs in view space, eye comes from MLCull because it isn`t at origin (0, 0, 1 for MX4PerspectiveFOV), w 0 disables cone test
+const char* gMeshletCullSource =
+    "#version 450 core\n"
+    "layout(local_size_x = 64) in;\n"
+    "layout(std140, binding = 0) uniform FrameData { mat4 uProjection; mat4 uView; mat4 uTransform; float uTime; float uDeltaTime; vec2 uResolution; };\n"
+    "struct Meshlet { vec4 mSphere; vec4 mCone; uvec4 mDraw; };\n"
+    "struct Command { uint mCount; uint mInstanceCount; uint mFirstIndex; int mBaseVertex; uint mBaseInstance; };\n"
+    "layout(std430, binding = 3) readonly buffer Meshlets { Meshlet uMeshlets[]; };\n"
+    "layout(std430, binding = 4) writeonly buffer Commands { Command uCommands[]; };\n"
+    "layout(std430, binding = 5) buffer Counters { uint uDrawn; uint uFrustumCulled; uint uConeCulled; uint uTriangles; };\n"
+    "layout(location = 0) uniform uint uFirst;\n"
+    "layout(location = 1) uniform uint uCount;\n"
+    "layout(location = 2) uniform vec4 uEye;\n"
+    "void main() {\n"
+    "    if(gl_GlobalInvocationID.x >= uCount) return;\n"
+    "    Meshlet m = uMeshlets[uFirst + gl_GlobalInvocationID.x];\n"
+    "    mat4 mv = uView * uTransform;\n"
+    "    vec3 c = (mv * vec4(m.mSphere.xyz, 1.0)).xyz;\n"
+    "    float r = m.mSphere.w * max(max(length(mv[0].xyz), length(mv[1].xyz)), length(mv[2].xyz));\n"
+    "    mat4 p = transpose(uProjection);\n"
+    "    vec4 planes[6] = vec4[6](p[3] + p[0], p[3] - p[0], p[3] + p[1], p[3] - p[1], p[3] + p[2], p[3] - p[2]);\n"
+    "    for(int i = 0; i < 6; i++) {\n"
+    "        if(dot(planes[i].xyz, c) + planes[i].w < -r * length(planes[i].xyz)) { atomicAdd(uFrustumCulled, 1u); return; }\n"
+    "    }\n"
+    "    vec3 v = c - uEye.xyz;\n"
+    "    if(m.mCone.w < 1.0 && uEye.w > 0.0 && dot(v, normalize(mat3(mv) * m.mCone.xyz)) >= m.mCone.w * length(v) + r) { atomicAdd(uConeCulled, 1u); return; }\n"
+    "    uint slot = atomicAdd(uDrawn, 1u);\n"
+    "    atomicAdd(uTriangles, m.mDraw.y / 3u);\n"
+    "    uCommands[slot] = Command(m.mDraw.y, 1u, m.mDraw.x, int(m.mDraw.z), 0u);\n"
+    "}\n";
+
+uint32_t __MLIndex(const void* pIndices, GLenum indexType, uint32_t i) {
+    return indexType == GL_UNSIGNED_SHORT ? ((const uint16_t*)pIndices)[i] : ((const uint32_t*)pIndices)[i];
+}
+
+/**
+ * @brief Grow meshlets over shared vertices, next triangle is the one adding fewest new vertices, triangles are written in meshlet order so every meshlet is contiguous index range
+ *
+ * Triangles with no neighbour left in meshlet continue from first unused one in source order, so unwelded meshes still fill meshlets
+ *
+ * @param pIndices source indices, all smaller than vertexCount
+ * @param indexType
+ * @param indexCount
+ * @param vertexCount
+ * @param pOut reordered indices of same type
+ * @param pCount receives meshlet count
+ * @return Meshlet_t* meshlets with mesh local mFirstIndex, nullptr when out of memory
+ */
+Meshlet_t* __MLCluster(const void* pIndices, GLenum indexType, uint32_t indexCount, uint32_t vertexCount, void* pOut, uint32_t* pCount) {
+    uint32_t triangles = indexCount / 3;
+
+    // Triangles of every vertex, first mLive of them are not emitted yet
+    uint32_t* pOffsets = (uint32_t*)calloc(vertexCount + 1, sizeof(uint32_t));
+    uint32_t* pLive = (uint32_t*)calloc(vertexCount ? vertexCount : 1, sizeof(uint32_t));
+    uint32_t* pAdjacency = (uint32_t*)malloc((uint64_t)(triangles ? triangles : 1) * 3 * sizeof(uint32_t));
+    // Meshlet which last used vertex, + 1 so zeroed memory means unused
+    uint32_t* pStamps = (uint32_t*)calloc(vertexCount ? vertexCount : 1, sizeof(uint32_t));
+    uint8_t* pEmitted = (uint8_t*)calloc(triangles ? triangles : 1, 1);
+    // Every meshlet has at least one triangle
+    Meshlet_t* pMeshlets = (Meshlet_t*)calloc(triangles ? triangles : 1, sizeof(Meshlet_t));
+
+    *pCount = 0;
+
+    if(!pOffsets || !pLive || !pAdjacency || !pStamps || !pEmitted || !pMeshlets) {
+        free(pOffsets);
+        free(pLive);
+        free(pAdjacency);
+        free(pStamps);
+        free(pEmitted);
+        free(pMeshlets);
+
+        return nullptr;
+    }
+
+    for(uint32_t i = 0; i < triangles * 3; i++) {
+        pOffsets[__MLIndex(pIndices, indexType, i) + 1]++;
+    }
+
+    for(uint32_t v = 0; v < vertexCount; v++) {
+        pOffsets[v + 1] += pOffsets[v];
+    }
+
+    for(uint32_t i = 0; i < triangles * 3; i++) {
+        uint32_t v = __MLIndex(pIndices, indexType, i);
+
+        pAdjacency[pOffsets[v] + pLive[v]++] = i / 3;
+    }
+
+    uint32_t vertices[ML_MAX_VERTICES];
+    uint32_t count = 0, vertexCountInMeshlet = 0, triangleCount = 0, cursor = 0;
+
+    for(uint32_t emitted = 0; emitted < triangles; emitted++) {
+        uint32_t best = UINT32_MAX, bestScore = 4;
+
+        // Neighbour adding fewest vertices, 0 can`t be beaten
+        for(uint32_t i = 0; i < vertexCountInMeshlet && bestScore > 0; i++) {
+            uint32_t v = vertices[i];
+
+            for(uint32_t j = pOffsets[v]; j < pOffsets[v] + pLive[v]; j++) {
+                uint32_t t = pAdjacency[j], score = 0;
+
+                for(uint32_t k = 0; k < 3; k++) {
+                    score += pStamps[__MLIndex(pIndices, indexType, t * 3 + k)] != count + 1;
+                }
+
+                if(score < bestScore) {
+                    best = t;
+                    bestScore = score;
+
+                    if(score == 0) {
+                        break;
+                    }
+                }
+            }
+        }
+
+        if(best == UINT32_MAX) {
+            while(pEmitted[cursor]) {
+                cursor++;
+            }
+
+            best = cursor;
+            bestScore = 3;
+        }
+
+        // Triangle which doesn`t fit starts next meshlet, it touches this one so meshlets stay next to each other
+        if(triangleCount == ML_MAX_TRIANGLES || vertexCountInMeshlet + bestScore > ML_MAX_VERTICES) {
+            pMeshlets[count].mIndexCount = triangleCount * 3;
+            pMeshlets[count].mVertexCount = vertexCountInMeshlet;
+
+            count++;
+            pMeshlets[count].mFirstIndex = emitted * 3;
+            vertexCountInMeshlet = 0;
+            triangleCount = 0;
+        }
+
+        for(uint32_t k = 0; k < 3; k++) {
+            uint32_t v = __MLIndex(pIndices, indexType, best * 3 + k);
+
+            if(indexType == GL_UNSIGNED_SHORT) {
+                ((uint16_t*)pOut)[emitted * 3 + k] = (uint16_t)v;
+            }
+            else {
+                ((uint32_t*)pOut)[emitted * 3 + k] = v;
+            }
+
+            if(pStamps[v] != count + 1) {
+                pStamps[v] = count + 1;
+                vertices[vertexCountInMeshlet++] = v;
+            }
+
+            // Swap triangle out of live part of vertex list, vertex repeated in degenerate triangle finds it already gone
+            for(uint32_t j = pOffsets[v]; j < pOffsets[v] + pLive[v]; j++) {
+                if(pAdjacency[j] == best) {
+                    pAdjacency[j] = pAdjacency[pOffsets[v] + --pLive[v]];
+                    break;
+                }
+            }
+        }
+
+        pEmitted[best] = 1;
+        triangleCount++;
+    }
+
+    if(triangleCount) {
+        pMeshlets[count].mIndexCount = triangleCount * 3;
+        pMeshlets[count].mVertexCount = vertexCountInMeshlet;
+        count++;
+    }
+
+    free(pOffsets);
+    free(pLive);
+    free(pAdjacency);
+    free(pStamps);
+    free(pEmitted);
+
+    *pCount = count;
+
+    return pMeshlets;
+}
+
+typedef struct __MLContext_s {
+    Meshlet_t* pMeshlets;
+    // Six times signed volume under every meshlet
+    float* pVolumes;
+    // Packed float3 positions in mesh units
+    const float* pPositions;
+    const void* pIndices;
+    GLenum mIndexType;
+} __MLContext_t;
+
+void __MLPosition(const __MLContext_t* pContext, uint32_t index, float* pOut) {
+    uint32_t vertex = __MLIndex(pContext->pIndices, pContext->mIndexType, index);
+
+    memcpy(pOut, &pContext->pPositions[(uint64_t)vertex * 3], 3 * sizeof(float));
+}
+
+void __MLBounds(uint32_t begin, uint32_t end, void* pData) {
+    __MLContext_t* pContext = (__MLContext_t*)pData;
+
+    for(uint32_t i = begin; i < end; i++) {
+        Meshlet_t* pMeshlet = &pContext->pMeshlets[i];
+        uint32_t last = pMeshlet->mFirstIndex + pMeshlet->mIndexCount;
+        float min[3] = {INFINITY, INFINITY, INFINITY}, max[3] = {-INFINITY, -INFINITY, -INFINITY};
+        float axis[3] = {0.0f, 0.0f, 0.0f};
+        float volume = 0.0f;
+
+        for(uint32_t t = pMeshlet->mFirstIndex; t < last; t += 3) {
+            float p[3][3];
+
+            for(uint32_t k = 0; k < 3; k++) {
+                __MLPosition(pContext, t + k, p[k]);
+
+                for(uint32_t c = 0; c < 3; c++) {
+                    min[c] = fminf(min[c], p[k][c]);
+                    max[c] = fmaxf(max[c], p[k][c]);
+                }
+            }
+
+            // Area weighted normal, larger triangles steer axis more
+            float e0[3] = {p[1][0] - p[0][0], p[1][1] - p[0][1], p[1][2] - p[0][2]};
+            float e1[3] = {p[2][0] - p[0][0], p[2][1] - p[0][1], p[2][2] - p[0][2]};
+
+            float n[3] = {e0[1] * e1[2] - e0[2] * e1[1], e0[2] * e1[0] - e0[0] * e1[2], e0[0] * e1[1] - e0[1] * e1[0]};
+
+            axis[0] += n[0];
+            axis[1] += n[1];
+            axis[2] += n[2];
+            volume += p[0][0] * n[0] + p[0][1] * n[1] + p[0][2] * n[2];
+        }
+
+        pContext->pVolumes[i] = volume;
+
+        float radius = 0.0f;
+
+        for(uint32_t c = 0; c < 3; c++) {
+            pMeshlet->mCenter[c] = (min[c] + max[c]) * 0.5f;
+        }
+
+        float length = sqrtf(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+        float minDot = 1.0f;
+
+        for(uint32_t c = 0; c < 3; c++) {
+            pMeshlet->mConeAxis[c] = length > 0.0f ? axis[c] / length : 0.0f;
+        }
+
+        for(uint32_t t = pMeshlet->mFirstIndex; t < last; t += 3) {
+            float p[3][3];
+
+            for(uint32_t k = 0; k < 3; k++) {
+                __MLPosition(pContext, t + k, p[k]);
+
+                float dx = p[k][0] - pMeshlet->mCenter[0], dy = p[k][1] - pMeshlet->mCenter[1], dz = p[k][2] - pMeshlet->mCenter[2];
+
+                radius = fmaxf(radius, sqrtf(dx * dx + dy * dy + dz * dz));
+            }
+
+            float e0[3] = {p[1][0] - p[0][0], p[1][1] - p[0][1], p[1][2] - p[0][2]};
+            float e1[3] = {p[2][0] - p[0][0], p[2][1] - p[0][1], p[2][2] - p[0][2]};
+            float n[3] = {e0[1] * e1[2] - e0[2] * e1[1], e0[2] * e1[0] - e0[0] * e1[2], e0[0] * e1[1] - e0[1] * e1[0]};
+            float nLength = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+            // Degenerate triangles are never rasterized
+            if(nLength > 0.0f) {
+                minDot = fminf(minDot, (n[0] * pMeshlet->mConeAxis[0] + n[1] * pMeshlet->mConeAxis[1] + n[2] * pMeshlet->mConeAxis[2]) / nLength);
+            }
+        }
+
+        pMeshlet->mRadius = radius;
+        pMeshlet->mConeCutoff = length > 0.0f && minDot > ML_CONE_MIN_DOT ? sqrtf(1.0f - minDot * minDot) : 1.0f;
+    }
+}
+
+/**
+ * @brief Split every indexed triangle mesh of registry into meshlets with bounding sphere and normal cone and create culling pass
+ *
+ * Call before MRUpload while vertices are still alive, registry indices are replaced by meshlet ordered copies which stay alive until MLReleaseIndices
+ *
+ * @param pMeshlets
+ * @param pRegistry
+ * @return true
+ * @return false nothing to split, out of memory or culling shader failed
+ */
+bool MLBuild(Meshlets_t* pMeshlets, MeshRegistry_t* pRegistry) {
+    memset(pMeshlets, 0, sizeof(Meshlets_t));
+
+    double start = UTGetTimeMs();
+
+    Meshlet_t* pMeshMeshlets[MR_MAX_MESHES] = {0};
+
+    for(uint32_t m = 0; m < pRegistry->mCount; m++) {
+        MeshEntry_t* pMesh = &pRegistry->mMeshes[m];
+
+        pMeshlets->mFirst[m] = pMeshlets->mTotal;
+
+        if(!pMesh->pIndices || !pMesh->pVertices || pMesh->mDesc.mPrimitive != GL_TRIANGLES || !MRPositionAttribute(&pMesh->mDesc)) {
+            continue;
+        }
+
+        pMeshlets->pIndices[m] = malloc((uint64_t)pMesh->mDesc.mIndexCount * MRIndexSize(pMesh->mDesc.mIndexType));
+
+        if(pMeshlets->pIndices[m]) {
+            pMeshMeshlets[m] = __MLCluster(pMesh->pIndices, pMesh->mDesc.mIndexType, pMesh->mDesc.mIndexCount, pMesh->mDesc.mVertexCount, pMeshlets->pIndices[m], &pMeshlets->mCount[m]);
+        }
+
+        if(!pMeshMeshlets[m]) {
+            printf("[INFO]: Not enough memory to split <%s> into meshlets\n", pMesh->mName);
+            free(pMeshlets->pIndices[m]);
+            pMeshlets->pIndices[m] = nullptr;
+            pMeshlets->mCount[m] = 0;
+
+            continue;
+        }
+
+        // Registry uploads reordered triangles, indices after last full triangle are dropped
+        pMesh->pIndices = pMeshlets->pIndices[m];
+        pMesh->mDesc.mIndexCount = pMesh->mDesc.mIndexCount / 3 * 3;
+
+        pMeshlets->mTotal += pMeshlets->mCount[m];
+        pMeshlets->mMaxCount = pMeshlets->mCount[m] > pMeshlets->mMaxCount ? pMeshlets->mCount[m] : pMeshlets->mMaxCount;
+    }
+
+    Meshlet_t* pData = (Meshlet_t*)calloc(pMeshlets->mTotal ? pMeshlets->mTotal : 1, sizeof(Meshlet_t));
+    float* pVolumes = (float*)calloc(pMeshlets->mTotal ? pMeshlets->mTotal : 1, sizeof(float));
+
+    if(pMeshlets->mTotal == 0 || !pData || !pVolumes) {
+        printf(pMeshlets->mTotal ? "[INFO]: Not enough memory for meshlets\n" : "[INFO]: No indexed triangle mesh to split into meshlets\n");
+
+        for(uint32_t m = 0; m < pRegistry->mCount; m++) {
+            free(pMeshMeshlets[m]);
+        }
+
+        free(pData);
+        free(pVolumes);
+
+        return false;
+    }
+
+    uint32_t threads = 1;
+    uint64_t vertices = 0, triangles = 0;
+    uint32_t open = 0, flipped = 0;
+
+    for(uint32_t m = 0; m < pRegistry->mCount; m++) {
+        const MeshEntry_t* pMesh = &pRegistry->mMeshes[m];
+        Meshlet_t* pMeshlet = pData + pMeshlets->mFirst[m];
+
+        if(pMeshlets->mCount[m] == 0) {
+            continue;
+        }
+
+        memcpy(pMeshlet, pMeshMeshlets[m], pMeshlets->mCount[m] * sizeof(Meshlet_t));
+        free(pMeshMeshlets[m]);
+
+        // Quantized positions are decoded once, bounds are in mesh units either way
+        float* pPositions = MRDecodePositions(pMesh);
+
+        __MLContext_t context = {
+            .pMeshlets = pMeshlet,
+            .pVolumes = pVolumes + pMeshlets->mFirst[m],
+            .pPositions = pPositions,
+            .pIndices = pMesh->pIndices,
+            .mIndexType = pMesh->mDesc.mIndexType
+        };
+
+        if(pPositions) {
+            uint32_t used = UTParallelFor(pMeshlets->mCount[m], ML_MIN_MESHLETS, __MLBounds, &context);
+            threads = used > threads ? used : threads;
+        }
+        else {
+            // Without positions every meshlet gets sphere of whole mesh and is never cone culled
+            for(uint32_t i = 0; i < pMeshlets->mCount[m]; i++) {
+                float radius = 0.0f;
+
+                for(uint32_t c = 0; c < 3; c++) {
+                    pMeshlet[i].mCenter[c] = (pMesh->mMin[c] + pMesh->mMax[c]) * 0.5f;
+                    radius += (pMesh->mMax[c] - pMesh->mMin[c]) * (pMesh->mMax[c] - pMesh->mMin[c]) * 0.25f;
+                }
+
+                pMeshlet[i].mRadius = sqrtf(radius);
+                pMeshlet[i].mConeCutoff = 1.0f;
+            }
+        }
+
+        free(pPositions);
+
+        double volume = 0.0;
+
+        for(uint32_t i = 0; i < pMeshlets->mCount[m]; i++) {
+            volume += context.pVolumes[i];
+        }
+
+        // Back-facing meshlets hide behind front of closed mesh only, generated shapes are wound clockwise so winding comes from volume sign
+        double box = (double)(pMesh->mMax[0] - pMesh->mMin[0]) * (pMesh->mMax[1] - pMesh->mMin[1]) * (pMesh->mMax[2] - pMesh->mMin[2]);
+        bool closed = box > 0.0 && fabs(volume / 6.0) > box * ML_CLOSED_VOLUME;
+
+        open += !closed;
+        flipped += closed && volume < 0.0;
+
+        // Cluster and bounds work with mesh local indices, draws need registry offsets
+        for(uint32_t i = 0; i < pMeshlets->mCount[m]; i++) {
+            pMeshlet[i].mFirstIndex += (uint32_t)(pMesh->mIndexOffset / MRIndexSize(pMesh->mDesc.mIndexType));
+            pMeshlet[i].mBaseVertex = (int32_t)pMesh->mBaseVertex;
+            pMeshlet[i].mConeCutoff = closed ? pMeshlet[i].mConeCutoff : 1.0f;
+
+            for(uint32_t c = 0; c < 3 && volume < 0.0; c++) {
+                pMeshlet[i].mConeAxis[c] = -pMeshlet[i].mConeAxis[c];
+            }
+
+            vertices += pMeshlet[i].mVertexCount;
+            triangles += pMeshlet[i].mIndexCount / 3;
+        }
+    }
+
+    free(pVolumes);
+
+    pMeshlets->mProgram = SBBuildComputeProgram("meshlet cull", gMeshletCullSource);
+
+    if(!pMeshlets->mProgram) {
+        free(pData);
+
+        return false;
+    }
+
+    glCreateBuffers(1, &pMeshlets->mMeshletBuffer);
+    glNamedBufferStorage(pMeshlets->mMeshletBuffer, (uint64_t)pMeshlets->mTotal * sizeof(Meshlet_t), pData, 0);
+    free(pData);
+
+    // Culled tail of command buffer is zeroed every frame, so survivors are drawn with one call without GL_ARB_indirect_parameters
+    glCreateBuffers(1, &pMeshlets->mCommandBuffer);
+    glNamedBufferStorage(pMeshlets->mCommandBuffer, (uint64_t)pMeshlets->mMaxCount * 5 * sizeof(uint32_t), nullptr, 0);
+
+    int alignment = 256;
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+
+    pMeshlets->mCounterStride = (sizeof(MeshletCounters_t) + alignment - 1) / alignment * alignment;
+
+    GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    glCreateBuffers(1, &pMeshlets->mCounterBuffer);
+    glNamedBufferStorage(pMeshlets->mCounterBuffer, pMeshlets->mCounterStride * ML_READBACK_FRAMES, nullptr, flags);
+    pMeshlets->pCounters = (uint8_t*)glMapNamedBufferRange(pMeshlets->mCounterBuffer, 0, pMeshlets->mCounterStride * ML_READBACK_FRAMES, flags);
+
+    if(!pMeshlets->pCounters) {
+        printf("[INFO]: Cannot map meshlet counters, culling stats are disabled\n");
+    }
+
+    printf("[INFO]: Meshlets: %u in %.2f ms on %u threads, %.1f vertices and %.1f triangles on average, %u open meshes without cone culling, %u clockwise\n", pMeshlets->mTotal, UTGetTimeMs() - start, threads, (double)vertices / pMeshlets->mTotal, (double)triangles / pMeshlets->mTotal, open, flipped);
+
+    return true;
+}
+
+/**
+ * @brief Free reordered indices, call after MRUpload
+ *
+ * @param pMeshlets
+ */
+void MLReleaseIndices(Meshlets_t* pMeshlets) {
+    for(uint32_t m = 0; m < MR_MAX_MESHES; m++) {
+        free(pMeshlets->pIndices[m]);
+        pMeshlets->pIndices[m] = nullptr;
+    }
+}
+
+/**
+ * @brief Cull meshlets of mesh against view frustum and normal cone on GPU and compact survivors into command buffer, call after FDUpdate and before draw program is bound
+ *
+ * @param pMeshlets
+ * @param mesh registry mesh index
+ * @param pProjection column-major projection frame is drawn with
+ * @return true
+ * @return false mesh has no meshlets, draw it whole
+ */
+bool MLCull(Meshlets_t* pMeshlets, uint32_t mesh, const float* pProjection) {
+    if(!pMeshlets->mProgram || mesh >= MR_MAX_MESHES || pMeshlets->mCount[mesh] == 0) {
+        return false;
+    }
+
+    uint32_t slot = pMeshlets->mFrame % ML_READBACK_FRAMES;
+
+    // Counters from ML_READBACK_FRAMES frames ago, GPU is usually done with them so this rarely waits
+    if(pMeshlets->mFences[slot]) {
+        while(glClientWaitSync(pMeshlets->mFences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED);
+
+        glDeleteSync(pMeshlets->mFences[slot]);
+        pMeshlets->mFences[slot] = nullptr;
+
+        if(pMeshlets->pCounters) {
+            MeshletCounters_t counters;
+
+            memcpy(&counters, pMeshlets->pCounters + slot * pMeshlets->mCounterStride, sizeof(counters));
+
+            pMeshlets->mDrawn += counters.mDrawn;
+            pMeshlets->mFrustumCulled += counters.mFrustumCulled;
+            pMeshlets->mConeCulled += counters.mConeCulled;
+            pMeshlets->mTriangles += counters.mTriangles;
+            pMeshlets->mFrames++;
+        }
+    }
+
+    glClearNamedBufferSubData(pMeshlets->mCommandBuffer, GL_R32UI, 0, (uint64_t)pMeshlets->mCount[mesh] * 5 * sizeof(uint32_t), GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    glClearNamedBufferSubData(pMeshlets->mCounterBuffer, GL_R32UI, slot * pMeshlets->mCounterStride, sizeof(MeshletCounters_t), GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+    // Eye is point projected to x = y = w = 0, Cramer`s rule on rows 0, 1 and 3, orthographic projection has none
+    const float* m = pProjection;
+    float a[3][4] = {{m[0], m[4], m[8], -m[12]}, {m[1], m[5], m[9], -m[13]}, {m[3], m[7], m[11], -m[15]}};
+    float det = a[0][0] * (a[1][1] * a[2][2] - a[1][2] * a[2][1]) - a[0][1] * (a[1][0] * a[2][2] - a[1][2] * a[2][0]) + a[0][2] * (a[1][0] * a[2][1] - a[1][1] * a[2][0]);
+    float eye[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+
+    if(fabsf(det) > 1e-12f) {
+        for(uint32_t c = 0; c < 3; c++) {
+            float b[3][3];
+
+            for(uint32_t r = 0; r < 3; r++) {
+                for(uint32_t k = 0; k < 3; k++) {
+                    b[r][k] = k == c ? a[r][3] : a[r][k];
+                }
+            }
+
+            eye[c] = (b[0][0] * (b[1][1] * b[2][2] - b[1][2] * b[2][1]) - b[0][1] * (b[1][0] * b[2][2] - b[1][2] * b[2][0]) + b[0][2] * (b[1][0] * b[2][1] - b[1][1] * b[2][0])) / det;
+        }
+
+        eye[3] = 1.0f;
+    }
+
+    glUseProgram(pMeshlets->mProgram);
+    glProgramUniform1ui(pMeshlets->mProgram, 0, pMeshlets->mFirst[mesh]);
+    glProgramUniform1ui(pMeshlets->mProgram, 1, pMeshlets->mCount[mesh]);
+    glProgramUniform4fv(pMeshlets->mProgram, 2, 1, eye);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, ML_MESHLET_BINDING, pMeshlets->mMeshletBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, ML_COMMAND_BINDING, pMeshlets->mCommandBuffer);
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, ML_COUNTER_BINDING, pMeshlets->mCounterBuffer, slot * pMeshlets->mCounterStride, sizeof(MeshletCounters_t));
+
+    glDispatchCompute((pMeshlets->mCount[mesh] + ML_GROUP_SIZE - 1) / ML_GROUP_SIZE, 1, 1);
+
+    // Commands are read by draw, counters by CPU through coherent mapping
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT);
+    glUseProgram(0);
+
+    pMeshlets->mFences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    pMeshlets->mFrame++;
+
+    return true;
+}
+
+/**
+ * @brief Draw meshlets which survived last MLCull of mesh with one indirect call
+ *
+ * @param pMeshlets
+ * @param pRegistry
+ * @param mesh
+ */
+void MLDraw(Meshlets_t* pMeshlets, MeshRegistry_t* pRegistry, uint32_t mesh) {
+    MeshEntry_t* pMesh = &pRegistry->mMeshes[mesh];
+
+    glBindVertexArray(pRegistry->mVaos[pMesh->mFormat]);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, pMeshlets->mCommandBuffer);
+    glMultiDrawElementsIndirect(GL_TRIANGLES, pMesh->mDesc.mIndexType, nullptr, pMeshlets->mCount[mesh], 0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+/**
+ * @brief Print average drawn and culled meshlets per frame since last call
+ *
+ * @param pMeshlets
+ */
+void MLPrintStats(Meshlets_t* pMeshlets) {
+    if(pMeshlets->mFrames == 0) {
+        return;
+    }
+
+    double frames = pMeshlets->mFrames;
+
+    printf("[INFO]:     meshlets: %.0f drawn, %.0f frustum culled, %.0f cone culled, %.0f triangles per frame\n", pMeshlets->mDrawn / frames, pMeshlets->mFrustumCulled / frames, pMeshlets->mConeCulled / frames, pMeshlets->mTriangles / frames);
+
+    pMeshlets->mDrawn = pMeshlets->mFrustumCulled = pMeshlets->mConeCulled = pMeshlets->mTriangles = 0;
+    pMeshlets->mFrames = 0;
+}
+
+/**
+ * @brief Delete program, buffers and fences
+ *
+ * @param pMeshlets
+ */
+void MLTerminate(Meshlets_t* pMeshlets) {
+    for(uint32_t i = 0; i < ML_READBACK_FRAMES; i++) {
+        if(pMeshlets->mFences[i]) {
+            glDeleteSync(pMeshlets->mFences[i]);
+        }
+    }
+
+    if(pMeshlets->pCounters) {
+        glUnmapNamedBuffer(pMeshlets->mCounterBuffer);
+    }
+
+    MLReleaseIndices(pMeshlets);
+    glDeleteProgram(pMeshlets->mProgram);
+    glDeleteBuffers(1, &pMeshlets->mMeshletBuffer);
+    glDeleteBuffers(1, &pMeshlets->mCommandBuffer);
+    glDeleteBuffers(1, &pMeshlets->mCounterBuffer);
+
+    memset(pMeshlets, 0, sizeof(Meshlets_t));
+}
+
+#endif
@@ -0,0 +1,324 @@
+#ifndef __MESH_QUANTIZE_
+#define __MESH_QUANTIZE_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include <glad/gl.h>
+
+#include "utils.h"
+#include "meshregistry.h"
+
+// Vertices per thread below which encoding isn`t split further
+#define MQ_MIN_VERTICES 4096
+
+/**
+ * @brief Quantized copies of registry vertices, alive until MRUpload
+ *
+ * Attributes are encoded as:
+ * location 0 position   vec3 float -> 4x GL_UNSIGNED_SHORT normalized relative to mesh bounds (w is 1.0), decoded by uMeshDecode
+ * location 1 normal     vec3 float -> 2x GL_SHORT normalized octahedral
+ * location 2 uv         vec2 float -> 2x GL_HALF_FLOAT
+ * location 3 tangent    vec4 float -> 4x GL_SHORT normalized
+ * other attributes are copied as they are
+ */
+typedef struct MeshQuantizer_s {
+    void* pVertices[MR_MAX_MESHES];
+    uint64_t mBytesBefore, mBytesAfter;
+    uint32_t mMeshes;
+} MeshQuantizer_t;
+
+/**
+ * @brief Float to IEEE half, rounded to nearest even, out of range values become infinity
+ *
+ * @param value
+ * @return uint16_t
+ */
+uint16_t MQHalf(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    uint32_t sign = (bits >> 16) & 0x8000;
+    uint32_t mantissa = bits & 0x7FFFFF;
+    int32_t exponent = (int32_t)((bits >> 23) & 0xFF) - 127 + 15;
+
+    if(((bits >> 23) & 0xFF) == 0xFF) {
+        return (uint16_t)(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+    }
+
+    if(exponent >= 31) {
+        return (uint16_t)(sign | 0x7C00);
+    }
+
+    // Denormal half, implicit bit is shifted into mantissa
+    if(exponent <= 0) {
+        if(exponent < -10) {
+            return (uint16_t)sign;
+        }
+
+        mantissa |= 0x800000;
+
+        uint32_t shift = (uint32_t)(14 - exponent);
+        uint32_t half = mantissa >> shift;
+        uint32_t rest = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+
+        half += rest > halfway || (rest == halfway && (half & 1));
+
+        return (uint16_t)(sign | half);
+    }
+
+    uint32_t half = ((uint32_t)exponent << 10) | (mantissa >> 13);
+    uint32_t rest = mantissa & 0x1FFF;
+
+    // Carry out of mantissa moves into exponent, which is still correct rounding
+    half += rest > 0x1000 || (rest == 0x1000 && (half & 1));
+
+    return (uint16_t)(sign | half);
+}
+
+float __MQSign(float value) {
+    return value >= 0.0f ? 1.0f : -1.0f;
+}
+
+/**
+ * @brief Map unit vector onto octahedron unfolded into [-1, 1] square and store it as signed normalized shorts
+ *
+ * Shader decode:
+ * vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+ * float t = max(-n.z, 0.0);
+ * n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+ * n = normalize(n);
+ *
+ * @param pNormal
+ * @param pOut
+ */
+void MQOctahedral(const float* pNormal, int16_t* pOut) {
+    float length = fabsf(pNormal[0]) + fabsf(pNormal[1]) + fabsf(pNormal[2]);
+    float x = length > 0.0f ? pNormal[0] / length : 0.0f;
+    float y = length > 0.0f ? pNormal[1] / length : 0.0f;
+
+    // Lower half folds over diagonals
+    if(length > 0.0f && pNormal[2] < 0.0f) {
+        float fx = (1.0f - fabsf(y)) * __MQSign(x);
+        float fy = (1.0f - fabsf(x)) * __MQSign(y);
+
+        x = fx;
+        y = fy;
+    }
+
+    pOut[0] = (int16_t)lrintf(fminf(fmaxf(x, -1.0f), 1.0f) * 32767.0f);
+    pOut[1] = (int16_t)lrintf(fminf(fmaxf(y, -1.0f), 1.0f) * 32767.0f);
+}
+
+/**
+ * @brief Quantized layout of descriptor, attributes keep their order and are 4 byte aligned
+ *
+ * @param pDesc
+ * @param pOut
+ * @return true
+ * @return false nothing to quantize
+ */
+bool MQLayout(const MeshDesc_t* pDesc, MeshDesc_t* pOut) {
+    bool changed = false;
+
+    *pOut = *pDesc;
+    pOut->mStride = 0;
+
+    for(uint32_t i = 0; i < pDesc->mAttributeCount; i++) {
+        const MeshAttribute_t* pSource = &pDesc->mAttributes[i];
+        MeshAttribute_t* pAttribute = &pOut->mAttributes[i];
+        bool floats = pSource->mType == GL_FLOAT;
+
+        if(floats && pSource->mLocation == 0 && pSource->mComponents >= 3) {
+            *pAttribute = (MeshAttribute_t){.mLocation = 0, .mComponents = 4, .mType = GL_UNSIGNED_SHORT, .mNormalized = true};
+        }
+        else if(floats && pSource->mLocation == 1 && pSource->mComponents == 3) {
+            *pAttribute = (MeshAttribute_t){.mLocation = 1, .mComponents = 2, .mType = GL_SHORT, .mNormalized = true};
+        }
+        else if(floats && pSource->mLocation == 2 && pSource->mComponents == 2) {
+            *pAttribute = (MeshAttribute_t){.mLocation = 2, .mComponents = 2, .mType = GL_HALF_FLOAT, .mNormalized = false};
+        }
+        else if(floats && pSource->mLocation == 3 && pSource->mComponents == 4) {
+            *pAttribute = (MeshAttribute_t){.mLocation = 3, .mComponents = 4, .mType = GL_SHORT, .mNormalized = true};
+        }
+
+        changed |= pAttribute->mType != pSource->mType;
+        pAttribute->mOffset = pOut->mStride;
+        pOut->mStride += (pAttribute->mComponents * MRTypeSize(pAttribute->mType) + 3) / 4 * 4;
+    }
+
+    return changed && pOut->mStride < pDesc->mStride;
+}
+
+typedef struct __MQContext_s {
+    const uint8_t* pSource;
+    uint8_t* pDestination;
+    const MeshDesc_t* pSourceDesc;
+    const MeshDesc_t* pDesc;
+    float mMin[3];
+    float mScale[3];
+} __MQContext_t;
+
+void __MQEncode(uint32_t begin, uint32_t end, void* pData) {
+    __MQContext_t* pContext = (__MQContext_t*)pData;
+    const MeshDesc_t* pSourceDesc = pContext->pSourceDesc;
+    const MeshDesc_t* pDesc = pContext->pDesc;
+
+    for(uint32_t v = begin; v < end; v++) {
+        const uint8_t* pFrom = pContext->pSource + (uint64_t)v * pSourceDesc->mStride;
+        uint8_t* pTo = pContext->pDestination + (uint64_t)v * pDesc->mStride;
+
+        for(uint32_t i = 0; i < pDesc->mAttributeCount; i++) {
+            const MeshAttribute_t* pSource = &pSourceDesc->mAttributes[i];
+            const MeshAttribute_t* pAttribute = &pDesc->mAttributes[i];
+            float values[4] = {0};
+
+            if(pAttribute->mType == pSource->mType) {
+                memcpy(pTo + pAttribute->mOffset, pFrom + pSource->mOffset, pSource->mComponents * MRTypeSize(pSource->mType));
+                continue;
+            }
+
+            memcpy(values, pFrom + pSource->mOffset, (pSource->mComponents > 4 ? 4 : pSource->mComponents) * sizeof(float));
+
+            if(pAttribute->mType == GL_UNSIGNED_SHORT) {
+                uint16_t q[4] = {0, 0, 0, 0xFFFF};
+
+                for(uint32_t c = 0; c < 3; c++) {
+                    q[c] = (uint16_t)lrintf(fminf(fmaxf((values[c] - pContext->mMin[c]) * pContext->mScale[c], 0.0f), 65535.0f));
+                }
+
+                memcpy(pTo + pAttribute->mOffset, q, sizeof(q));
+            }
+            else if(pAttribute->mType == GL_SHORT && pAttribute->mComponents == 4) {
+                int16_t q[4];
+
+                // Tangent keeps handedness in w, both are unit range already
+                for(uint32_t c = 0; c < 4; c++) {
+                    q[c] = (int16_t)lrintf(fminf(fmaxf(values[c], -1.0f), 1.0f) * 32767.0f);
+                }
+
+                memcpy(pTo + pAttribute->mOffset, q, sizeof(q));
+            }
+            else if(pAttribute->mType == GL_SHORT) {
+                int16_t q[2];
+
+                MQOctahedral(values, q);
+                memcpy(pTo + pAttribute->mOffset, q, sizeof(q));
+            }
+            else {
+                uint16_t q[2] = {MQHalf(values[0]), MQHalf(values[1])};
+
+                memcpy(pTo + pAttribute->mOffset, q, sizeof(q));
+            }
+        }
+    }
+}
+
+/**
+ * @brief Encode vertices into quantized layout in parallel
+ *
+ * @param pVertices float vertices described by pDesc
+ * @param pDesc
+ * @param pMin bounds positions are relative to
+ * @param pMax
+ * @param pQuantized output layout from MQLayout
+ * @param pOut output, pQuantized->mStride bytes per vertex
+ * @return uint32_t threads used
+ */
+uint32_t MQEncode(const void* pVertices, const MeshDesc_t* pDesc, const float* pMin, const float* pMax, const MeshDesc_t* pQuantized, void* pOut) {
+    __MQContext_t context = {
+        .pSource = (const uint8_t*)pVertices,
+        .pDestination = (uint8_t*)pOut,
+        .pSourceDesc = pDesc,
+        .pDesc = pQuantized
+    };
+
+    for(uint32_t c = 0; c < 3; c++) {
+        context.mMin[c] = pMin[c];
+        context.mScale[c] = pMax[c] > pMin[c] ? 65535.0f / (pMax[c] - pMin[c]) : 0.0f;
+    }
+
+    return UTParallelFor(pDesc->mVertexCount, MQ_MIN_VERTICES, __MQEncode, &context);
+}
+
+/**
+ * @brief Replace float vertices of every registry mesh by quantized copies and lay registry out again, mesh indices don`t change
+ *
+ * Call after all meshes are added and before anything reads registry offsets (MSBuildLods, MLBuild, MRUpload), quantized copies stay alive until MQReleaseVertices
+ *
+ * @param pQuantizer
+ * @param pRegistry
+ * @return true
+ * @return false nothing was quantized
+ */
+bool MQQuantizeRegistry(MeshQuantizer_t* pQuantizer, MeshRegistry_t* pRegistry) {
+    memset(pQuantizer, 0, sizeof(MeshQuantizer_t));
+
+    double start = UTGetTimeMs();
+    uint32_t threads = 1;
+
+    for(uint32_t m = 0; m < pRegistry->mCount; m++) {
+        MeshEntry_t* pMesh = &pRegistry->mMeshes[m];
+        MeshDesc_t source = pMesh->mDesc, desc;
+
+        if(!pMesh->pVertices || pRegistry->mBuffer || !MQLayout(&source, &desc)) {
+            continue;
+        }
+
+        void* pVertices = malloc((uint64_t)(source.mVertexCount ? source.mVertexCount : 1) * desc.mStride);
+
+        if(!pVertices) {
+            printf("[INFO]: Not enough memory to quantize <%s>\n", pMesh->mName);
+            continue;
+        }
+
+        uint32_t used = MQEncode(pMesh->pVertices, &source, pMesh->mMin, pMesh->mMax, &desc, pVertices);
+        threads = used > threads ? used : threads;
+
+        if(!MRReplace(pRegistry, m, pVertices, pMesh->pIndices, &desc)) {
+            printf("[INFO]: Cannot lay out quantized <%s>, too many vertex layouts\n", pMesh->mName);
+            free(pVertices);
+            continue;
+        }
+
+        uint64_t before = (uint64_t)source.mVertexCount * source.mStride;
+        uint64_t after = (uint64_t)source.mVertexCount * desc.mStride;
+        float step = 0.0f;
+
+        for(uint32_t c = 0; c < 3; c++) {
+            step = fmaxf(step, (pMesh->mMax[c] - pMesh->mMin[c]) / 65535.0f);
+        }
+
+        pQuantizer->pVertices[m] = pVertices;
+        pQuantizer->mBytesBefore += before;
+        pQuantizer->mBytesAfter += after;
+        pQuantizer->mMeshes++;
+
+        // Every vertex is fetched at least once per draw, so saved bytes are also saved fetch bandwidth of each draw
+        printf("[INFO]: Quantized %-16s %2u -> %2u bytes per vertex, %.1f -> %.1f KiB (-%.0f%%), position error %.6f\n", pMesh->mName, source.mStride, desc.mStride, before / 1024.0, after / 1024.0, 100.0 - 100.0 * after / before, step * 0.5f);
+    }
+
+    if(pQuantizer->mMeshes) {
+        printf("[INFO]:     %u meshes in %.2f ms on %u threads, vertex memory and fetch per draw %.1f -> %.1f KiB\n", pQuantizer->mMeshes, UTGetTimeMs() - start, threads, pQuantizer->mBytesBefore / 1024.0, pQuantizer->mBytesAfter / 1024.0);
+    }
+
+    return pQuantizer->mMeshes > 0;
+}
+
+/**
+ * @brief Free quantized vertices, call after MRUpload
+ *
+ * @param pQuantizer
+ */
+void MQReleaseVertices(MeshQuantizer_t* pQuantizer) {
+    for(uint32_t m = 0; m < MR_MAX_MESHES; m++) {
+        free(pQuantizer->pVertices[m]);
+        pQuantizer->pVertices[m] = nullptr;
+    }
+}
+
+#endif
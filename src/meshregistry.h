@@ -0,0 +1,576 @@
+#ifndef __MESH_REGISTRY_
+#define __MESH_REGISTRY_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <glad/gl.h>
+
+#define MR_MAX_MESHES 64
+#define MR_MAX_NAME 32
+#define MR_MAX_ATTRIBUTES 8
+// Distinct vertex layouts, every layout has own vertex array over registry buffer
+#define MR_MAX_FORMATS 8
+
+/**
+ * @brief Single vertex attribute inside interleaved vertex
+ */
+typedef struct MeshAttribute_s {
+    uint32_t mLocation;
+    uint32_t mComponents;
+    GLenum mType;
+    bool mNormalized;
+    // Byte offset inside vertex
+    uint32_t mOffset;
+} MeshAttribute_t;
+
+/**
+ * @brief How mesh vertices look and how they are drawn
+ */
+typedef struct MeshDesc_s {
+    GLenum mPrimitive;
+    uint32_t mVertexCount;
+    // Bytes per vertex
+    uint32_t mStride;
+    MeshAttribute_t mAttributes[MR_MAX_ATTRIBUTES];
+    uint32_t mAttributeCount;
+    // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT, 0 when mesh is not indexed, indices start at 0 for every mesh
+    GLenum mIndexType;
+    uint32_t mIndexCount;
+} MeshDesc_t;
+
+/**
+ * @brief Mesh placed in registry buffer
+ */
+typedef struct MeshEntry_s {
+    char mName[MR_MAX_NAME];
+    MeshDesc_t mDesc;
+    // First vertex of mesh counted in mDesc.mStride units from buffer start
+    uint32_t mBaseVertex;
+    uint64_t mByteOffset;
+    uint64_t mIndexOffset;
+    uint32_t mFormat;
+    float mMin[3], mMax[3];
+
+    // Only valid until MRUpload
+    const void* pVertices;
+    const void* pIndices;
+} MeshEntry_t;
+
+/**
+ * @brief Every mesh uploaded once into single immutable vertex buffer, switching mesh only changes draw range
+ */
+typedef struct MeshRegistry_s {
+    MeshEntry_t mMeshes[MR_MAX_MESHES];
+    uint32_t mCount;
+    uint64_t mSize;
+
+    MeshDesc_t mFormats[MR_MAX_FORMATS];
+    uint32_t mVaos[MR_MAX_FORMATS];
+    uint32_t mFormatCount;
+
+    uint32_t mBuffer;
+} MeshRegistry_t;
+
+/**
+ * @brief Descriptor of triangle list with only vec3 float position at location 0
+ *
+ * @param vertexCount
+ * @return MeshDesc_t
+ */
+MeshDesc_t MRDescPositions(uint32_t vertexCount) {
+    return (MeshDesc_t){
+        .mPrimitive = GL_TRIANGLES,
+        .mVertexCount = vertexCount,
+        .mStride = 3 * sizeof(float),
+        .mAttributes = {{.mLocation = 0, .mComponents = 3, .mType = GL_FLOAT, .mNormalized = false, .mOffset = 0}},
+        .mAttributeCount = 1
+    };
+}
+
+/**
+ * @brief Size of single index
+ *
+ * @param type
+ * @return uint32_t 0 for not indexed mesh
+ */
+uint32_t MRIndexSize(GLenum type) {
+    return type == GL_UNSIGNED_INT ? 4 : (type == GL_UNSIGNED_SHORT ? 2 : 0);
+}
+
+/**
+ * @brief Size of single attribute component
+ *
+ * @param type
+ * @return uint32_t 0 for type which can`t be vertex attribute component
+ */
+uint32_t MRTypeSize(GLenum type) {
+    switch(type) {
+        case GL_BYTE:
+        case GL_UNSIGNED_BYTE:
+            return 1;
+
+        case GL_SHORT:
+        case GL_UNSIGNED_SHORT:
+        case GL_HALF_FLOAT:
+            return 2;
+
+        case GL_INT:
+        case GL_UNSIGNED_INT:
+        case GL_FLOAT:
+            return 4;
+
+        case GL_DOUBLE:
+            return 8;
+
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief Check if two descriptors have same vertex layout (count and primitive don`t matter)
+ *
+ * @param pA
+ * @param pB
+ * @return true
+ * @return false
+ */
+bool MRSameLayout(const MeshDesc_t* pA, const MeshDesc_t* pB) {
+    if(pA->mStride != pB->mStride || pA->mAttributeCount != pB->mAttributeCount) {
+        return false;
+    }
+
+    for(uint32_t i = 0; i < pA->mAttributeCount; i++) {
+        const MeshAttribute_t* a = &pA->mAttributes[i];
+        const MeshAttribute_t* b = &pB->mAttributes[i];
+
+        if(a->mLocation != b->mLocation || a->mComponents != b->mComponents || a->mType != b->mType || a->mNormalized != b->mNormalized || a->mOffset != b->mOffset) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Bounding box of float position at location 0, zero box when mesh has no such attribute
+ *
+ * @param pVertices
+ * @param pDesc
+ * @param pMin
+ * @param pMax
+ */
+void MRBounds(const void* pVertices, const MeshDesc_t* pDesc, float* pMin, float* pMax) {
+    const MeshAttribute_t* pPosition = nullptr;
+
+    for(uint32_t i = 0; i < pDesc->mAttributeCount; i++) {
+        if(pDesc->mAttributes[i].mLocation == 0 && pDesc->mAttributes[i].mType == GL_FLOAT && pDesc->mAttributes[i].mComponents >= 3) {
+            pPosition = &pDesc->mAttributes[i];
+        }
+    }
+
+    for(uint32_t c = 0; c < 3; c++) {
+        pMin[c] = pPosition && pDesc->mVertexCount ? 1e30f : 0.0f;
+        pMax[c] = pPosition && pDesc->mVertexCount ? -1e30f : 0.0f;
+    }
+
+    for(uint32_t i = 0; pPosition && i < pDesc->mVertexCount; i++) {
+        const float* pPos = (const float*)((const uint8_t*)pVertices + (uint64_t)i * pDesc->mStride + pPosition->mOffset);
+
+        for(uint32_t c = 0; c < 3; c++) {
+            pMin[c] = pPos[c] < pMin[c] ? pPos[c] : pMin[c];
+            pMax[c] = pPos[c] > pMax[c] ? pPos[c] : pMax[c];
+        }
+    }
+}
+
+/**
+ * @brief Position attribute at location 0 readable on CPU, float or 16-bit normalized relative to mesh bounds
+ *
+ * @param pDesc
+ * @return const MeshAttribute_t* nullptr when mesh has no such attribute
+ */
+const MeshAttribute_t* MRPositionAttribute(const MeshDesc_t* pDesc) {
+    for(uint32_t i = 0; i < pDesc->mAttributeCount; i++) {
+        const MeshAttribute_t* pAttribute = &pDesc->mAttributes[i];
+
+        if(pAttribute->mLocation != 0) {
+            continue;
+        }
+
+        bool floats = pAttribute->mType == GL_FLOAT && pAttribute->mComponents >= 3;
+        bool quantized = pAttribute->mType == GL_UNSIGNED_SHORT && pAttribute->mNormalized && pAttribute->mComponents >= 3;
+
+        return floats || quantized ? pAttribute : nullptr;
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief Matrix taking position attribute into mesh units, identity for float positions, bounds box for quantized ones
+ *
+ * @param pMesh
+ * @param pMatrix column-major output
+ */
+void MRDecodeMatrix(const MeshEntry_t* pMesh, float* pMatrix) {
+    const MeshAttribute_t* pPosition = MRPositionAttribute(&pMesh->mDesc);
+    bool quantized = pPosition && pPosition->mType == GL_UNSIGNED_SHORT;
+
+    memset(pMatrix, 0, 16 * sizeof(float));
+
+    for(uint32_t c = 0; c < 3; c++) {
+        pMatrix[c * 5] = quantized ? pMesh->mMax[c] - pMesh->mMin[c] : 1.0f;
+        pMatrix[12 + c] = quantized ? pMesh->mMin[c] : 0.0f;
+    }
+
+    pMatrix[15] = 1.0f;
+}
+
+/**
+ * @brief Decode positions of mesh into packed float3 in mesh units, call before MRUpload while vertices are alive
+ *
+ * @param pMesh
+ * @return float* malloc`d mDesc.mVertexCount positions, nullptr when mesh has no readable position or out of memory
+ */
+float* MRDecodePositions(const MeshEntry_t* pMesh) {
+    const MeshAttribute_t* pPosition = MRPositionAttribute(&pMesh->mDesc);
+
+    if(!pPosition || !pMesh->pVertices) {
+        return nullptr;
+    }
+
+    uint32_t count = pMesh->mDesc.mVertexCount;
+    float* pOut = (float*)malloc((uint64_t)(count ? count : 1) * 3 * sizeof(float));
+
+    if(!pOut) {
+        return nullptr;
+    }
+
+    float decode[16];
+    MRDecodeMatrix(pMesh, decode);
+
+    for(uint32_t i = 0; i < count; i++) {
+        const uint8_t* pVertex = (const uint8_t*)pMesh->pVertices + (uint64_t)i * pMesh->mDesc.mStride + pPosition->mOffset;
+
+        if(pPosition->mType == GL_FLOAT) {
+            memcpy(&pOut[(uint64_t)i * 3], pVertex, 3 * sizeof(float));
+            continue;
+        }
+
+        uint16_t q[3];
+        memcpy(q, pVertex, sizeof(q));
+
+        for(uint32_t c = 0; c < 3; c++) {
+            pOut[(uint64_t)i * 3 + c] = decode[12 + c] + q[c] / 65535.0f * decode[c * 5];
+        }
+    }
+
+    return pOut;
+}
+
+/**
+ * @brief Add mesh with known bounds, vertices are not touched until MRUpload
+ *
+ * @param pRegistry
+ * @param name
+ * @param pVertices interleaved vertices described by pDesc, must stay alive until MRUpload
+ * @param pIndices indices of pDesc->mIndexType or nullptr
+ * @param pDesc
+ * @param pMin
+ * @param pMax
+ * @return int32_t mesh index or -1
+ */
+int32_t MRAddBounded(MeshRegistry_t* pRegistry, const char* name, const void* pVertices, const void* pIndices, const MeshDesc_t* pDesc, const float* pMin, const float* pMax) {
+    if(pRegistry->mBuffer || pRegistry->mCount >= MR_MAX_MESHES || pDesc->mStride == 0) {
+        printf("[INFO]: Cannot add mesh <%s>, registry is full or already uploaded\n", name);
+
+        return -1;
+    }
+
+    uint32_t format = 0;
+
+    while(format < pRegistry->mFormatCount && !MRSameLayout(&pRegistry->mFormats[format], pDesc)) {
+        format++;
+    }
+
+    if(format == MR_MAX_FORMATS) {
+        printf("[INFO]: Cannot add mesh <%s>, too many vertex layouts\n", name);
+
+        return -1;
+    }
+
+    if(format == pRegistry->mFormatCount) {
+        pRegistry->mFormats[pRegistry->mFormatCount++] = *pDesc;
+    }
+
+    MeshEntry_t* pMesh = &pRegistry->mMeshes[pRegistry->mCount];
+
+    // Align mesh to its stride so it can be drawn with first vertex from shared vertex array
+    uint64_t offset = (pRegistry->mSize + pDesc->mStride - 1) / pDesc->mStride * pDesc->mStride;
+
+    snprintf(pMesh->mName, MR_MAX_NAME, "%s", name);
+    pMesh->mDesc = *pDesc;
+    pMesh->mByteOffset = offset;
+    pMesh->mBaseVertex = offset / pDesc->mStride;
+    pMesh->mFormat = format;
+    pMesh->pVertices = pVertices;
+    pMesh->pIndices = pDesc->mIndexType ? pIndices : nullptr;
+
+    memcpy(pMesh->mMin, pMin, sizeof(pMesh->mMin));
+    memcpy(pMesh->mMax, pMax, sizeof(pMesh->mMax));
+
+    pRegistry->mSize = offset + (uint64_t)pDesc->mVertexCount * pDesc->mStride;
+
+    // Indices live in same buffer right after vertices
+    if(pMesh->pIndices) {
+        pMesh->mIndexOffset = (pRegistry->mSize + 3) / 4 * 4;
+        pRegistry->mSize = pMesh->mIndexOffset + (uint64_t)pDesc->mIndexCount * MRIndexSize(pDesc->mIndexType);
+    }
+    else {
+        pMesh->mDesc.mIndexType = 0;
+        pMesh->mDesc.mIndexCount = 0;
+    }
+
+    return pRegistry->mCount++;
+}
+
+/**
+ * @brief Add mesh, vertices and indices must stay alive until MRUpload
+ *
+ * @param pRegistry
+ * @param name
+ * @param pVertices interleaved vertices described by pDesc
+ * @param pIndices indices of pDesc->mIndexType or nullptr
+ * @param pDesc
+ * @return int32_t mesh index or -1
+ */
+int32_t MRAdd(MeshRegistry_t* pRegistry, const char* name, const void* pVertices, const void* pIndices, const MeshDesc_t* pDesc) {
+    float min[3], max[3];
+
+    MRBounds(pVertices, pDesc, min, max);
+
+    return MRAddBounded(pRegistry, name, pVertices, pIndices, pDesc, min, max);
+}
+
+/**
+ * @brief Add another index list over vertices of already added mesh (LOD), vertices are stored only once
+ *
+ * @param pRegistry
+ * @param name
+ * @param mesh mesh whose vertices are indexed
+ * @param pIndices indices of mesh index type, must stay alive until MRUpload
+ * @param indexCount
+ * @return int32_t mesh index or -1
+ */
+int32_t MRAddIndices(MeshRegistry_t* pRegistry, const char* name, uint32_t mesh, const void* pIndices, uint32_t indexCount) {
+    if(pRegistry->mBuffer || pRegistry->mCount >= MR_MAX_MESHES || mesh >= pRegistry->mCount || !pRegistry->mMeshes[mesh].mDesc.mIndexType) {
+        printf("[INFO]: Cannot add indices <%s>, registry is full, already uploaded or mesh isn`t indexed\n", name);
+
+        return -1;
+    }
+
+    MeshEntry_t* pMesh = &pRegistry->mMeshes[pRegistry->mCount];
+
+    *pMesh = pRegistry->mMeshes[mesh];
+    snprintf(pMesh->mName, MR_MAX_NAME, "%s", name);
+
+    // Vertices are copied with source mesh
+    pMesh->pVertices = nullptr;
+    pMesh->pIndices = pIndices;
+    pMesh->mDesc.mIndexCount = indexCount;
+    pMesh->mIndexOffset = (pRegistry->mSize + 3) / 4 * 4;
+
+    pRegistry->mSize = pMesh->mIndexOffset + (uint64_t)indexCount * MRIndexSize(pMesh->mDesc.mIndexType);
+
+    return pRegistry->mCount++;
+}
+
+/**
+ * @brief Replace vertices, indices and layout of mesh before MRUpload and lay registry out again, mesh indices and bounds don`t change
+ *
+ * Index lists added with MRAddIndices follow their mesh, so replacing mesh they index must keep its vertices
+ *
+ * @param pRegistry
+ * @param mesh
+ * @param pVertices must stay alive until MRUpload
+ * @param pIndices indices of pDesc->mIndexType or nullptr, must stay alive until MRUpload
+ * @param pDesc
+ * @return true
+ * @return false registry is already uploaded, out of memory or new layout doesn`t fit
+ */
+bool MRReplace(MeshRegistry_t* pRegistry, uint32_t mesh, const void* pVertices, const void* pIndices, const MeshDesc_t* pDesc) {
+    if(pRegistry->mBuffer || mesh >= pRegistry->mCount || !pRegistry->mMeshes[mesh].pVertices) {
+        return false;
+    }
+
+    MeshRegistry_t* pSource = (MeshRegistry_t*)malloc(sizeof(MeshRegistry_t));
+
+    if(!pSource) {
+        return false;
+    }
+
+    memcpy(pSource, pRegistry, sizeof(MeshRegistry_t));
+
+    // Same meshes in same order, offsets and layouts follow new strides
+    memset(pRegistry, 0, sizeof(MeshRegistry_t));
+
+    for(uint32_t m = 0; m < pSource->mCount; m++) {
+        const MeshEntry_t* pMesh = &pSource->mMeshes[m];
+
+        if(m == mesh) {
+            MRAddBounded(pRegistry, pMesh->mName, pVertices, pIndices, pDesc, pMesh->mMin, pMesh->mMax);
+            continue;
+        }
+
+        if(pMesh->pVertices) {
+            MRAddBounded(pRegistry, pMesh->mName, pMesh->pVertices, pMesh->pIndices, &pMesh->mDesc, pMesh->mMin, pMesh->mMax);
+            continue;
+        }
+
+        // Index lists over vertices of earlier mesh follow it
+        for(uint32_t parent = 0; parent < m; parent++) {
+            if(pSource->mMeshes[parent].pVertices && pSource->mMeshes[parent].mByteOffset == pMesh->mByteOffset) {
+                MRAddIndices(pRegistry, pMesh->mName, parent, pMesh->pIndices, pMesh->mDesc.mIndexCount);
+                break;
+            }
+        }
+    }
+
+    bool result = pRegistry->mCount == pSource->mCount;
+
+    // Layout which doesn`t fit leaves registry as it was
+    if(!result) {
+        memcpy(pRegistry, pSource, sizeof(MeshRegistry_t));
+    }
+
+    free(pSource);
+
+    return result;
+}
+
+/**
+ * @brief Copy every mesh into one immutable buffer and create vertex array for every layout
+ *
+ * @param pRegistry
+ * @return true
+ * @return false nothing to upload or buffer can`t be mapped
+ */
+bool MRUpload(MeshRegistry_t* pRegistry) {
+    if(pRegistry->mCount == 0 || pRegistry->mSize == 0) {
+        return false;
+    }
+
+    // Only write access for initial fill, sources (possibly memory mapped files) are copied straight into buffer
+    glCreateBuffers(1, &pRegistry->mBuffer);
+    glNamedBufferStorage(pRegistry->mBuffer, pRegistry->mSize, nullptr, GL_MAP_WRITE_BIT);
+
+    uint8_t* pData = (uint8_t*)glMapNamedBufferRange(pRegistry->mBuffer, 0, pRegistry->mSize, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+
+    if(!pData) {
+        glDeleteBuffers(1, &pRegistry->mBuffer);
+        pRegistry->mBuffer = 0;
+
+        return false;
+    }
+
+    uint64_t vertices = 0;
+
+    for(uint32_t i = 0; i < pRegistry->mCount; i++) {
+        MeshEntry_t* pMesh = &pRegistry->mMeshes[i];
+
+        // Meshes sharing vertices of other mesh have none of their own
+        if(pMesh->pVertices) {
+            memcpy(pData + pMesh->mByteOffset, pMesh->pVertices, (uint64_t)pMesh->mDesc.mVertexCount * pMesh->mDesc.mStride);
+            vertices += pMesh->mDesc.mVertexCount;
+        }
+
+        pMesh->pVertices = nullptr;
+
+        if(pMesh->pIndices) {
+            memcpy(pData + pMesh->mIndexOffset, pMesh->pIndices, (uint64_t)pMesh->mDesc.mIndexCount * MRIndexSize(pMesh->mDesc.mIndexType));
+            pMesh->pIndices = nullptr;
+        }
+    }
+
+    if(!glUnmapNamedBuffer(pRegistry->mBuffer)) {
+        printf("[INFO]: Mesh registry buffer was lost while filling it\n");
+    }
+
+    for(uint32_t f = 0; f < pRegistry->mFormatCount; f++) {
+        MeshDesc_t* pFormat = &pRegistry->mFormats[f];
+
+        glCreateVertexArrays(1, &pRegistry->mVaos[f]);
+        glVertexArrayVertexBuffer(pRegistry->mVaos[f], 0, pRegistry->mBuffer, 0, pFormat->mStride);
+        glVertexArrayElementBuffer(pRegistry->mVaos[f], pRegistry->mBuffer);
+
+        for(uint32_t i = 0; i < pFormat->mAttributeCount; i++) {
+            MeshAttribute_t* pAttribute = &pFormat->mAttributes[i];
+
+            glVertexArrayAttribFormat(pRegistry->mVaos[f], pAttribute->mLocation, pAttribute->mComponents, pAttribute->mType, pAttribute->mNormalized, pAttribute->mOffset);
+            glVertexArrayAttribBinding(pRegistry->mVaos[f], pAttribute->mLocation, 0);
+            glEnableVertexArrayAttrib(pRegistry->mVaos[f], pAttribute->mLocation);
+        }
+    }
+
+    printf("[INFO]: Mesh registry: %u meshes, %llu vertices, %u layouts, %.1f KiB\n", pRegistry->mCount, (unsigned long long)vertices, pRegistry->mFormatCount, pRegistry->mSize / 1024.0);
+
+    for(uint32_t i = 0; i < pRegistry->mCount; i++) {
+        MeshEntry_t* pMesh = &pRegistry->mMeshes[i];
+
+        printf("[INFO]:     %-16s base %6u count %6u indices %7u stride %2u bounds (%.2f %.2f %.2f) (%.2f %.2f %.2f)\n", pMesh->mName, pMesh->mBaseVertex, pMesh->mDesc.mVertexCount, pMesh->mDesc.mIndexCount, pMesh->mDesc.mStride, pMesh->mMin[0], pMesh->mMin[1], pMesh->mMin[2], pMesh->mMax[0], pMesh->mMax[1], pMesh->mMax[2]);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Bind vertex array of mesh layout and draw instances of it in one call
+ *
+ * @param pRegistry
+ * @param mesh
+ * @param instances
+ */
+void MRDrawInstanced(MeshRegistry_t* pRegistry, uint32_t mesh, uint32_t instances) {
+    if(mesh >= pRegistry->mCount || !pRegistry->mBuffer) {
+        return;
+    }
+
+    MeshEntry_t* pMesh = &pRegistry->mMeshes[mesh];
+
+    glBindVertexArray(pRegistry->mVaos[pMesh->mFormat]);
+
+    if(pMesh->mDesc.mIndexType) {
+        glDrawElementsInstancedBaseVertex(pMesh->mDesc.mPrimitive, pMesh->mDesc.mIndexCount, pMesh->mDesc.mIndexType, (const void*)(uintptr_t)pMesh->mIndexOffset, instances, pMesh->mBaseVertex);
+    }
+    else {
+        glDrawArraysInstanced(pMesh->mDesc.mPrimitive, pMesh->mBaseVertex, pMesh->mDesc.mVertexCount, instances);
+    }
+}
+
+/**
+ * @brief Bind vertex array of mesh layout and draw it as its descriptor says
+ *
+ * @param pRegistry
+ * @param mesh
+ */
+void MRDraw(MeshRegistry_t* pRegistry, uint32_t mesh) {
+    MRDrawInstanced(pRegistry, mesh, 1);
+}
+
+/**
+ * @brief Delete buffer and vertex arrays
+ *
+ * @param pRegistry
+ */
+void MRTerminate(MeshRegistry_t* pRegistry) {
+    glDeleteVertexArrays(pRegistry->mFormatCount, pRegistry->mVaos);
+    glDeleteBuffers(1, &pRegistry->mBuffer);
+
+    memset(pRegistry, 0, sizeof(MeshRegistry_t));
+}
+
+#endif
@@ -0,0 +1,799 @@
+#ifndef __MESH_SIMPLIFY_
+#define __MESH_SIMPLIFY_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include <glad/gl.h>
+
+#include "utils.h"
+#include "meshregistry.h"
+#include "meshindex.h"
+
+#define MS_MAX_LODS 8
+// Border edges are held by planes perpendicular to their triangle, weighted so open edges barely move
+#define MS_BORDER_WEIGHT 10.0f
+// Coarsest LOD whose error projects under this many pixels is drawn
+#define MS_PIXEL_ERROR 1.0f
+
+/**
+ * @brief Symmetric 4x4 plane quadric (a2 ab ac ad b2 bc bd c2 cd d2) and sum of plane weights
+ */
+typedef struct MSQuadric_s {
+    float m[10];
+    float mWeight;
+} MSQuadric_t;
+
+/**
+ * @brief LOD chain of registry mesh, every level is index list over vertices of level 0
+ */
+typedef struct MeshLods_s {
+    // Registry meshes from finest to coarsest, mMeshes[0] is source mesh
+    uint32_t mMeshes[MS_MAX_LODS + 1];
+    uint32_t mTriangles[MS_MAX_LODS + 1];
+    // Largest distance of simplified surface from source in mesh units
+    float mErrors[MS_MAX_LODS + 1];
+    uint32_t mCount;
+
+    // Level picked by last MSSelectLod and its error in pixels
+    uint32_t mSelected;
+    float mSelectedPixels;
+
+    // Simplified indices of every level, needed until MRUpload
+    void* pIndices[MS_MAX_LODS + 1];
+} MeshLods_t;
+
+/**
+ * @brief Parse comma separated triangle ratios like "0.5,0.25,0.1", every ratio is of source mesh
+ *
+ * @param spec
+ * @param pRatios output, up to MS_MAX_LODS
+ * @return uint32_t ratio count, 0 when any ratio isn`t in (0, 1)
+ */
+uint32_t MSParseRatios(const char* spec, float* pRatios) {
+    uint32_t count = 0;
+
+    while(*spec && count < MS_MAX_LODS) {
+        char* pEnd = nullptr;
+        float ratio = strtof(spec, &pEnd);
+
+        if(pEnd == spec || ratio <= 0.0f || ratio >= 1.0f) {
+            return 0;
+        }
+
+        pRatios[count++] = ratio;
+        spec = *pEnd == ',' ? pEnd + 1 : pEnd;
+
+        if(pEnd == spec && *spec) {
+            return 0;
+        }
+    }
+
+    return count;
+}
+
+void __MSAddPlane(MSQuadric_t* pQuadric, float a, float b, float c, float d, float weight) {
+    float* m = pQuadric->m;
+
+    m[0] += weight * a * a;
+    m[1] += weight * a * b;
+    m[2] += weight * a * c;
+    m[3] += weight * a * d;
+    m[4] += weight * b * b;
+    m[5] += weight * b * c;
+    m[6] += weight * b * d;
+    m[7] += weight * c * c;
+    m[8] += weight * c * d;
+    m[9] += weight * d * d;
+    pQuadric->mWeight += weight;
+}
+
+/**
+ * @brief Squared distance of point from planes of both quadrics, averaged by weight
+ *
+ * @param pA
+ * @param pB
+ * @param p
+ * @return float
+ */
+float __MSError(const MSQuadric_t* pA, const MSQuadric_t* pB, const float* p) {
+    float m[10];
+
+    for(uint32_t i = 0; i < 10; i++) {
+        m[i] = pA->m[i] + pB->m[i];
+    }
+
+    float x = p[0], y = p[1], z = p[2];
+    float error = m[0] * x * x + 2.0f * m[1] * x * y + 2.0f * m[2] * x * z + 2.0f * m[3] * x
+                + m[4] * y * y + 2.0f * m[5] * y * z + 2.0f * m[6] * y
+                + m[7] * z * z + 2.0f * m[8] * z
+                + m[9];
+    float weight = pA->mWeight + pB->mWeight;
+
+    return weight > 0.0f ? fabsf(error) / weight : 0.0f;
+}
+
+void __MSNormal(const float* p0, const float* p1, const float* p2, float* pOut) {
+    float e0[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+    float e1[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+
+    pOut[0] = e0[1] * e1[2] - e0[2] * e1[1];
+    pOut[1] = e0[2] * e1[0] - e0[0] * e1[2];
+    pOut[2] = e0[0] * e1[1] - e0[1] * e1[0];
+}
+
+typedef struct __MSCollapse_s {
+    float mError;
+    // Position of mFrom moves to mTo
+    uint32_t mFrom;
+    uint32_t mTo;
+} __MSCollapse_t;
+
+int __MSCompareCollapses(const void* a, const void* b) {
+    float ea = ((const __MSCollapse_t*)a)->mError, eb = ((const __MSCollapse_t*)b)->mError;
+
+    return (ea > eb) - (ea < eb);
+}
+
+/**
+ * @brief Working state of one simplification, vertices are welded by position so attribute seams don`t look like holes
+ *
+ * Position shared by several vertices is on seam, its vertices move together onto vertices of target taken from triangles along collapsed edge
+ */
+typedef struct __MSState_s {
+    uint32_t* pIndices;
+    uint32_t mTriangles;
+    uint32_t mVertexCount;
+
+    // Position id of every vertex
+    uint32_t* pRemap;
+    float* pPositions;
+    uint32_t mPositionCount;
+
+    // Vertex every vertex of collapsed position becomes, valid when its mark is current
+    uint32_t* pTargets;
+    uint32_t* pTargetMarks;
+    uint32_t mTargetMark;
+
+    MSQuadric_t* pQuadrics;
+
+    // Triangles of every position, CSR
+    uint32_t* pOffsets;
+    uint32_t* pAdjacency;
+    uint8_t* pBorder;
+    uint32_t* pStamps;
+    // Neighbour marks of link check
+    uint32_t* pMarks;
+    uint32_t mMark;
+} __MSState_t;
+
+void __MSFree(__MSState_t* pState) {
+    free(pState->pIndices);
+    free(pState->pRemap);
+    free(pState->pPositions);
+    free(pState->pTargets);
+    free(pState->pTargetMarks);
+    free(pState->pQuadrics);
+    free(pState->pOffsets);
+    free(pState->pAdjacency);
+    free(pState->pBorder);
+    free(pState->pStamps);
+    free(pState->pMarks);
+}
+
+uint32_t __MSPosition(const __MSState_t* pState, uint32_t triangle, uint32_t corner) {
+    return pState->pRemap[pState->pIndices[triangle * 3 + corner]];
+}
+
+/**
+ * @brief Vertex of triangle at position, triangle must have it
+ */
+uint32_t __MSVertexAt(const __MSState_t* pState, uint32_t triangle, uint32_t position) {
+    for(uint32_t k = 0; k < 2; k++) {
+        if(__MSPosition(pState, triangle, k) == position) {
+            return pState->pIndices[triangle * 3 + k];
+        }
+    }
+
+    return pState->pIndices[triangle * 3 + 2];
+}
+
+/**
+ * @brief Rebuild position to triangle adjacency and mark positions on open edges
+ *
+ * @param pState
+ */
+void __MSAdjacency(__MSState_t* pState) {
+    memset(pState->pOffsets, 0, (pState->mPositionCount + 1) * sizeof(uint32_t));
+    memset(pState->pBorder, 0, pState->mPositionCount);
+
+    for(uint32_t t = 0; t < pState->mTriangles; t++) {
+        for(uint32_t k = 0; k < 3; k++) {
+            pState->pOffsets[__MSPosition(pState, t, k) + 1]++;
+        }
+    }
+
+    for(uint32_t p = 0; p < pState->mPositionCount; p++) {
+        pState->pOffsets[p + 1] += pState->pOffsets[p];
+    }
+
+    // Offsets are used as fill cursors, afterwards every one points at end of its list and is shifted back
+    for(uint32_t t = 0; t < pState->mTriangles; t++) {
+        for(uint32_t k = 0; k < 3; k++) {
+            pState->pAdjacency[pState->pOffsets[__MSPosition(pState, t, k)]++] = t;
+        }
+    }
+
+    for(uint32_t p = pState->mPositionCount; p > 0; p--) {
+        pState->pOffsets[p] = pState->pOffsets[p - 1];
+    }
+
+    pState->pOffsets[0] = 0;
+
+    // Edge is open when no other triangle around its start has it
+    for(uint32_t t = 0; t < pState->mTriangles; t++) {
+        for(uint32_t k = 0; k < 3; k++) {
+            uint32_t a = __MSPosition(pState, t, k), b = __MSPosition(pState, t, (k + 1) % 3);
+            uint32_t shared = 0;
+
+            for(uint32_t j = pState->pOffsets[a]; j < pState->pOffsets[a + 1]; j++) {
+                uint32_t other = pState->pAdjacency[j];
+
+                if(other != t && (__MSPosition(pState, other, 0) == b || __MSPosition(pState, other, 1) == b || __MSPosition(pState, other, 2) == b)) {
+                    shared++;
+                }
+            }
+
+            if(shared == 0) {
+                pState->pBorder[a] = 1;
+                pState->pBorder[b] = 1;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Whether triangle has edge between two positions
+ */
+bool __MSHasEdge(const __MSState_t* pState, uint32_t triangle, uint32_t a, uint32_t b) {
+    uint32_t p[3] = {__MSPosition(pState, triangle, 0), __MSPosition(pState, triangle, 1), __MSPosition(pState, triangle, 2)};
+
+    return (p[0] == a || p[1] == a || p[2] == a) && (p[0] == b || p[1] == b || p[2] == b);
+}
+
+/**
+ * @brief Moving position from onto to must not flip any remaining triangle around from
+ */
+bool __MSCollapseFlips(const __MSState_t* pState, uint32_t from, uint32_t to) {
+    const float* pTo = &pState->pPositions[(uint64_t)to * 3];
+
+    for(uint32_t j = pState->pOffsets[from]; j < pState->pOffsets[from + 1]; j++) {
+        uint32_t t = pState->pAdjacency[j];
+
+        if(__MSHasEdge(pState, t, from, to)) {
+            continue;
+        }
+
+        const float* p[3];
+        const float* q[3];
+
+        for(uint32_t k = 0; k < 3; k++) {
+            uint32_t position = __MSPosition(pState, t, k);
+
+            p[k] = &pState->pPositions[(uint64_t)position * 3];
+            q[k] = position == from ? pTo : p[k];
+        }
+
+        float before[3], after[3];
+
+        __MSNormal(p[0], p[1], p[2], before);
+        __MSNormal(q[0], q[1], q[2], after);
+
+        if(before[0] * after[0] + before[1] * after[1] + before[2] * after[2] <= 0.0f) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Positions next to both ends of edge must be just tips of its triangles, otherwise collapse pinches surface into non-manifold fold
+ */
+bool __MSLinkBroken(__MSState_t* pState, uint32_t from, uint32_t to) {
+    uint32_t mark = ++pState->mMark;
+    uint32_t common = 0, shared = 0;
+
+    for(uint32_t j = pState->pOffsets[from]; j < pState->pOffsets[from + 1]; j++) {
+        for(uint32_t k = 0; k < 3; k++) {
+            pState->pMarks[__MSPosition(pState, pState->pAdjacency[j], k)] = mark;
+        }
+    }
+
+    for(uint32_t j = pState->pOffsets[to]; j < pState->pOffsets[to + 1]; j++) {
+        uint32_t t = pState->pAdjacency[j];
+
+        shared += __MSHasEdge(pState, t, from, to);
+
+        for(uint32_t k = 0; k < 3; k++) {
+            uint32_t p = __MSPosition(pState, t, k);
+
+            if(p != from && p != to && pState->pMarks[p] == mark) {
+                pState->pMarks[p] = mark - 1;
+                common++;
+            }
+        }
+    }
+
+    return common != shared;
+}
+
+/**
+ * @brief Pick vertex of to for every vertex of from from triangles along collapsed edge, so attributes stay continuous and seams only slide along themselves
+ *
+ * @param pState
+ * @param from
+ * @param to
+ * @return true pState->pTargets is set for every vertex of from
+ * @return false some vertex of from has no triangle along edge (collapse would cross seam) or two with different vertices of to
+ */
+bool __MSSeamTargets(__MSState_t* pState, uint32_t from, uint32_t to) {
+    uint32_t mark = ++pState->mTargetMark;
+
+    for(uint32_t j = pState->pOffsets[from]; j < pState->pOffsets[from + 1]; j++) {
+        uint32_t t = pState->pAdjacency[j];
+
+        if(!__MSHasEdge(pState, t, from, to)) {
+            continue;
+        }
+
+        uint32_t v = __MSVertexAt(pState, t, from), w = __MSVertexAt(pState, t, to);
+
+        if(pState->pTargetMarks[v] == mark && pState->pTargets[v] != w) {
+            return false;
+        }
+
+        pState->pTargetMarks[v] = mark;
+        pState->pTargets[v] = w;
+    }
+
+    for(uint32_t j = pState->pOffsets[from]; j < pState->pOffsets[from + 1]; j++) {
+        if(pState->pTargetMarks[__MSVertexAt(pState, pState->pAdjacency[j], from)] != mark) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Simplify triangle list by collapsing edges with smallest quadric error, vertices only move onto existing vertices so vertex buffer is shared with source
+ *
+ * @param pVertices
+ * @param pDesc float3 position at location 0, indexed GL_TRIANGLES
+ * @param pIndices source indices of pDesc->mIndexType
+ * @param pOut output, up to pDesc->mIndexCount indices
+ * @param targetTriangles
+ * @param pError receives largest distance of result from source
+ * @return uint32_t output index count, 0 when out of memory or mesh can`t be simplified
+ */
+uint32_t MSSimplify(const void* pVertices, const MeshDesc_t* pDesc, const void* pIndices, uint32_t* pOut, uint32_t targetTriangles, float* pError) {
+    __MSState_t state = {0};
+    uint32_t position = 0;
+
+    *pError = 0.0f;
+
+    for(uint32_t i = 0; i < pDesc->mAttributeCount; i++) {
+        if(pDesc->mAttributes[i].mLocation == 0) {
+            position = pDesc->mAttributes[i].mOffset;
+        }
+    }
+
+    state.mTriangles = pDesc->mIndexCount / 3;
+    state.mVertexCount = pDesc->mVertexCount;
+    state.pIndices = (uint32_t*)malloc((uint64_t)(state.mTriangles ? state.mTriangles : 1) * 3 * sizeof(uint32_t));
+    state.pRemap = (uint32_t*)malloc((uint64_t)(state.mVertexCount ? state.mVertexCount : 1) * sizeof(uint32_t));
+    state.pPositions = (float*)malloc((uint64_t)(state.mVertexCount ? state.mVertexCount : 1) * 3 * sizeof(float));
+    state.pTargets = (uint32_t*)malloc((uint64_t)(state.mVertexCount ? state.mVertexCount : 1) * sizeof(uint32_t));
+    state.pTargetMarks = (uint32_t*)calloc(state.mVertexCount ? state.mVertexCount : 1, sizeof(uint32_t));
+    state.pQuadrics = (MSQuadric_t*)calloc(state.mVertexCount ? state.mVertexCount : 1, sizeof(MSQuadric_t));
+    state.pOffsets = (uint32_t*)malloc((uint64_t)(state.mVertexCount + 1) * sizeof(uint32_t));
+    state.pAdjacency = (uint32_t*)malloc((uint64_t)(state.mTriangles ? state.mTriangles : 1) * 3 * sizeof(uint32_t));
+    state.pBorder = (uint8_t*)malloc(state.mVertexCount ? state.mVertexCount : 1);
+    state.pStamps = (uint32_t*)calloc(state.mVertexCount ? state.mVertexCount : 1, sizeof(uint32_t));
+    state.pMarks = (uint32_t*)calloc(state.mVertexCount ? state.mVertexCount : 1, sizeof(uint32_t));
+
+    __MSCollapse_t* pCollapses = (__MSCollapse_t*)malloc((uint64_t)(state.mTriangles ? state.mTriangles : 1) * 6 * sizeof(__MSCollapse_t));
+    float* pPacked = (float*)malloc((uint64_t)(state.mVertexCount ? state.mVertexCount : 1) * 3 * sizeof(float));
+
+    if(!state.pIndices || !state.pRemap || !state.pPositions || !state.pTargets || !state.pTargetMarks || !state.pQuadrics || !state.pOffsets || !state.pAdjacency || !state.pBorder || !state.pStamps || !state.pMarks || !pCollapses || !pPacked) {
+        __MSFree(&state);
+        free(pCollapses);
+        free(pPacked);
+
+        return 0;
+    }
+
+    for(uint32_t i = 0; i < state.mTriangles * 3; i++) {
+        state.pIndices[i] = pDesc->mIndexType == GL_UNSIGNED_SHORT ? ((const uint16_t*)pIndices)[i] : ((const uint32_t*)pIndices)[i];
+    }
+
+    for(uint32_t v = 0; v < state.mVertexCount; v++) {
+        memcpy(&pPacked[(uint64_t)v * 3], (const uint8_t*)pVertices + (uint64_t)v * pDesc->mStride + position, 3 * sizeof(float));
+    }
+
+    state.mPositionCount = MIWeld(pPacked, state.mVertexCount, 3 * sizeof(float), state.pPositions, state.pRemap);
+    free(pPacked);
+
+    __MSAdjacency(&state);
+
+    // Planes of triangles, area weighted, and of open and seam edges
+    for(uint32_t t = 0; t < state.mTriangles; t++) {
+        uint32_t p[3] = {__MSPosition(&state, t, 0), __MSPosition(&state, t, 1), __MSPosition(&state, t, 2)};
+        const float* v[3] = {&state.pPositions[(uint64_t)p[0] * 3], &state.pPositions[(uint64_t)p[1] * 3], &state.pPositions[(uint64_t)p[2] * 3]};
+        float n[3];
+
+        __MSNormal(v[0], v[1], v[2], n);
+
+        float length = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+        if(length <= 0.0f) {
+            continue;
+        }
+
+        n[0] /= length;
+        n[1] /= length;
+        n[2] /= length;
+
+        float d = -(n[0] * v[0][0] + n[1] * v[0][1] + n[2] * v[0][2]);
+
+        for(uint32_t k = 0; k < 3; k++) {
+            __MSAddPlane(&state.pQuadrics[p[k]], n[0], n[1], n[2], d, length * 0.5f);
+        }
+
+        for(uint32_t k = 0; k < 3; k++) {
+            uint32_t a = p[k], b = p[(k + 1) % 3];
+            bool open = true, seam = false;
+
+            // Seam edge has different vertices on other side, it is held like open edge so seam keeps its shape
+            for(uint32_t j = state.pOffsets[a]; j < state.pOffsets[a + 1] && open; j++) {
+                uint32_t other = state.pAdjacency[j];
+
+                if(other == t || !__MSHasEdge(&state, other, a, b)) {
+                    continue;
+                }
+
+                open = false;
+                seam = __MSVertexAt(&state, other, a) != state.pIndices[t * 3 + k] || __MSVertexAt(&state, other, b) != state.pIndices[t * 3 + (k + 1) % 3];
+            }
+
+            if(!open && !seam) {
+                continue;
+            }
+
+            const float* pa = v[k];
+            const float* pb = v[(k + 1) % 3];
+            float edge[3] = {pb[0] - pa[0], pb[1] - pa[1], pb[2] - pa[2]};
+            float e = edge[0] * edge[0] + edge[1] * edge[1] + edge[2] * edge[2];
+            float side[3] = {edge[1] * n[2] - edge[2] * n[1], edge[2] * n[0] - edge[0] * n[2], edge[0] * n[1] - edge[1] * n[0]};
+            float sideLength = sqrtf(side[0] * side[0] + side[1] * side[1] + side[2] * side[2]);
+
+            if(sideLength <= 0.0f) {
+                continue;
+            }
+
+            side[0] /= sideLength;
+            side[1] /= sideLength;
+            side[2] /= sideLength;
+
+            float sd = -(side[0] * pa[0] + side[1] * pa[1] + side[2] * pa[2]);
+
+            __MSAddPlane(&state.pQuadrics[a], side[0], side[1], side[2], sd, e * MS_BORDER_WEIGHT);
+            __MSAddPlane(&state.pQuadrics[b], side[0], side[1], side[2], sd, e * MS_BORDER_WEIGHT);
+        }
+    }
+
+    uint32_t pass = 0;
+    float maxError = 0.0f;
+
+    // Every pass collapses cheapest independent edges, then compacts triangles and rebuilds adjacency
+    while(state.mTriangles > targetTriangles) {
+        uint32_t collapses = 0;
+
+        pass++;
+
+        for(uint32_t t = 0; t < state.mTriangles; t++) {
+            for(uint32_t k = 0; k < 3; k++) {
+                for(uint32_t direction = 0; direction < 2; direction++) {
+                    uint32_t from = __MSPosition(&state, t, direction ? (k + 1) % 3 : k);
+                    uint32_t to = __MSPosition(&state, t, direction ? k : (k + 1) % 3);
+
+                    // Open edge positions only slide along open edges
+                    if(from == to || (state.pBorder[from] && !state.pBorder[to])) {
+                        continue;
+                    }
+
+                    pCollapses[collapses++] = (__MSCollapse_t){
+                        .mError = __MSError(&state.pQuadrics[from], &state.pQuadrics[to], &state.pPositions[(uint64_t)to * 3]),
+                        .mFrom = from,
+                        .mTo = to
+                    };
+                }
+            }
+        }
+
+        qsort(pCollapses, collapses, sizeof(__MSCollapse_t), __MSCompareCollapses);
+
+        uint32_t removed = 0, applied = 0;
+
+        for(uint32_t c = 0; c < collapses && state.mTriangles - removed > targetTriangles; c++) {
+            __MSCollapse_t* pCollapse = &pCollapses[c];
+            uint32_t from = pCollapse->mFrom, to = pCollapse->mTo;
+
+            if(state.pStamps[from] == pass || state.pStamps[to] == pass || !__MSSeamTargets(&state, from, to) || __MSLinkBroken(&state, from, to) || __MSCollapseFlips(&state, from, to)) {
+                continue;
+            }
+
+            // Open position collapsing along inner edge would pull border inside
+            if(state.pBorder[from]) {
+                uint32_t shared = 0;
+
+                for(uint32_t j = state.pOffsets[from]; j < state.pOffsets[from + 1]; j++) {
+                    shared += __MSHasEdge(&state, state.pAdjacency[j], from, to);
+                }
+
+                if(shared != 1) {
+                    continue;
+                }
+            }
+
+            // Neighbours are locked for this pass so adjacency stays valid
+            for(uint32_t j = state.pOffsets[from]; j < state.pOffsets[from + 1]; j++) {
+                uint32_t t = state.pAdjacency[j];
+
+                for(uint32_t k = 0; k < 3; k++) {
+                    uint32_t v = state.pIndices[t * 3 + k];
+
+                    state.pStamps[state.pRemap[v]] = pass;
+                    removed += k == 0 && __MSHasEdge(&state, t, from, to);
+                }
+            }
+
+            // Every vertex of from becomes its vertex of to
+            for(uint32_t j = state.pOffsets[from]; j < state.pOffsets[from + 1]; j++) {
+                uint32_t t = state.pAdjacency[j];
+
+                for(uint32_t k = 0; k < 3; k++) {
+                    uint32_t v = state.pIndices[t * 3 + k];
+
+                    if(state.pRemap[v] == from) {
+                        state.pIndices[t * 3 + k] = state.pTargets[v];
+                    }
+                }
+            }
+
+            for(uint32_t i = 0; i < 10; i++) {
+                state.pQuadrics[to].m[i] += state.pQuadrics[from].m[i];
+            }
+
+            state.pQuadrics[to].mWeight += state.pQuadrics[from].mWeight;
+            maxError = fmaxf(maxError, pCollapse->mError);
+            applied++;
+        }
+
+        if(applied == 0) {
+            break;
+        }
+
+        uint32_t triangles = 0;
+
+        for(uint32_t t = 0; t < state.mTriangles; t++) {
+            uint32_t a = __MSPosition(&state, t, 0), b = __MSPosition(&state, t, 1), c = __MSPosition(&state, t, 2);
+
+            if(a != b && b != c && a != c) {
+                memmove(&state.pIndices[triangles * 3], &state.pIndices[t * 3], 3 * sizeof(uint32_t));
+                triangles++;
+            }
+        }
+
+        state.mTriangles = triangles;
+
+        __MSAdjacency(&state);
+    }
+
+    uint32_t indexCount = state.mTriangles * 3;
+
+    memcpy(pOut, state.pIndices, indexCount * sizeof(uint32_t));
+    *pError = sqrtf(maxError);
+
+    __MSFree(&state);
+    free(pCollapses);
+
+    return indexCount;
+}
+
+typedef struct __MSContext_s {
+    const MeshEntry_t* pMesh;
+    // Decoded positions and their layout, source may be quantized
+    float* pPositions;
+    MeshDesc_t mDesc;
+    const float* pRatios;
+    uint32_t* pOut[MS_MAX_LODS];
+    uint32_t mIndexCounts[MS_MAX_LODS];
+    float mErrors[MS_MAX_LODS];
+} __MSContext_t;
+
+void __MSLevels(uint32_t begin, uint32_t end, void* pData) {
+    __MSContext_t* pContext = (__MSContext_t*)pData;
+    const MeshEntry_t* pMesh = pContext->pMesh;
+
+    for(uint32_t i = begin; i < end; i++) {
+        uint32_t target = (uint32_t)(pMesh->mDesc.mIndexCount / 3 * pContext->pRatios[i]);
+
+        pContext->mIndexCounts[i] = MSSimplify(pContext->pPositions, &pContext->mDesc, pMesh->pIndices, pContext->pOut[i], target, &pContext->mErrors[i]);
+    }
+}
+
+/**
+ * @brief Simplify mesh to every ratio, levels run in parallel from source mesh, and add them to registry as index lists over source vertices, call before MRUpload
+ *
+ * @param pLods
+ * @param pRegistry
+ * @param mesh indexed GL_TRIANGLES mesh with position at location 0
+ * @param pRatios triangle ratios from finest to coarsest
+ * @param count
+ * @return true
+ * @return false mesh can`t be simplified or out of memory
+ */
+bool MSBuildLods(MeshLods_t* pLods, MeshRegistry_t* pRegistry, uint32_t mesh, const float* pRatios, uint32_t count) {
+    memset(pLods, 0, sizeof(MeshLods_t));
+
+    if(mesh >= pRegistry->mCount || count == 0) {
+        return false;
+    }
+
+    const MeshEntry_t* pMesh = &pRegistry->mMeshes[mesh];
+
+    if(!pMesh->pVertices || !pMesh->pIndices || pMesh->mDesc.mPrimitive != GL_TRIANGLES || !MRPositionAttribute(&pMesh->mDesc)) {
+        printf("[INFO]: LODs need indexed triangles with position, <%s> is drawn as is\n", pMesh->mName);
+
+        return false;
+    }
+
+    double start = UTGetTimeMs();
+    __MSContext_t context = {
+        .pMesh = pMesh,
+        .pPositions = MRDecodePositions(pMesh),
+        .mDesc = MRDescPositions(pMesh->mDesc.mVertexCount),
+        .pRatios = pRatios
+    };
+
+    context.mDesc.mIndexType = pMesh->mDesc.mIndexType;
+    context.mDesc.mIndexCount = pMesh->mDesc.mIndexCount;
+    count = count > MS_MAX_LODS ? MS_MAX_LODS : count;
+
+    for(uint32_t i = 0; i < count; i++) {
+        context.pOut[i] = (uint32_t*)malloc((uint64_t)(pMesh->mDesc.mIndexCount ? pMesh->mDesc.mIndexCount : 1) * sizeof(uint32_t));
+
+        if(!context.pOut[i] || !context.pPositions) {
+            for(uint32_t j = 0; j <= i; j++) {
+                free(context.pOut[j]);
+            }
+
+            free(context.pPositions);
+            printf("[INFO]: Not enough memory for LODs of <%s>\n", pMesh->mName);
+
+            return false;
+        }
+    }
+
+    uint32_t threads = UTParallelFor(count, 1, __MSLevels, &context);
+
+    free(context.pPositions);
+
+    pLods->mMeshes[0] = mesh;
+    pLods->mTriangles[0] = pMesh->mDesc.mIndexCount / 3;
+    pLods->mCount = 1;
+
+    printf("[INFO]: LODs of <%s> built in %.2f ms on %u threads:\n", pMesh->mName, UTGetTimeMs() - start, threads);
+
+    for(uint32_t i = 0; i < count; i++) {
+        uint32_t indexCount = context.mIndexCounts[i];
+
+        // Level which couldn`t get coarser than previous one adds nothing
+        if(indexCount == 0 || indexCount / 3 >= pLods->mTriangles[pLods->mCount - 1]) {
+            free(context.pOut[i]);
+            continue;
+        }
+
+        // Same index type as source, indices were only ever replaced by other source indices
+        if(pMesh->mDesc.mIndexType == GL_UNSIGNED_SHORT) {
+            uint16_t* pShort = (uint16_t*)context.pOut[i];
+
+            for(uint32_t j = 0; j < indexCount; j++) {
+                pShort[j] = (uint16_t)context.pOut[i][j];
+            }
+        }
+
+        char name[MR_MAX_NAME];
+        snprintf(name, sizeof(name), "%.24s lod%u", pMesh->mName, pLods->mCount);
+
+        int32_t index = MRAddIndices(pRegistry, name, mesh, context.pOut[i], indexCount);
+
+        if(index < 0) {
+            free(context.pOut[i]);
+            continue;
+        }
+
+        pLods->pIndices[pLods->mCount] = context.pOut[i];
+        pLods->mMeshes[pLods->mCount] = index;
+        pLods->mTriangles[pLods->mCount] = indexCount / 3;
+        pLods->mErrors[pLods->mCount] = context.mErrors[i];
+
+        printf("[INFO]:     lod%u ratio %.3f: %u triangles, error %.5f\n", pLods->mCount, pRatios[i], indexCount / 3, context.mErrors[i]);
+
+        pLods->mCount++;
+    }
+
+    if(pLods->mCount == 1) {
+        printf("[INFO]:     no level got coarser, seam positions (split normals or UVs) can only move along their seam, so flat shaded or per face attribute meshes keep all triangles\n");
+    }
+
+    return pLods->mCount > 1;
+}
+
+/**
+ * @brief Free simplified indices, call after MRUpload
+ *
+ * @param pLods
+ */
+void MSReleaseIndices(MeshLods_t* pLods) {
+    for(uint32_t i = 0; i <= MS_MAX_LODS; i++) {
+        free(pLods->pIndices[i]);
+        pLods->pIndices[i] = nullptr;
+    }
+}
+
+/**
+ * @brief Pick coarsest level whose error stays under MS_PIXEL_ERROR on screen, mesh is assumed at unit distance in front of camera as shaders place it
+ *
+ * @param pLods
+ * @param scale object scale (gScale)
+ * @param pProjection column-major projection (gProj)
+ * @param height viewport height in pixels
+ * @return uint32_t registry mesh to draw
+ */
+uint32_t MSSelectLod(MeshLods_t* pLods, float scale, const float* pProjection, int height) {
+    // Mesh units to pixels, m[5] is cot(fov / 2)
+    float pixels = scale * (float)pProjection[5] * height * 0.5f;
+    uint32_t selected = 0;
+
+    for(uint32_t i = 1; i < pLods->mCount; i++) {
+        if(pLods->mErrors[i] * pixels <= MS_PIXEL_ERROR) {
+            selected = i;
+        }
+    }
+
+    pLods->mSelected = selected;
+    pLods->mSelectedPixels = pLods->mErrors[selected] * pixels;
+
+    return pLods->mMeshes[selected];
+}
+
+/**
+ * @brief Print selected level
+ *
+ * @param pLods
+ */
+void MSPrintStats(MeshLods_t* pLods) {
+    if(pLods->mCount < 2) {
+        return;
+    }
+
+    printf("[INFO]:     lod: %u of %u, %u triangles, error %.2f px\n", pLods->mSelected, pLods->mCount - 1, pLods->mTriangles[pLods->mSelected], pLods->mSelectedPixels);
+}
+
+#endif
@@ -0,0 +1,296 @@
+#ifndef __PIPELINE_
+#define __PIPELINE_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <glad/gl.h>
+
+#include "utils.h"
+#include "programcache.h"
+#include "shaderbuild.h"
+
+// How many separable stage programs are kept alive for reattaching
+#define SP_POOL_SIZE 32
+
+/**
+ * @brief Separable program made from single stage
+ */
+typedef struct StageProgram_s {
+    uint64_t mHash;
+    uint32_t mProgram;
+    uint64_t mLastUse;
+} StageProgram_t;
+
+/**
+ * @brief Program pipeline where every stage is its own separable program (GL_ARB_separate_shader_objects, core since 4.1)
+ *
+ * Editing one stage swaps only that stage program, earlier versions stay in pool keyed by source hash
+ */
+typedef struct ShaderPipeline_s {
+    uint32_t mPipeline;
+    uint32_t mPrograms[SB_MAX_STAGES];
+    uint64_t mHashes[SB_MAX_STAGES];
+
+    StageProgram_t mPool[SP_POOL_SIZE];
+    uint64_t mUseClock;
+    uint32_t mPoolHits, mPoolMisses;
+} ShaderPipeline_t;
+
+/**
+ * @brief Pipeline stage bit for shader type
+ *
+ * @param type
+ * @return uint32_t
+ */
+uint32_t SPStageBit(int type) {
+    switch(type) {
+        case GL_VERTEX_SHADER: return GL_VERTEX_SHADER_BIT;
+        case GL_FRAGMENT_SHADER: return GL_FRAGMENT_SHADER_BIT;
+        case GL_COMPUTE_SHADER: return GL_COMPUTE_SHADER_BIT;
+        case GL_GEOMETRY_SHADER: return GL_GEOMETRY_SHADER_BIT;
+        case GL_TESS_EVALUATION_SHADER: return GL_TESS_EVALUATION_SHADER_BIT;
+        case GL_TESS_CONTROL_SHADER: return GL_TESS_CONTROL_SHADER_BIT;
+        default: return 0;
+    }
+}
+
+/**
+ * @brief Create empty pipeline
+ *
+ * @param pPipeline
+ */
+void SPInit(ShaderPipeline_t* pPipeline) {
+    memset(pPipeline, 0, sizeof(ShaderPipeline_t));
+
+    glGenProgramPipelines(1, &pPipeline->mPipeline);
+}
+
+/**
+ * @brief Find stage program in pool
+ *
+ * @param pPipeline
+ * @param hash
+ * @return uint32_t program or 0
+ */
+uint32_t __SPPoolFind(ShaderPipeline_t* pPipeline, uint64_t hash) {
+    for(uint32_t i = 0; i < SP_POOL_SIZE; i++) {
+        if(pPipeline->mPool[i].mProgram && pPipeline->mPool[i].mHash == hash) {
+            pPipeline->mPool[i].mLastUse = ++pPipeline->mUseClock;
+
+            return pPipeline->mPool[i].mProgram;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Add stage program to pool, evicts least recently used program that is not bound
+ *
+ * @param pPipeline
+ * @param hash
+ * @param program
+ */
+void __SPPoolAdd(ShaderPipeline_t* pPipeline, uint64_t hash, uint32_t program) {
+    int32_t slot = -1;
+
+    for(uint32_t i = 0; i < SP_POOL_SIZE; i++) {
+        if(!pPipeline->mPool[i].mProgram) {
+            slot = i;
+
+            break;
+        }
+
+        bool bound = false;
+
+        for(uint32_t s = 0; s < SB_MAX_STAGES; s++) {
+            bound = bound || pPipeline->mPrograms[s] == pPipeline->mPool[i].mProgram;
+        }
+
+        if(!bound && (slot < 0 || pPipeline->mPool[i].mLastUse < pPipeline->mPool[slot].mLastUse)) {
+            slot = i;
+        }
+    }
+
+    if(slot < 0) {
+        // Everything is bound, can`t happen with pool bigger than stage count
+        glDeleteProgram(program);
+
+        return;
+    }
+
+    glDeleteProgram(pPipeline->mPool[slot].mProgram);
+
+    pPipeline->mPool[slot].mHash = hash;
+    pPipeline->mPool[slot].mProgram = program;
+    pPipeline->mPool[slot].mLastUse = ++pPipeline->mUseClock;
+}
+
+/**
+ * @brief Build separable program from single stage source, tries program cache first
+ *
+ * @param pStage
+ * @param source
+ * @param hash
+ * @param pCache
+ * @param pPre used to print source map on errors
+ * @param stage stage index
+ * @return uint32_t linked program or 0
+ */
+uint32_t __SPBuildStage(ShaderStage_t* pStage, const char* source, uint64_t hash, ProgramCache_t* pCache, Preprocessor_t* pPre, uint32_t stage) {
+    uint64_t key = UTHashString("separable", PCKeyBegin(pCache));
+    key = UTHash(&hash, sizeof(uint64_t), key);
+
+    uint32_t program = glCreateProgram();
+    glProgramParameteri(program, GL_PROGRAM_SEPARABLE, GL_TRUE);
+
+    if(PCLoad(pCache, key, program)) {
+        return program;
+    }
+
+    double start = UTGetTimeMs();
+
+    uint32_t shader = glCreateShader(pStage->mType);
+    glShaderSource(shader, 1, (const char* const*)&source, nullptr);
+    glCompileShader(shader);
+
+    bool isCompiled = SBCheckShader(pStage->mPath, shader);
+
+    if(!isCompiled) {
+        PPPrintSourceMap(pPre, stage);
+    }
+
+    glAttachShader(program, shader);
+    glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(program);
+    glDetachShader(program, shader);
+    glDeleteShader(shader);
+
+    if(!isCompiled || !SBCheckProgram(program)) {
+        glDeleteProgram(program);
+
+        return 0;
+    }
+
+    PCStore(pCache, key, program, UTGetTimeMs() - start);
+
+    printf("[INFO]: Rebuilded %s in %.2f ms\n", pStage->mPath, UTGetTimeMs() - start);
+
+    return program;
+}
+
+/**
+ * @brief Update pipeline stages, only stages which source hash changed are swapped
+ *
+ * @param pPipeline
+ * @param pStages
+ * @param count
+ * @param stageMask bit per stage which should be checked
+ * @param pCache
+ * @param pPre
+ * @return true every checked stage is up to date
+ * @return false some stage failed, previous program of that stage is kept
+ */
+bool SPUpdate(ShaderPipeline_t* pPipeline, ShaderStage_t* pStages, uint32_t count, uint32_t stageMask, ProgramCache_t* pCache, Preprocessor_t* pPre) {
+    bool result = true;
+
+    for(uint32_t i = 0; i < count && i < SB_MAX_STAGES; i++) {
+        if(!(stageMask & (1u << i)) || pStages[i].mPath[0] == 0) {
+            continue;
+        }
+
+        uint64_t expandedHash = 0;
+        char* source = PPExpand(pPre, i, pStages[i].mPath, &expandedHash);
+
+        if(!source) {
+            printf("[INFO]: Cannot read shader <%s>\n", pStages[i].mPath);
+            result = false;
+
+            continue;
+        }
+
+        uint64_t hash = UTHash(&pStages[i].mType, sizeof(int), expandedHash);
+
+        if(pPipeline->mPrograms[i] && pPipeline->mHashes[i] == hash) {
+            free(source);
+
+            continue;
+        }
+
+        uint32_t program = __SPPoolFind(pPipeline, hash);
+
+        if(program) {
+            pPipeline->mPoolHits++;
+
+            printf("[INFO]: Reattached %s from pool\n", pStages[i].mPath);
+        }
+        else {
+            pPipeline->mPoolMisses++;
+
+            program = __SPBuildStage(&pStages[i], source, hash, pCache, pPre, i);
+
+            if(program) {
+                __SPPoolAdd(pPipeline, hash, program);
+            }
+        }
+
+        free(source);
+
+        if(!program) {
+            // Keep last good stage program on screen
+            printf("[INFO]: Keeping previous program for %s\n", pStages[i].mPath);
+            result = false;
+
+            continue;
+        }
+
+        glUseProgramStages(pPipeline->mPipeline, SPStageBit(pStages[i].mType), program);
+
+        pPipeline->mPrograms[i] = program;
+        pPipeline->mHashes[i] = hash;
+    }
+
+    glValidateProgramPipeline(pPipeline->mPipeline);
+
+    int isValid = 0;
+    glGetProgramPipelineiv(pPipeline->mPipeline, GL_VALIDATE_STATUS, &isValid);
+
+    if(!isValid) {
+        int maxLength = 0;
+        glGetProgramPipelineiv(pPipeline->mPipeline, GL_INFO_LOG_LENGTH, &maxLength);
+
+        if(maxLength > 0) {
+            char* infoLog = (char*)malloc(maxLength);
+            glGetProgramPipelineInfoLog(pPipeline->mPipeline, maxLength, &maxLength, infoLog);
+
+            printf("[INFO]: Pipeline error: %s\n", infoLog);
+
+            free(infoLog);
+        }
+    }
+
+    printf("[INFO]: Stage program pool: %u hits, %u misses\n", pPipeline->mPoolHits, pPipeline->mPoolMisses);
+    PCPrintStats(pCache);
+
+    return result;
+}
+
+/**
+ * @brief Delete pipeline and every pooled program
+ *
+ * @param pPipeline
+ */
+void SPTerminate(ShaderPipeline_t* pPipeline) {
+    for(uint32_t i = 0; i < SP_POOL_SIZE; i++) {
+        glDeleteProgram(pPipeline->mPool[i].mProgram);
+    }
+
+    glDeleteProgramPipelines(1, &pPipeline->mPipeline);
+
+    memset(pPipeline, 0, sizeof(ShaderPipeline_t));
+}
+
+#endif
@@ -0,0 +1,629 @@
+#ifndef __PREPROCESS_
+#define __PREPROCESS_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#include "utils.h"
+
+#define PP_MAX_STAGES 32
+#define PP_MAX_DEPTH 32
+#define PP_MAX_INCLUDE_DIRS 16
+
+/**
+ * @brief Source file known to preprocessor, content is kept until file changes on disk
+ */
+typedef struct PPFile_s {
+    char mPath[1024];
+    int64_t mTime;
+    int64_t mSize;
+    uint64_t mHash;
+    const char* mData;
+    size_t mLength;
+    bool mOnce;
+    // Reverse dependency, bit per stage which includes this file (directly or not)
+    uint32_t mStageMask;
+} PPFile_t;
+
+/**
+ * @brief Last expansion of stage
+ */
+typedef struct PPStage_s {
+    char* mExpanded;
+    uint32_t mLength;
+    uint64_t mHash;
+    // Files used by expansion, index in this list is #line source string number
+    uint32_t* mFiles;
+    uint32_t mFileCount;
+} PPStage_t;
+
+/**
+ * @brief GLSL #include preprocessor with dependency graph and expanded source cache
+ */
+typedef struct Preprocessor_s {
+    PPFile_t* mFiles;
+    uint32_t mFileCount, mFileCapacity;
+
+    PPStage_t mStages[PP_MAX_STAGES];
+
+    char mIncludeDirs[PP_MAX_INCLUDE_DIRS][1024];
+    uint32_t mIncludeDirCount;
+
+    // Increased when new file becomes known, so file watcher can follow
+    _Atomic uint32_t mGeneration;
+    uint32_t mExpansions, mCacheHits;
+
+    pthread_mutex_t mMutex;
+} Preprocessor_t;
+
+typedef struct PPBuffer_s {
+    char* mData;
+    size_t mLength, mCapacity;
+} PPBuffer_t;
+
+void __PPAppend(PPBuffer_t* pBuffer, const char* data, size_t len) {
+    if(pBuffer->mLength + len + 1 > pBuffer->mCapacity) {
+        pBuffer->mCapacity = (pBuffer->mLength + len + 1) * 2;
+        pBuffer->mData = realloc(pBuffer->mData, pBuffer->mCapacity);
+    }
+
+    memcpy(pBuffer->mData + pBuffer->mLength, data, len);
+    pBuffer->mLength += len;
+    pBuffer->mData[pBuffer->mLength] = 0;
+}
+
+/**
+ * @brief Initialize preprocessor
+ *
+ * @param pPre
+ * @param includeDirs directories searched for includes not found next to includer
+ * @param count
+ */
+void PPInit(Preprocessor_t* pPre, const char** includeDirs, uint32_t count) {
+    memset(pPre, 0, sizeof(Preprocessor_t));
+
+    for(uint32_t i = 0; i < count && i < PP_MAX_INCLUDE_DIRS; i++) {
+        snprintf(pPre->mIncludeDirs[i], sizeof(pPre->mIncludeDirs[i]), "%s", includeDirs[i]);
+        pPre->mIncludeDirCount++;
+    }
+
+    atomic_store(&pPre->mGeneration, 0);
+    pthread_mutex_init(&pPre->mMutex, nullptr);
+}
+
+/**
+ * @brief Stat file, nanosecond mtime where platform has it so quick saves are not missed
+ *
+ * @param path
+ * @param pTime
+ * @param pSize
+ * @return true
+ * @return false file doesn`t exist
+ */
+bool __PPStat(const char* path, int64_t* pTime, int64_t* pSize) {
+    struct stat st;
+
+    if(stat(path, &st) != 0) {
+        return false;
+    }
+
+#ifdef __linux__
+    *pTime = (int64_t)st.st_mtim.tv_sec * 1000000000ll + st.st_mtim.tv_nsec;
+#else
+    *pTime = (int64_t)st.st_mtime * 1000000000ll;
+#endif
+    *pSize = st.st_size;
+
+    return true;
+}
+
+void __PPRelease(PPFile_t* pFile) {
+    free((void*)pFile->mData);
+
+    pFile->mData = nullptr;
+    pFile->mLength = 0;
+}
+
+/**
+ * @brief Read file content into own copy, edited sources are not mapped because editor truncating file would fault next read
+ *
+ * @param pFile
+ * @return true
+ * @return false
+ */
+bool __PPRead(PPFile_t* pFile) {
+    __PPRelease(pFile);
+
+    uint32_t len = 0;
+    pFile->mData = UTReadFile(pFile->mPath, &len);
+    pFile->mLength = len;
+
+    if(!pFile->mData) {
+        return false;
+    }
+
+    pFile->mHash = UTHash(pFile->mData, pFile->mLength, UT_HASH_SEED);
+
+    return true;
+}
+
+/**
+ * @brief Find or load file, reloads it only when mtime or size changed
+ *
+ * @param pPre
+ * @param path
+ * @return int32_t file index or -1
+ */
+int32_t __PPGetFile(Preprocessor_t* pPre, const char* path) {
+    char fullPath[1024];
+
+#ifdef _WIN32
+    if(!_fullpath(fullPath, path, sizeof(fullPath))) {
+        return -1;
+    }
+#else
+    char resolved[PATH_MAX];
+
+    if(!realpath(path, resolved) || strlen(resolved) >= sizeof(fullPath)) {
+        return -1;
+    }
+
+    memcpy(fullPath, resolved, strlen(resolved) + 1);
+#endif
+
+    int64_t time = 0, size = 0;
+
+    if(!__PPStat(fullPath, &time, &size)) {
+        return -1;
+    }
+
+    int32_t index = -1;
+
+    for(uint32_t i = 0; i < pPre->mFileCount; i++) {
+        if(strcmp(pPre->mFiles[i].mPath, fullPath) == 0) {
+            index = i;
+
+            break;
+        }
+    }
+
+    if(index < 0) {
+        if(pPre->mFileCount == pPre->mFileCapacity) {
+            pPre->mFileCapacity = pPre->mFileCapacity ? pPre->mFileCapacity * 2 : 16;
+            pPre->mFiles = realloc(pPre->mFiles, pPre->mFileCapacity * sizeof(PPFile_t));
+        }
+
+        index = pPre->mFileCount++;
+
+        memset(&pPre->mFiles[index], 0, sizeof(PPFile_t));
+        snprintf(pPre->mFiles[index].mPath, sizeof(pPre->mFiles[index].mPath), "%s", fullPath);
+
+        atomic_fetch_add(&pPre->mGeneration, 1);
+    }
+    else if(pPre->mFiles[index].mData && pPre->mFiles[index].mTime == time && pPre->mFiles[index].mSize == size) {
+        // Unchanged, use what we have
+        return index;
+    }
+
+    PPFile_t* pFile = &pPre->mFiles[index];
+
+    if(!__PPRead(pFile)) {
+        return -1;
+    }
+
+    pFile->mTime = time;
+    pFile->mSize = size;
+    pFile->mOnce = false;
+
+    return index;
+}
+
+/**
+ * @brief Resolve include name to existing path
+ *
+ * @param pPre
+ * @param includer path of file with #include
+ * @param name
+ * @param system <name> form, searched only in include directories
+ * @param result
+ * @param size
+ * @return true
+ * @return false
+ */
+bool __PPResolve(Preprocessor_t* pPre, const char* includer, const char* name, bool system, char* result, size_t size) {
+    struct stat st;
+
+    if(!system) {
+        const char* slash = strrchr(includer, '/');
+#ifdef _WIN32
+        const char* backslash = strrchr(includer, '\\');
+        slash = backslash > slash ? backslash : slash;
+#endif
+        int dirLen = slash ? (int)(slash - includer) : 0;
+
+        snprintf(result, size, "%.*s%s%s", dirLen, includer, slash ? "/" : "", name);
+
+        if(stat(result, &st) == 0) {
+            return true;
+        }
+    }
+
+    for(uint32_t i = 0; i < pPre->mIncludeDirCount; i++) {
+        snprintf(result, size, "%s/%s", pPre->mIncludeDirs[i], name);
+
+        if(stat(result, &st) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Skip spaces and tabs
+ */
+const char* __PPSkipSpaces(const char* ptr, const char* end) {
+    while(ptr < end && (*ptr == ' ' || *ptr == '\t')) {
+        ptr++;
+    }
+
+    return ptr;
+}
+
+/**
+ * @brief Check for directive on line, returns pointer after directive name
+ */
+const char* __PPDirective(const char* line, const char* end, const char* name) {
+    const char* ptr = __PPSkipSpaces(line, end);
+
+    if(ptr >= end || *ptr != '#') {
+        return nullptr;
+    }
+
+    ptr = __PPSkipSpaces(ptr + 1, end);
+    size_t len = strlen(name);
+
+    if((size_t)(end - ptr) < len || strncmp(ptr, name, len) != 0) {
+        return nullptr;
+    }
+
+    return ptr + len;
+}
+
+/**
+ * @brief Source string number of file in current expansion
+ *
+ * @return int32_t -1 if file wasn`t used yet
+ */
+int32_t __PPFindSourceId(PPStage_t* pStage, uint32_t file) {
+    for(uint32_t i = 0; i < pStage->mFileCount; i++) {
+        if(pStage->mFiles[i] == file) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Source string number of file in current expansion, adds it when it is not there yet
+ */
+uint32_t __PPSourceId(PPStage_t* pStage, uint32_t file) {
+    int32_t id = __PPFindSourceId(pStage, file);
+
+    if(id >= 0) {
+        return id;
+    }
+
+    pStage->mFiles = realloc(pStage->mFiles, (pStage->mFileCount + 1) * sizeof(uint32_t));
+    pStage->mFiles[pStage->mFileCount] = file;
+
+    return pStage->mFileCount++;
+}
+
+/**
+ * @brief Expand single file into output, recursive for includes
+ */
+bool __PPExpandFile(Preprocessor_t* pPre, PPStage_t* pStage, uint32_t file, PPBuffer_t* pOut, uint32_t* stack, uint32_t depth) {
+    if(depth >= PP_MAX_DEPTH) {
+        printf("[INFO]: Include depth limit reached in <%s>\n", pPre->mFiles[file].mPath);
+
+        return false;
+    }
+
+    stack[depth] = file;
+
+    uint32_t id = __PPSourceId(pStage, file);
+
+    // Content pointer may move when other files are loaded (array realloc), so take copy of what we need
+    const char* data = pPre->mFiles[file].mData;
+    const char* end = data + pPre->mFiles[file].mLength;
+    char path[1024];
+    strcpy(path, pPre->mFiles[file].mPath);
+
+    uint32_t lineNumber = 1;
+
+    for(const char* line = data; line < end; lineNumber++) {
+        const char* lineEnd = memchr(line, '\n', end - line);
+        lineEnd = lineEnd ? lineEnd : end;
+
+        const char* args = __PPDirective(line, lineEnd, "pragma");
+        args = args ? __PPSkipSpaces(args, lineEnd) : nullptr;
+
+        if(args && lineEnd - args >= 4 && strncmp(args, "once", 4) == 0) {
+            // Keep line numbers, just drop directive
+            pPre->mFiles[file].mOnce = true;
+            __PPAppend(pOut, "\n", 1);
+        }
+        else if((args = __PPDirective(line, lineEnd, "include")) != nullptr) {
+            args = __PPSkipSpaces(args, lineEnd);
+
+            char close = args < lineEnd && *args == '<' ? '>' : '"';
+            const char* nameEnd = args < lineEnd ? memchr(args + 1, close, lineEnd - args - 1) : nullptr;
+
+            if(args >= lineEnd || (*args != '"' && *args != '<') || !nameEnd) {
+                printf("[INFO]: %s:%u: malformed #include\n", path, lineNumber);
+
+                return false;
+            }
+
+            char name[1024], resolved[2100];
+            snprintf(name, sizeof(name), "%.*s", (int)(nameEnd - args - 1), args + 1);
+
+            if(!__PPResolve(pPre, path, name, close == '>', resolved, sizeof(resolved))) {
+                printf("[INFO]: %s:%u: cannot find include <%s>\n", path, lineNumber, name);
+
+                return false;
+            }
+
+            int32_t child = __PPGetFile(pPre, resolved);
+
+            if(child < 0) {
+                printf("[INFO]: %s:%u: cannot read include <%s>\n", path, lineNumber, resolved);
+
+                return false;
+            }
+
+            for(uint32_t i = 0; i <= depth; i++) {
+                if(stack[i] == (uint32_t)child) {
+                    printf("[INFO]: %s:%u: recursive include of <%s>\n", path, lineNumber, resolved);
+
+                    return false;
+                }
+            }
+
+            // Include guard by #pragma once, file was already expanded in this stage
+            if(__PPFindSourceId(pStage, child) >= 0 && pPre->mFiles[child].mOnce) {
+                __PPAppend(pOut, "\n", 1);
+            }
+            else {
+                char directive[64];
+                int len = snprintf(directive, sizeof(directive), "#line 1 %u\n", __PPSourceId(pStage, child));
+                __PPAppend(pOut, directive, len);
+
+                if(!__PPExpandFile(pPre, pStage, child, pOut, stack, depth + 1)) {
+                    return false;
+                }
+
+                // Included file may end without new line
+                if(pOut->mLength > 0 && pOut->mData[pOut->mLength - 1] != '\n') {
+                    __PPAppend(pOut, "\n", 1);
+                }
+
+                len = snprintf(directive, sizeof(directive), "#line %u %u\n", lineNumber + 1, id);
+                __PPAppend(pOut, directive, len);
+            }
+        }
+        else {
+            __PPAppend(pOut, line, lineEnd - line + (lineEnd < end ? 1 : 0));
+        }
+
+        line = lineEnd + 1;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Check if every file used by last expansion of stage is unchanged on disk
+ */
+bool __PPStageIsFresh(Preprocessor_t* pPre, PPStage_t* pStage) {
+    if(!pStage->mExpanded) {
+        return false;
+    }
+
+    for(uint32_t i = 0; i < pStage->mFileCount; i++) {
+        PPFile_t* pFile = &pPre->mFiles[pStage->mFiles[i]];
+        int64_t time = 0, size = 0;
+
+        if(!__PPStat(pFile->mPath, &time, &size) || time != pFile->mTime || size != pFile->mSize) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Expand #include directives of stage source, thread safe
+ *
+ * @param pPre
+ * @param stage stage index, used for dependency graph
+ * @param path root file of stage
+ * @param pHash receives hash of expanded source
+ * @return char* malloc`d expanded source or nullptr when file is missing or expansion fails
+ */
+char* PPExpand(Preprocessor_t* pPre, uint32_t stage, const char* path, uint64_t* pHash) {
+    if(stage >= PP_MAX_STAGES) {
+        return nullptr;
+    }
+
+    pthread_mutex_lock(&pPre->mMutex);
+
+    PPStage_t* pStage = &pPre->mStages[stage];
+    char* result = nullptr;
+
+    if(__PPStageIsFresh(pPre, pStage)) {
+        // Nothing changed, no file is read
+        pPre->mCacheHits++;
+    }
+    else {
+        int32_t root = __PPGetFile(pPre, path);
+
+        if(root < 0) {
+            // Missing root must not hand out its previous expansion
+            free(pStage->mExpanded);
+            pStage->mExpanded = nullptr;
+            pStage->mFileCount = 0;
+        }
+        else {
+            PPBuffer_t out = {0};
+            uint32_t stack[PP_MAX_DEPTH];
+
+            free(pStage->mExpanded);
+            pStage->mExpanded = nullptr;
+            pStage->mFileCount = 0;
+
+            pPre->mExpansions++;
+
+            if(__PPExpandFile(pPre, pStage, root, &out, stack, 0) && out.mData) {
+                pStage->mExpanded = out.mData;
+                pStage->mLength = out.mLength;
+                pStage->mHash = UTHash(out.mData, out.mLength, UT_HASH_SEED);
+            }
+            else {
+                free(out.mData);
+            }
+
+            // Rebuild reverse dependencies of this stage
+            for(uint32_t i = 0; i < pPre->mFileCount; i++) {
+                pPre->mFiles[i].mStageMask &= ~(1u << stage);
+            }
+
+            for(uint32_t i = 0; i < pStage->mFileCount; i++) {
+                pPre->mFiles[pStage->mFiles[i]].mStageMask |= 1u << stage;
+            }
+        }
+    }
+
+    if(pStage->mExpanded) {
+        result = malloc(pStage->mLength + 1);
+        memcpy(result, pStage->mExpanded, pStage->mLength + 1);
+
+        if(pHash) {
+            *pHash = pStage->mHash;
+        }
+    }
+
+    pthread_mutex_unlock(&pPre->mMutex);
+
+    return result;
+}
+
+/**
+ * @brief Find stages which depend on files changed on disk since they were expanded
+ *
+ * @param pPre
+ * @return uint32_t bit per stage
+ */
+uint32_t PPDirtyStages(Preprocessor_t* pPre) {
+    uint32_t mask = 0;
+
+    pthread_mutex_lock(&pPre->mMutex);
+
+    for(uint32_t i = 0; i < pPre->mFileCount; i++) {
+        PPFile_t* pFile = &pPre->mFiles[i];
+        int64_t time = 0, size = 0;
+
+        if(!__PPStat(pFile->mPath, &time, &size) || time != pFile->mTime || size != pFile->mSize) {
+            mask |= pFile->mStageMask;
+        }
+    }
+
+    pthread_mutex_unlock(&pPre->mMutex);
+
+    return mask;
+}
+
+/**
+ * @brief Copy paths of every known file, used to feed file watcher
+ *
+ * @param pPre
+ * @param paths receives paths, each must hold 1024 chars
+ * @param max
+ * @return uint32_t number of copied paths
+ */
+uint32_t PPGetFiles(Preprocessor_t* pPre, char (*paths)[1024], uint32_t max) {
+    pthread_mutex_lock(&pPre->mMutex);
+
+    uint32_t count = pPre->mFileCount < max ? pPre->mFileCount : max;
+
+    for(uint32_t i = 0; i < count; i++) {
+        strcpy(paths[i], pPre->mFiles[i].mPath);
+    }
+
+    pthread_mutex_unlock(&pPre->mMutex);
+
+    return count;
+}
+
+/**
+ * @brief Print which file is which #line source string number, compile errors report them as "N(line)"
+ *
+ * @param pPre
+ * @param stage
+ */
+void PPPrintSourceMap(Preprocessor_t* pPre, uint32_t stage) {
+    if(stage >= PP_MAX_STAGES) {
+        return;
+    }
+
+    pthread_mutex_lock(&pPre->mMutex);
+
+    PPStage_t* pStage = &pPre->mStages[stage];
+
+    for(uint32_t i = 0; pStage->mFileCount > 1 && i < pStage->mFileCount; i++) {
+        printf("[INFO]:     source %u = %s\n", i, pPre->mFiles[pStage->mFiles[i]].mPath);
+    }
+
+    pthread_mutex_unlock(&pPre->mMutex);
+}
+
+/**
+ * @brief Print expansion statistics
+ *
+ * @param pPre
+ */
+void PPPrintStats(Preprocessor_t* pPre) {
+    printf("[INFO]: Preprocessor: %u expansions, %u cached, %u files\n", pPre->mExpansions, pPre->mCacheHits, pPre->mFileCount);
+}
+
+/**
+ * @brief Unmap every file and free everything
+ *
+ * @param pPre
+ */
+void PPTerminate(Preprocessor_t* pPre) {
+    for(uint32_t i = 0; i < pPre->mFileCount; i++) {
+        __PPRelease(&pPre->mFiles[i]);
+    }
+
+    for(uint32_t i = 0; i < PP_MAX_STAGES; i++) {
+        free(pPre->mStages[i].mExpanded);
+        free(pPre->mStages[i].mFiles);
+    }
+
+    free(pPre->mFiles);
+
+    pthread_mutex_destroy(&pPre->mMutex);
+
+    memset(pPre, 0, sizeof(Preprocessor_t));
+}
+
+#endif
@@ -0,0 +1,334 @@
+#ifndef __PROGRAM_CACHE_
+#define __PROGRAM_CACHE_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <dirent.h>
+#include <utime.h>
+#include <sys/stat.h>
+
+#include <glad/gl.h>
+
+#include "utils.h"
+
+#define PC_MAGIC 0x43505347u // "GSPC"
+#define PC_VERSION 1u
+// Directory + "/" + file name
+#define PC_PATH_LENGTH (1024 + 1 + 256)
+
+/**
+ * @brief Header written in front of every cached program binary
+ */
+typedef struct ProgramCacheHeader_s {
+    uint32_t mMagic;
+    uint32_t mVersion;
+    uint32_t mFormat;
+    uint32_t mLength;
+    uint64_t mKey;
+    // How long compile + link took when binary was created, used to calculate saved time
+    double mBuildMs;
+} ProgramCacheHeader_t;
+
+/**
+ * @brief Content addressed cache of linked program binaries
+ */
+typedef struct ProgramCache_s {
+    char mDirectory[1024];
+    uint64_t mMaxBytes;
+    uint64_t mDriverHash;
+    bool mEnabled;
+
+    uint32_t mHits, mMisses;
+    double mSavedMs;
+} ProgramCache_t;
+
+/**
+ * @brief Initialize cache, must be called after OpenGL context is loaded becouse driver strings are part of key
+ *
+ * @param pCache
+ * @param directory where binaries are stored
+ * @param maxBytes size cap, least recently used binaries are evicted above it
+ */
+void PCInit(ProgramCache_t* pCache, const char* directory, uint64_t maxBytes) {
+    memset(pCache, 0, sizeof(ProgramCache_t));
+
+    snprintf(pCache->mDirectory, sizeof(pCache->mDirectory), "%s", directory);
+    pCache->mMaxBytes = maxBytes;
+
+    // Binaries from other driver (or other driver version) are garbage for us
+    pCache->mDriverHash = UTHashString((const char*)glGetString(GL_VENDOR), UT_HASH_SEED);
+    pCache->mDriverHash = UTHashString((const char*)glGetString(GL_RENDERER), pCache->mDriverHash);
+    pCache->mDriverHash = UTHashString((const char*)glGetString(GL_VERSION), pCache->mDriverHash);
+
+    int formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+
+    if(formats <= 0) {
+        printf("[INFO]: Driver doesn`t support program binaries, shader cache disabled\n");
+
+        return;
+    }
+
+    if(!UTMakeDirectory(pCache->mDirectory)) {
+        printf("[INFO]: Cannot create shader cache directory <%s>, shader cache disabled\n", pCache->mDirectory);
+
+        return;
+    }
+
+    pCache->mEnabled = true;
+}
+
+/**
+ * @brief Start cache key for new program
+ *
+ * @param pCache
+ * @return uint64_t
+ */
+uint64_t PCKeyBegin(ProgramCache_t* pCache) {
+    return pCache->mDriverHash;
+}
+
+/**
+ * @brief Add stage to cache key
+ *
+ * @param key previous key
+ * @param type shader type
+ * @param source stage source code
+ * @return uint64_t
+ */
+uint64_t PCKeyAddStage(uint64_t key, int type, const char* source) {
+    key = UTHash(&type, sizeof(type), key);
+
+    return UTHashString(source, key);
+}
+
+/**
+ * @brief Builds path to binary for key
+ *
+ * @param pCache
+ * @param key
+ * @param path
+ * @param size
+ */
+void PCPath(ProgramCache_t* pCache, uint64_t key, char* path, size_t size) {
+    snprintf(path, size, "%s/%016llx.bin", pCache->mDirectory, (unsigned long long)key);
+}
+
+/**
+ * @brief Try to load program from cache
+ *
+ * @param pCache
+ * @param key
+ * @param program program object which receives binary
+ * @return true program is linked and ready to use
+ * @return false miss, program must be built from source
+ */
+bool PCLoad(ProgramCache_t* pCache, uint64_t key, uint32_t program) {
+    if(!pCache->mEnabled) {
+        return false;
+    }
+
+    double start = UTGetTimeMs();
+
+    char path[PC_PATH_LENGTH];
+    PCPath(pCache, key, path, sizeof(path));
+
+    FILE* f = fopen(path, "rb");
+
+    if(!f) {
+        pCache->mMisses++;
+
+        return false;
+    }
+
+    ProgramCacheHeader_t header;
+    bool valid = fread(&header, sizeof(header), 1, f) == 1 && header.mMagic == PC_MAGIC && header.mVersion == PC_VERSION && header.mKey == key;
+
+    void* binary = nullptr;
+
+    if(valid) {
+        binary = malloc(header.mLength);
+        valid = fread(binary, 1, header.mLength, f) == header.mLength;
+    }
+
+    fclose(f);
+
+    int isLinked = 0;
+
+    if(valid) {
+        glProgramBinary(program, header.mFormat, binary, header.mLength);
+        glGetProgramiv(program, GL_LINK_STATUS, &isLinked);
+    }
+
+    free(binary);
+
+    if(!isLinked) {
+        // Corrupted or rejected by driver, remove it so it will be rebuilt
+        remove(path);
+        pCache->mMisses++;
+
+        return false;
+    }
+
+    // Touch file, mtime is our LRU clock
+    utime(path, nullptr);
+
+    double loadMs = UTGetTimeMs() - start;
+
+    pCache->mHits++;
+    pCache->mSavedMs += header.mBuildMs - loadMs;
+
+    printf("[INFO]: Shader cache hit %016llx (loaded in %.2f ms, build took %.2f ms)\n", (unsigned long long)key, loadMs, header.mBuildMs);
+
+    return true;
+}
+
+typedef struct ProgramCacheEntry_s {
+    char mName[64];
+    uint64_t mSize;
+    time_t mTime;
+} ProgramCacheEntry_t;
+
+int __PCCompareEntries(const void* a, const void* b) {
+    const ProgramCacheEntry_t* ea = (const ProgramCacheEntry_t*)a;
+    const ProgramCacheEntry_t* eb = (const ProgramCacheEntry_t*)b;
+
+    return ea->mTime < eb->mTime ? -1 : (ea->mTime > eb->mTime ? 1 : 0);
+}
+
+/**
+ * @brief Remove least recently used binaries until cache fits size cap
+ *
+ * @param pCache
+ */
+void PCEvict(ProgramCache_t* pCache) {
+    DIR* dir = opendir(pCache->mDirectory);
+
+    if(!dir) {
+        return;
+    }
+
+    ProgramCacheEntry_t* entries = nullptr;
+    uint32_t count = 0, capacity = 0;
+    uint64_t total = 0;
+
+    char path[PC_PATH_LENGTH];
+    struct dirent* ent;
+
+    while((ent = readdir(dir)) != nullptr) {
+        size_t len = strlen(ent->d_name);
+
+        if(len < 4 || len >= sizeof(entries->mName) || strcmp(ent->d_name + len - 4, ".bin") != 0) {
+            continue;
+        }
+
+        snprintf(path, sizeof(path), "%s/%s", pCache->mDirectory, ent->d_name);
+
+        struct stat st;
+
+        if(stat(path, &st) != 0) {
+            continue;
+        }
+
+        if(count == capacity) {
+            capacity = capacity ? capacity * 2 : 32;
+            entries = realloc(entries, capacity * sizeof(ProgramCacheEntry_t));
+        }
+
+        strcpy(entries[count].mName, ent->d_name);
+        entries[count].mSize = st.st_size;
+        entries[count].mTime = st.st_mtime;
+        total += st.st_size;
+        count++;
+    }
+
+    closedir(dir);
+
+    if(total > pCache->mMaxBytes) {
+        qsort(entries, count, sizeof(ProgramCacheEntry_t), __PCCompareEntries);
+
+        for(uint32_t i = 0; i < count && total > pCache->mMaxBytes; i++) {
+            snprintf(path, sizeof(path), "%s/%s", pCache->mDirectory, entries[i].mName);
+
+            if(remove(path) == 0) {
+                total -= entries[i].mSize;
+
+                printf("[INFO]: Shader cache evicted %s\n", entries[i].mName);
+            }
+        }
+    }
+
+    free(entries);
+}
+
+/**
+ * @brief Store linked program in cache
+ *
+ * @param pCache
+ * @param key
+ * @param program linked program, should be linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+ * @param buildMs how long compile + link took
+ */
+void PCStore(ProgramCache_t* pCache, uint64_t key, uint32_t program, double buildMs) {
+    if(!pCache->mEnabled) {
+        return;
+    }
+
+    int length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+
+    if(length <= 0) {
+        return;
+    }
+
+    ProgramCacheHeader_t header = {
+        .mMagic = PC_MAGIC,
+        .mVersion = PC_VERSION,
+        .mKey = key,
+        .mBuildMs = buildMs
+    };
+
+    void* binary = malloc(length);
+    GLenum format = 0;
+
+    glGetProgramBinary(program, length, &length, &format, binary);
+
+    header.mFormat = format;
+    header.mLength = length;
+
+    char path[PC_PATH_LENGTH];
+    PCPath(pCache, key, path, sizeof(path));
+
+    FILE* f = fopen(path, "wb");
+
+    if(f) {
+        bool written = fwrite(&header, sizeof(header), 1, f) == 1 && fwrite(binary, 1, length, f) == (size_t)length;
+
+        fclose(f);
+
+        if(!written) {
+            remove(path);
+        }
+    }
+
+    free(binary);
+
+    PCEvict(pCache);
+}
+
+/**
+ * @brief Print hit/miss statistics
+ *
+ * @param pCache
+ */
+void PCPrintStats(ProgramCache_t* pCache) {
+    if(!pCache->mEnabled) {
+        return;
+    }
+
+    printf("[INFO]: Shader cache: %u hits, %u misses, %.2f ms saved\n", pCache->mHits, pCache->mMisses, pCache->mSavedMs);
+}
+
+#endif
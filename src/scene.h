@@ -0,0 +1,363 @@
+#ifndef __SCENE_
+#define __SCENE_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include <glad/gl.h>
+
+#include "utils.h"
+#include "meshregistry.h"
+#include "instances.h"
+
+#define SC_BINDING 2
+// Meshes with same layout, index type and primitive share one multi draw call
+#define SC_MAX_BATCHES (MR_MAX_FORMATS * 3)
+
+/**
+ * @brief Per draw data in shader storage buffer, std430 layout, shaders opt in by declaring:
+ *
+ * layout(std430, binding = 2) readonly buffer DrawData {
+ *     SceneDraw uDraws[];
+ * };
+ *
+ * with struct SceneDraw { mat4 uModel; vec4 uColor; } and index it with gl_DrawID
+ */
+typedef struct SceneDraw_s {
+    float mModel[16];
+    float mColor[4];
+} SceneDraw_t;
+
+/**
+ * @brief Layout of GL_DRAW_INDIRECT_BUFFER entry for glMultiDrawElementsIndirect
+ */
+typedef struct SceneElementsCommand_s {
+    uint32_t mCount;
+    uint32_t mInstanceCount;
+    uint32_t mFirstIndex;
+    int32_t mBaseVertex;
+    uint32_t mBaseInstance;
+} SceneElementsCommand_t;
+
+/**
+ * @brief Layout of GL_DRAW_INDIRECT_BUFFER entry for glMultiDrawArraysIndirect
+ */
+typedef struct SceneArraysCommand_s {
+    uint32_t mCount;
+    uint32_t mInstanceCount;
+    uint32_t mFirst;
+    uint32_t mBaseInstance;
+} SceneArraysCommand_t;
+
+/**
+ * @brief Draws submitted by one multi draw call, gl_DrawID starts at 0 in every batch so its draw data is bound as own range
+ */
+typedef struct SceneBatch_s {
+    uint32_t mFormat;
+    GLenum mIndexType;
+    GLenum mPrimitive;
+    uint32_t mDrawCount;
+    // Index of first draw in bounds buffer, draws of batch are contiguous there
+    uint32_t mFirstDraw;
+    // Byte offsets of first command and first draw data
+    uint64_t mCommandOffset;
+    uint64_t mDataOffset;
+} SceneBatch_t;
+
+/**
+ * @brief Many objects over mesh registry, submitted with one glMultiDraw*Indirect per batch
+ */
+typedef struct Scene_s {
+    uint32_t mCommandBuffer;
+    uint32_t mDrawBuffer;
+    // Bounding sphere of every draw with model matrix applied, vec4 center and radius, for GPU culling
+    uint32_t mSphereBuffer;
+    uint32_t mObjectCount;
+    uint64_t mVertices;
+
+    SceneBatch_t mBatches[SC_MAX_BATCHES];
+    uint32_t mBatchCount;
+
+    // CPU time spent submitting, reset by SCPrintStats
+    double mSubmitMs;
+    uint32_t mFrames;
+} Scene_t;
+
+/**
+ * @brief Batch of mesh, new batch is created for unseen layout, index type and primitive
+ *
+ * @param pScene
+ * @param pMesh
+ * @return int32_t batch index, -1 when there are too many
+ */
+int32_t __SCFindBatch(Scene_t* pScene, const MeshEntry_t* pMesh) {
+    for(uint32_t i = 0; i < pScene->mBatchCount; i++) {
+        SceneBatch_t* pBatch = &pScene->mBatches[i];
+
+        if(pBatch->mFormat == pMesh->mFormat && pBatch->mIndexType == pMesh->mDesc.mIndexType && pBatch->mPrimitive == pMesh->mDesc.mPrimitive) {
+            return i;
+        }
+    }
+
+    if(pScene->mBatchCount == SC_MAX_BATCHES) {
+        return -1;
+    }
+
+    pScene->mBatches[pScene->mBatchCount] = (SceneBatch_t){
+        .mFormat = pMesh->mFormat,
+        .mIndexType = pMesh->mDesc.mIndexType,
+        .mPrimitive = pMesh->mDesc.mPrimitive
+    };
+
+    return pScene->mBatchCount++;
+}
+
+/**
+ * @brief Place objects cycling through every registry mesh on grid and build indirect commands and draw data
+ *
+ * @param pScene
+ * @param pRegistry uploaded registry
+ * @param objects
+ * @return true
+ * @return false out of memory, empty registry or shaders can`t read gl_DrawID
+ */
+bool SCBuild(Scene_t* pScene, MeshRegistry_t* pRegistry, uint32_t objects) {
+    memset(pScene, 0, sizeof(Scene_t));
+
+    if(pRegistry->mCount == 0 || objects == 0) {
+        return false;
+    }
+
+    // DrawData is indexed by gl_DrawID, without it user shaders wouldn`t compile
+    int major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+
+    if(major * 10 + minor < 46 && !UTHasGLExtension("GL_ARB_shader_draw_parameters")) {
+        printf("[INFO]: Scene needs gl_DrawID (OpenGL 4.6 or GL_ARB_shader_draw_parameters), drawing single shape instead\n");
+
+        return false;
+    }
+
+    double start = UTGetTimeMs();
+
+    int alignment = 256;
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+
+    // Batch of every mesh and how many objects use it
+    int32_t meshBatch[MR_MAX_MESHES];
+    uint32_t batchDraws[SC_MAX_BATCHES] = {0};
+    float extent = 0.0f;
+
+    for(uint32_t m = 0; m < pRegistry->mCount; m++) {
+        const MeshEntry_t* pMesh = &pRegistry->mMeshes[m];
+
+        meshBatch[m] = __SCFindBatch(pScene, pMesh);
+
+        for(uint32_t c = 0; c < 3; c++) {
+            extent = fmaxf(extent, pMesh->mMax[c] - pMesh->mMin[c]);
+        }
+    }
+
+    for(uint32_t i = 0; i < objects; i++) {
+        int32_t batch = meshBatch[i % pRegistry->mCount];
+
+        if(batch >= 0) {
+            batchDraws[batch]++;
+        }
+    }
+
+    uint64_t commandSize = 0, dataSize = 0;
+    uint32_t draws = 0;
+
+    for(uint32_t b = 0; b < pScene->mBatchCount; b++) {
+        SceneBatch_t* pBatch = &pScene->mBatches[b];
+
+        pBatch->mCommandOffset = commandSize;
+        pBatch->mDataOffset = dataSize;
+        pBatch->mFirstDraw = draws;
+        draws += batchDraws[b];
+
+        commandSize += (uint64_t)batchDraws[b] * (pBatch->mIndexType ? sizeof(SceneElementsCommand_t) : sizeof(SceneArraysCommand_t));
+        dataSize = (dataSize + (uint64_t)batchDraws[b] * sizeof(SceneDraw_t) + alignment - 1) / alignment * alignment;
+    }
+
+    uint8_t* pCommands = (uint8_t*)calloc(1, commandSize ? commandSize : 1);
+    uint8_t* pData = (uint8_t*)calloc(1, dataSize ? dataSize : 1);
+    float* pMatrices = (float*)malloc((uint64_t)objects * 16 * sizeof(float));
+    float* pSpheres = (float*)malloc((uint64_t)(draws ? draws : 1) * 4 * sizeof(float));
+
+    if(!pCommands || !pData || !pMatrices || !pSpheres) {
+        printf("[INFO]: Not enough memory for scene of %u objects\n", objects);
+        free(pCommands);
+        free(pData);
+        free(pMatrices);
+        free(pSpheres);
+
+        return false;
+    }
+
+    uint32_t side = 1;
+    uint32_t threads = INGenerateTransforms(pMatrices, objects, 16, (extent > 0.0f ? extent : 1.0f) * IN_SPACING, &side);
+
+    for(uint32_t i = 0; i < objects; i++) {
+        const MeshEntry_t* pMesh = &pRegistry->mMeshes[i % pRegistry->mCount];
+        int32_t batch = meshBatch[i % pRegistry->mCount];
+
+        if(batch < 0) {
+            continue;
+        }
+
+        SceneBatch_t* pBatch = &pScene->mBatches[batch];
+        uint32_t draw = pBatch->mDrawCount++;
+
+        if(pBatch->mIndexType) {
+            SceneElementsCommand_t* pCommand = (SceneElementsCommand_t*)(pCommands + pBatch->mCommandOffset) + draw;
+
+            *pCommand = (SceneElementsCommand_t){
+                .mCount = pMesh->mDesc.mIndexCount,
+                .mInstanceCount = 1,
+                .mFirstIndex = (uint32_t)(pMesh->mIndexOffset / MRIndexSize(pMesh->mDesc.mIndexType)),
+                .mBaseVertex = (int32_t)pMesh->mBaseVertex,
+                .mBaseInstance = 0
+            };
+        }
+        else {
+            SceneArraysCommand_t* pCommand = (SceneArraysCommand_t*)(pCommands + pBatch->mCommandOffset) + draw;
+
+            *pCommand = (SceneArraysCommand_t){
+                .mCount = pMesh->mDesc.mVertexCount,
+                .mInstanceCount = 1,
+                .mFirst = pMesh->mBaseVertex,
+                .mBaseInstance = 0
+            };
+        }
+
+        SceneDraw_t* pDraw = (SceneDraw_t*)(pData + pBatch->mDataOffset) + draw;
+        uint64_t hash = UTHash(&i, sizeof(i), UT_HASH_SEED + 1);
+
+        memcpy(pDraw->mModel, &pMatrices[(uint64_t)i * 16], sizeof(pDraw->mModel));
+
+        // Mesh bounds sphere moved by column-major model, radius grows with largest axis scale
+        float* pSphere = &pSpheres[(uint64_t)(pBatch->mFirstDraw + draw) * 4];
+        const float* m = pDraw->mModel;
+        float center[3], radius = 0.0f, scale = 0.0f;
+
+        for(uint32_t c = 0; c < 3; c++) {
+            center[c] = (pMesh->mMin[c] + pMesh->mMax[c]) * 0.5f;
+            radius += (pMesh->mMax[c] - pMesh->mMin[c]) * (pMesh->mMax[c] - pMesh->mMin[c]) * 0.25f;
+            scale = fmaxf(scale, m[c * 4] * m[c * 4] + m[c * 4 + 1] * m[c * 4 + 1] + m[c * 4 + 2] * m[c * 4 + 2]);
+        }
+
+        for(uint32_t c = 0; c < 3; c++) {
+            pSphere[c] = m[c] * center[0] + m[4 + c] * center[1] + m[8 + c] * center[2] + m[12 + c];
+        }
+
+        pSphere[3] = sqrtf(radius) * sqrtf(scale);
+
+        // Quantized positions are decoded by model matrix, so scene shaders never see mesh format
+        float decode[16];
+        float model[16];
+
+        MRDecodeMatrix(pMesh, decode);
+        memcpy(model, pDraw->mModel, sizeof(model));
+
+        for(uint32_t c = 0; c < 4; c++) {
+            for(uint32_t r = 0; r < 4; r++) {
+                pDraw->mModel[c * 4 + r] = model[r] * decode[c * 4] + model[4 + r] * decode[c * 4 + 1] + model[8 + r] * decode[c * 4 + 2] + model[12 + r] * decode[c * 4 + 3];
+            }
+        }
+        pDraw->mColor[0] = (float)(hash & 0xFF) / 255.0f;
+        pDraw->mColor[1] = (float)((hash >> 8) & 0xFF) / 255.0f;
+        pDraw->mColor[2] = (float)((hash >> 16) & 0xFF) / 255.0f;
+        pDraw->mColor[3] = 1.0f;
+
+        pScene->mObjectCount++;
+        pScene->mVertices += pMesh->mDesc.mIndexType ? pMesh->mDesc.mIndexCount : pMesh->mDesc.mVertexCount;
+    }
+
+    glCreateBuffers(1, &pScene->mCommandBuffer);
+    glNamedBufferStorage(pScene->mCommandBuffer, commandSize ? commandSize : 1, pCommands, 0);
+    glCreateBuffers(1, &pScene->mDrawBuffer);
+    glNamedBufferStorage(pScene->mDrawBuffer, dataSize ? dataSize : 1, pData, 0);
+    glCreateBuffers(1, &pScene->mSphereBuffer);
+    glNamedBufferStorage(pScene->mSphereBuffer, (uint64_t)(draws ? draws : 1) * 4 * sizeof(float), pSpheres, 0);
+
+    free(pCommands);
+    free(pData);
+    free(pMatrices);
+    free(pSpheres);
+
+    printf("[INFO]: Scene: %u objects on %ux%ux%u grid, %u multi draw calls, %.1f KiB commands, %.1f KiB draw data, built in %.2f ms on %u threads\n", pScene->mObjectCount, side, side, side, pScene->mBatchCount, commandSize / 1024.0, dataSize / 1024.0, UTGetTimeMs() - start, threads);
+
+    return true;
+}
+
+/**
+ * @brief Submit whole scene, one glMultiDraw*Indirect per batch no matter how many objects there are
+ *
+ * @param pScene
+ * @param pRegistry
+ */
+void SCDraw(Scene_t* pScene, MeshRegistry_t* pRegistry) {
+    double start = UTGetTimeMs();
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, pScene->mCommandBuffer);
+
+    for(uint32_t b = 0; b < pScene->mBatchCount; b++) {
+        SceneBatch_t* pBatch = &pScene->mBatches[b];
+
+        if(pBatch->mDrawCount == 0) {
+            continue;
+        }
+
+        glBindVertexArray(pRegistry->mVaos[pBatch->mFormat]);
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, SC_BINDING, pScene->mDrawBuffer, pBatch->mDataOffset, (uint64_t)pBatch->mDrawCount * sizeof(SceneDraw_t));
+
+        if(pBatch->mIndexType) {
+            glMultiDrawElementsIndirect(pBatch->mPrimitive, pBatch->mIndexType, (const void*)(uintptr_t)pBatch->mCommandOffset, pBatch->mDrawCount, 0);
+        }
+        else {
+            glMultiDrawArraysIndirect(pBatch->mPrimitive, (const void*)(uintptr_t)pBatch->mCommandOffset, pBatch->mDrawCount, 0);
+        }
+    }
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+    pScene->mSubmitMs += UTGetTimeMs() - start;
+    pScene->mFrames++;
+}
+
+/**
+ * @brief Print draws per frame and average CPU submission time since last call
+ *
+ * @param pScene
+ */
+void SCPrintStats(Scene_t* pScene) {
+    if(pScene->mFrames == 0) {
+        return;
+    }
+
+    printf("[INFO]:     scene: %u objects in %u multi draw calls, submit %.4f ms CPU per frame\n", pScene->mObjectCount, pScene->mBatchCount, pScene->mSubmitMs / pScene->mFrames);
+
+    pScene->mSubmitMs = 0.0;
+    pScene->mFrames = 0;
+}
+
+/**
+ * @brief Delete buffers
+ *
+ * @param pScene
+ */
+void SCTerminate(Scene_t* pScene) {
+    glDeleteBuffers(1, &pScene->mCommandBuffer);
+    glDeleteBuffers(1, &pScene->mDrawBuffer);
+    glDeleteBuffers(1, &pScene->mSphereBuffer);
+
+    memset(pScene, 0, sizeof(Scene_t));
+}
+
+#endif
@@ -0,0 +1,543 @@
+#ifndef __SHADER_BUILD_
+#define __SHADER_BUILD_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include <glad/gl.h>
+#include <GLFW/glfw3.h>
+
+#include "utils.h"
+#include "programcache.h"
+#include "preprocess.h"
+
+// GL_KHR_parallel_shader_compile, our glad is core only
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+typedef void (GLAD_API_PTR *PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)(GLuint count);
+
+#define SB_MAX_STAGES 6
+
+/**
+ * @brief Shader stage specified by user, empty path means stage is not used
+ *
+ * Compiled shader object is kept between builds and reused while source hash doesn`t change
+ */
+typedef struct ShaderStage_s {
+    char* mPath;
+    int mType;
+    uint64_t mHash;
+    uint32_t mShader;
+} ShaderStage_t;
+
+/**
+ * @brief Single program build, can be finished later when driver compiles in background
+ */
+typedef struct ShaderBuild_s {
+    uint32_t mProgram;
+    // Bit per stage attached to program
+    uint32_t mAttachedMask;
+    // Bit per stage which had to be compiled for this build
+    uint32_t mCompiledMask;
+    uint64_t mKey;
+    double mStart;
+    bool mCached;
+    bool mLinked;
+} ShaderBuild_t;
+
+/**
+ * @brief Prints shader compile errors if there are any
+ *
+ * @param path path to file, used only for error messages
+ * @param shader
+ * @return true shader is compiled
+ * @return false
+ */
+bool SBCheckShader(const char* path, uint32_t shader) {
+    // Check for any errors and display then if they exist
+    int isCompiled = 0;
+
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &isCompiled);
+
+    if(!isCompiled) {
+        int maxLength = 0;
+
+        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &maxLength);
+
+        char* infoLog = (char*)malloc(maxLength);
+
+        glGetShaderInfoLog(shader, maxLength, &maxLength, &infoLog[0]);
+
+        printf("[INFO]: Shader error <%s>: %s\n", path, infoLog);
+
+        free(infoLog);
+        infoLog = nullptr;
+    }
+
+    return isCompiled;
+}
+
+/**
+ * @brief Prints program link errors if there are any
+ *
+ * @param program
+ * @return true program is linked
+ * @return false
+ */
+bool SBCheckProgram(uint32_t program) {
+    int isLinked = 0;
+
+    glGetProgramiv(program, GL_LINK_STATUS, &isLinked);
+
+    if(!isLinked) {
+        int maxLength = 0;
+
+        glGetProgramiv(program, GL_INFO_LOG_LENGTH, &maxLength);
+
+        char* infoLog = (char*)malloc(maxLength);
+        glGetProgramInfoLog(program, maxLength, &maxLength, &infoLog[0]);
+
+        printf("[INFO]: Link error: %s\n", infoLog);
+
+        free(infoLog);
+
+        infoLog = nullptr;
+    }
+
+    return isLinked;
+}
+
+/**
+ * @brief Compile and link compute shader embedded in source, prints errors
+ *
+ * @param name used in error messages
+ * @param source
+ * @return uint32_t program or 0
+ */
+uint32_t SBBuildComputeProgram(const char* name, const char* source) {
+    uint32_t shader = glCreateShader(GL_COMPUTE_SHADER);
+    uint32_t program = 0;
+
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+
+    if(SBCheckShader(name, shader)) {
+        program = glCreateProgram();
+
+        glAttachShader(program, shader);
+        glLinkProgram(program);
+        glDetachShader(program, shader);
+
+        if(!SBCheckProgram(program)) {
+            glDeleteProgram(program);
+            program = 0;
+        }
+    }
+
+    glDeleteShader(shader);
+
+    return program;
+}
+
+/**
+ * @brief Starts program build, expands sources, tries program cache and issues compile and link without waiting for results
+ *
+ * @param pBuild
+ * @param pStages
+ * @param count
+ * @param pCache
+ * @param pPre preprocessor which expands #include
+ */
+void SBBegin(ShaderBuild_t* pBuild, ShaderStage_t* pStages, uint32_t count, ProgramCache_t* pCache, Preprocessor_t* pPre) {
+    memset(pBuild, 0, sizeof(ShaderBuild_t));
+
+    char* sources[SB_MAX_STAGES] = {nullptr};
+    uint64_t hashes[SB_MAX_STAGES] = {0};
+    uint64_t key = PCKeyBegin(pCache);
+
+    // Expand every stage first, key is made from all of them
+    for(uint32_t i = 0; i < count; i++) {
+        if(pStages[i].mPath[0] == 0) {
+            continue;
+        }
+
+        uint64_t expandedHash = 0;
+        sources[i] = PPExpand(pPre, i, pStages[i].mPath, &expandedHash);
+
+        if(!sources[i]) {
+            printf("[INFO]: Cannot read shader <%s>\n", pStages[i].mPath);
+        }
+
+        hashes[i] = UTHash(&pStages[i].mType, sizeof(int), expandedHash);
+        key = UTHash(&hashes[i], sizeof(uint64_t), key);
+    }
+
+    pBuild->mKey = key;
+    pBuild->mStart = UTGetTimeMs();
+    pBuild->mProgram = glCreateProgram();
+
+    if(PCLoad(pCache, key, pBuild->mProgram)) {
+        pBuild->mCached = true;
+    }
+    else {
+        for(uint32_t i = 0; i < count; i++) {
+            if(!sources[i]) {
+                continue;
+            }
+
+            // Recompile only stages which source changed since last compile
+            if(!pStages[i].mShader || pStages[i].mHash != hashes[i]) {
+                glDeleteShader(pStages[i].mShader);
+
+                pStages[i].mShader = glCreateShader(pStages[i].mType);
+                pStages[i].mHash = hashes[i];
+                glShaderSource(pStages[i].mShader, 1, (const char* const*)&sources[i], nullptr);
+                glCompileShader(pStages[i].mShader);
+
+                pBuild->mCompiledMask |= 1u << i;
+            }
+
+            glAttachShader(pBuild->mProgram, pStages[i].mShader);
+            pBuild->mAttachedMask |= 1u << i;
+        }
+
+        // Without hint driver is allowed to give us empty binary
+        glProgramParameteri(pBuild->mProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        glLinkProgram(pBuild->mProgram);
+    }
+
+    for(uint32_t i = 0; i < count; i++) {
+        free(sources[i]);
+    }
+}
+
+/**
+ * @brief Finish program build, blocks if driver is still compiling
+ *
+ * @param pBuild
+ * @param pStages
+ * @param count
+ * @param pCache
+ * @param pPre
+ * @return true program linked
+ * @return false
+ */
+bool SBFinish(ShaderBuild_t* pBuild, ShaderStage_t* pStages, uint32_t count, ProgramCache_t* pCache, Preprocessor_t* pPre) {
+    if(pBuild->mCached) {
+        pBuild->mLinked = true;
+    }
+    else {
+        for(uint32_t i = 0; i < count; i++) {
+            if((pBuild->mCompiledMask & (1u << i)) && !SBCheckShader(pStages[i].mPath, pStages[i].mShader)) {
+                // Don`t keep broken shader, it will be compiled again next time
+                pStages[i].mHash = 0;
+
+                PPPrintSourceMap(pPre, i);
+            }
+        }
+
+        double compileMs = UTGetTimeMs() - pBuild->mStart;
+
+        pBuild->mLinked = SBCheckProgram(pBuild->mProgram);
+
+        double linkMs = UTGetTimeMs() - pBuild->mStart - compileMs;
+
+        // Program keeps everything it needs after linking, shader objects stay for next build
+        for(uint32_t i = 0; i < count; i++) {
+            if(pBuild->mAttachedMask & (1u << i)) {
+                glDetachShader(pBuild->mProgram, pStages[i].mShader);
+            }
+
+            if(pBuild->mCompiledMask & (1u << i)) {
+                printf("[INFO]: Rebuilded %s\n", pStages[i].mPath);
+            }
+            else if(pBuild->mAttachedMask & (1u << i)) {
+                printf("[INFO]: Reused %s\n", pStages[i].mPath);
+            }
+        }
+
+        printf("[INFO]: Compile %.2f ms, link %.2f ms\n", compileMs, linkMs);
+
+        if(pBuild->mLinked) {
+            PCStore(pCache, pBuild->mKey, pBuild->mProgram, UTGetTimeMs() - pBuild->mStart);
+        }
+    }
+
+    PCPrintStats(pCache);
+
+    return pBuild->mLinked;
+}
+
+/**
+ * @brief Builds shader program from all specified stages and waits for it
+ *
+ * @param pStages
+ * @param count
+ * @param pCache
+ * @param pPre
+ * @return uint32_t new program (check link status, it might be broken)
+ */
+uint32_t SBBuildProgram(ShaderStage_t* pStages, uint32_t count, ProgramCache_t* pCache, Preprocessor_t* pPre) {
+    ShaderBuild_t build;
+
+    SBBegin(&build, pStages, count, pCache, pPre);
+    SBFinish(&build, pStages, count, pCache, pPre);
+
+    return build.mProgram;
+}
+
+enum ShaderRebuildState {
+    SBIdle,
+    SBBusy,
+    SBDone
+};
+
+/**
+ * @brief Background rebuild of shader program, frame loop keeps drawing old program until new one links
+ *
+ * Uses GL_KHR_parallel_shader_compile when driver has it, otherwise builds on worker thread with shared context
+ */
+typedef struct ShaderRebuild_s {
+    ShaderStage_t* pStages;
+    uint32_t mStageCount;
+    ProgramCache_t* pCache;
+    Preprocessor_t* pPre;
+
+    bool mParallel;
+    bool mQueued;
+    // Stages changed since last rebuild started, bit per stage
+    uint32_t mDirtyMask;
+    _Atomic int mState;
+    ShaderBuild_t mBuild;
+
+    // Worker path only
+    GLFWwindow* pWorkerWindow;
+    pthread_t mThread;
+    pthread_mutex_t mMutex;
+    pthread_cond_t mCond;
+    bool mJob;
+    bool mQuit;
+} ShaderRebuild_t;
+
+void* __SBWorker(void* pData) {
+    ShaderRebuild_t* pRebuild = (ShaderRebuild_t*)pData;
+
+    glfwMakeContextCurrent(pRebuild->pWorkerWindow);
+
+    pthread_mutex_lock(&pRebuild->mMutex);
+
+    while(true) {
+        while(!pRebuild->mJob && !pRebuild->mQuit) {
+            pthread_cond_wait(&pRebuild->mCond, &pRebuild->mMutex);
+        }
+
+        if(pRebuild->mQuit) {
+            break;
+        }
+
+        pRebuild->mJob = false;
+        pthread_mutex_unlock(&pRebuild->mMutex);
+
+        SBBegin(&pRebuild->mBuild, pRebuild->pStages, pRebuild->mStageCount, pRebuild->pCache, pRebuild->pPre);
+        SBFinish(&pRebuild->mBuild, pRebuild->pStages, pRebuild->mStageCount, pRebuild->pCache, pRebuild->pPre);
+
+        // Program must be complete before other context touches it
+        glFinish();
+
+        atomic_store(&pRebuild->mState, SBDone);
+
+        pthread_mutex_lock(&pRebuild->mMutex);
+    }
+
+    pthread_mutex_unlock(&pRebuild->mMutex);
+
+    glfwMakeContextCurrent(nullptr);
+
+    return nullptr;
+}
+
+/**
+ * @brief Initialize background rebuild, must be called from main thread with main window context current
+ *
+ * @param pRebuild
+ * @param pWindow main window, worker context shares objects with it
+ * @param pStages
+ * @param count
+ * @param pCache
+ * @param pPre
+ */
+void SBRebuildInit(ShaderRebuild_t* pRebuild, GLFWwindow* pWindow, ShaderStage_t* pStages, uint32_t count, ProgramCache_t* pCache, Preprocessor_t* pPre) {
+    memset(pRebuild, 0, sizeof(ShaderRebuild_t));
+
+    pRebuild->pStages = pStages;
+    pRebuild->mStageCount = count;
+    pRebuild->pCache = pCache;
+    pRebuild->pPre = pPre;
+    atomic_store(&pRebuild->mState, SBIdle);
+
+    if(UTHasGLExtension("GL_KHR_parallel_shader_compile")) {
+        PFNGLMAXSHADERCOMPILERTHREADSKHRPROC maxShaderCompilerThreads = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)glfwGetProcAddress("glMaxShaderCompilerThreadsKHR");
+
+        if(maxShaderCompilerThreads) {
+            // Let driver decide how many threads it wants
+            maxShaderCompilerThreads(0xFFFFFFFF);
+        }
+
+        pRebuild->mParallel = true;
+
+        printf("[INFO]: Using GL_KHR_parallel_shader_compile for rebuilds\n");
+
+        return;
+    }
+
+    // Invisible window only for its context
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    pRebuild->pWorkerWindow = glfwCreateWindow(1, 1, "GLSL Shader Designer worker", nullptr, pWindow);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+
+    if(!pRebuild->pWorkerWindow) {
+        printf("[INFO]: Cannot create worker context, rebuilds will block\n");
+
+        return;
+    }
+
+    pthread_mutex_init(&pRebuild->mMutex, nullptr);
+    pthread_cond_init(&pRebuild->mCond, nullptr);
+    pthread_create(&pRebuild->mThread, nullptr, __SBWorker, pRebuild);
+
+    printf("[INFO]: Using worker thread for rebuilds\n");
+}
+
+/**
+ * @brief Request rebuild, if one is already running it will be repeated after it finishes
+ *
+ * @param pRebuild
+ * @param stageMask bit per changed stage
+ */
+void SBRebuildRequest(ShaderRebuild_t* pRebuild, uint32_t stageMask) {
+    pRebuild->mDirtyMask |= stageMask;
+
+    if(atomic_load(&pRebuild->mState) != SBIdle) {
+        pRebuild->mQueued = true;
+
+        return;
+    }
+
+    for(uint32_t i = 0; i < pRebuild->mStageCount; i++) {
+        if((pRebuild->mDirtyMask & (1u << i)) && pRebuild->pStages[i].mPath[0] != 0) {
+            printf("[INFO]: Changed %s\n", pRebuild->pStages[i].mPath);
+        }
+    }
+
+    pRebuild->mDirtyMask = 0;
+    pRebuild->mQueued = false;
+    atomic_store(&pRebuild->mState, SBBusy);
+
+    if(pRebuild->pWorkerWindow) {
+        pthread_mutex_lock(&pRebuild->mMutex);
+        pRebuild->mJob = true;
+        pthread_cond_signal(&pRebuild->mCond);
+        pthread_mutex_unlock(&pRebuild->mMutex);
+    }
+    else {
+        SBBegin(&pRebuild->mBuild, pRebuild->pStages, pRebuild->mStageCount, pRebuild->pCache, pRebuild->pPre);
+
+        // No way to build in background, finish right now
+        if(!pRebuild->mParallel || pRebuild->mBuild.mCached) {
+            SBFinish(&pRebuild->mBuild, pRebuild->pStages, pRebuild->mStageCount, pRebuild->pCache, pRebuild->pPre);
+            atomic_store(&pRebuild->mState, SBDone);
+        }
+    }
+}
+
+/**
+ * @brief Check rebuild progress, call once per frame
+ *
+ * @param pRebuild
+ * @return uint32_t new linked program to swap in or 0 if there is nothing to swap
+ */
+uint32_t SBRebuildPoll(ShaderRebuild_t* pRebuild) {
+    int state = atomic_load(&pRebuild->mState);
+
+    if(state == SBBusy && pRebuild->mParallel) {
+        int isComplete = 0;
+        glGetProgramiv(pRebuild->mBuild.mProgram, GL_COMPLETION_STATUS_KHR, &isComplete);
+
+        if(isComplete) {
+            SBFinish(&pRebuild->mBuild, pRebuild->pStages, pRebuild->mStageCount, pRebuild->pCache, pRebuild->pPre);
+            state = SBDone;
+        }
+    }
+
+    if(state != SBDone) {
+        return 0;
+    }
+
+    uint32_t program = pRebuild->mBuild.mProgram;
+
+    printf("[INFO]: Rebuild took %.2f ms\n", UTGetTimeMs() - pRebuild->mBuild.mStart);
+
+    if(!pRebuild->mBuild.mLinked) {
+        // Keep last good program on screen
+        printf("[INFO]: Rebuild failed, keeping previous program\n");
+
+        glDeleteProgram(program);
+        program = 0;
+    }
+
+    atomic_store(&pRebuild->mState, SBIdle);
+
+    if(pRebuild->mQueued) {
+        SBRebuildRequest(pRebuild, 0);
+    }
+
+    return program;
+}
+
+/**
+ * @brief Check if there is no rebuild in progress or waiting to be swapped
+ *
+ * @param pRebuild
+ * @return true
+ * @return false
+ */
+bool SBRebuildIsIdle(ShaderRebuild_t* pRebuild) {
+    return atomic_load(&pRebuild->mState) == SBIdle;
+}
+
+/**
+ * @brief Stop worker and free everything
+ *
+ * @param pRebuild
+ */
+void SBRebuildTerminate(ShaderRebuild_t* pRebuild) {
+    if(pRebuild->pWorkerWindow) {
+        pthread_mutex_lock(&pRebuild->mMutex);
+        pRebuild->mQuit = true;
+        pthread_cond_signal(&pRebuild->mCond);
+        pthread_mutex_unlock(&pRebuild->mMutex);
+
+        pthread_join(pRebuild->mThread, nullptr);
+
+        pthread_mutex_destroy(&pRebuild->mMutex);
+        pthread_cond_destroy(&pRebuild->mCond);
+
+        glfwDestroyWindow(pRebuild->pWorkerWindow);
+        pRebuild->pWorkerWindow = nullptr;
+    }
+    else if(atomic_load(&pRebuild->mState) == SBBusy) {
+        SBFinish(&pRebuild->mBuild, pRebuild->pStages, pRebuild->mStageCount, pRebuild->pCache, pRebuild->pPre);
+        glDeleteProgram(pRebuild->mBuild.mProgram);
+    }
+
+    for(uint32_t i = 0; i < pRebuild->mStageCount; i++) {
+        glDeleteShader(pRebuild->pStages[i].mShader);
+        pRebuild->pStages[i].mShader = 0;
+    }
+}
+
+#endif
@@ -0,0 +1,190 @@
+#ifndef __UNIFORMS_
+#define __UNIFORMS_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <glad/gl.h>
+
+#define UN_MAX_UNIFORMS 64
+#define UN_MAX_NAME 64
+
+/**
+ * @brief Uniforms set by app every frame
+ */
+enum UniformBuiltin {
+    UNTime,
+    UNDeltaTime,
+    UNProjection,
+    UNView,
+    UNTransform,
+    UNMeshDecode,
+    UNBuiltinCount
+};
+
+const char* gUniformBuiltinNames[UNBuiltinCount] = {
+    "uTime",
+    "uDeltaTime",
+    "uProjection",
+    "uView",
+    "uTransform",
+    "uMeshDecode"
+};
+
+/**
+ * @brief Active uniform found by reflection
+ */
+typedef struct UniformInfo_s {
+    char mName[UN_MAX_NAME];
+    int mLocation;
+    int mType;
+    int mSize;
+
+    // Last value sent to driver, nothing is sent while value doesn`t change
+    float mShadow[16];
+    bool mShadowValid;
+} UniformInfo_t;
+
+/**
+ * @brief Uniform table of single program, built after link
+ */
+typedef struct UniformTable_s {
+    uint32_t mProgram;
+    UniformInfo_t mUniforms[UN_MAX_UNIFORMS];
+    uint32_t mCount;
+
+    // Index in mUniforms or -1 if program doesn`t use builtin
+    int mBuiltins[UNBuiltinCount];
+
+    uint64_t mUploads, mSkipped;
+} UniformTable_t;
+
+/**
+ * @brief Enumerate active uniforms of linked program
+ *
+ * @param pTable
+ * @param program
+ */
+void UNReflect(UniformTable_t* pTable, uint32_t program) {
+    uint64_t uploads = pTable->mUploads, skipped = pTable->mSkipped;
+
+    memset(pTable, 0, sizeof(UniformTable_t));
+
+    pTable->mProgram = program;
+    pTable->mUploads = uploads;
+    pTable->mSkipped = skipped;
+
+    for(uint32_t i = 0; i < UNBuiltinCount; i++) {
+        pTable->mBuiltins[i] = -1;
+    }
+
+    if(!program) {
+        return;
+    }
+
+    int count = 0;
+    glGetProgramInterfaceiv(program, GL_UNIFORM, GL_ACTIVE_RESOURCES, &count);
+
+    const GLenum props[] = {GL_TYPE, GL_ARRAY_SIZE, GL_LOCATION, GL_BLOCK_INDEX};
+
+    for(int i = 0; i < count && pTable->mCount < UN_MAX_UNIFORMS; i++) {
+        int values[4] = {0};
+        glGetProgramResourceiv(program, GL_UNIFORM, i, 4, props, 4, nullptr, values);
+
+        // Block members have no location, they are fed by buffers
+        if(values[2] < 0 || values[3] != -1) {
+            continue;
+        }
+
+        UniformInfo_t* pInfo = &pTable->mUniforms[pTable->mCount];
+
+        glGetProgramResourceName(program, GL_UNIFORM, i, UN_MAX_NAME, nullptr, pInfo->mName);
+        pInfo->mType = values[0];
+        pInfo->mSize = values[1];
+        pInfo->mLocation = values[2];
+
+        for(uint32_t b = 0; b < UNBuiltinCount; b++) {
+            if(strcmp(pInfo->mName, gUniformBuiltinNames[b]) == 0) {
+                pTable->mBuiltins[b] = pTable->mCount;
+            }
+        }
+
+        pTable->mCount++;
+    }
+}
+
+/**
+ * @brief Print reflected uniforms
+ *
+ * @param pTable
+ */
+void UNPrint(UniformTable_t* pTable) {
+    printf("[INFO]: Program %u uniforms:\n", pTable->mProgram);
+
+    for(uint32_t i = 0; i < pTable->mCount; i++) {
+        printf("[INFO]:     %-24s location %3d type 0x%04x size %d\n", pTable->mUniforms[i].mName, pTable->mUniforms[i].mLocation, pTable->mUniforms[i].mType, pTable->mUniforms[i].mSize);
+    }
+}
+
+/**
+ * @brief Find builtin in table and check its type and shadow copy
+ *
+ * @return UniformInfo_t* nullptr if nothing has to be sent
+ */
+UniformInfo_t* __UNPrepare(UniformTable_t* pTable, int builtin, int type, const float* values, uint32_t count) {
+    if(pTable->mBuiltins[builtin] < 0) {
+        return nullptr;
+    }
+
+    UniformInfo_t* pInfo = &pTable->mUniforms[pTable->mBuiltins[builtin]];
+
+    if(pInfo->mType != type) {
+        return nullptr;
+    }
+
+    if(pInfo->mShadowValid && memcmp(pInfo->mShadow, values, count * sizeof(float)) == 0) {
+        pTable->mSkipped++;
+
+        return nullptr;
+    }
+
+    memcpy(pInfo->mShadow, values, count * sizeof(float));
+    pInfo->mShadowValid = true;
+    pTable->mUploads++;
+
+    return pInfo;
+}
+
+/**
+ * @brief Set float builtin, sent only when it changed
+ *
+ * @param pTable
+ * @param builtin
+ * @param value
+ */
+void UNSetFloat(UniformTable_t* pTable, int builtin, float value) {
+    UniformInfo_t* pInfo = __UNPrepare(pTable, builtin, GL_FLOAT, &value, 1);
+
+    if(pInfo) {
+        glProgramUniform1f(pTable->mProgram, pInfo->mLocation, value);
+    }
+}
+
+/**
+ * @brief Set mat4 builtin, sent only when it changed
+ *
+ * @param pTable
+ * @param builtin
+ * @param values
+ */
+void UNSetMatrix4(UniformTable_t* pTable, int builtin, const float* values) {
+    UniformInfo_t* pInfo = __UNPrepare(pTable, builtin, GL_FLOAT_MAT4, values, 16);
+
+    if(pInfo) {
+        glProgramUniformMatrix4fv(pTable->mProgram, pInfo->mLocation, 1, 0, values);
+    }
+}
+
+#endif
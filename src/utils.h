@@ -0,0 +1,313 @@
+#ifndef __UTILS_
+#define __UTILS_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#include <glad/gl.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+// FNV-1a offset basis, starting seed for every hash chain
+#define UT_HASH_SEED 0xcbf29ce484222325ull
+#define UT_MAX_THREADS 64
+
+/**
+ * @brief FNV-1a 64 bit hash, pass previous hash as seed to chain multiple buffers
+ *
+ * @param data
+ * @param len
+ * @param seed use UT_HASH_SEED for first buffer
+ * @return uint64_t
+ */
+uint64_t UTHash(const void* data, uint64_t len, uint64_t seed) {
+    const uint8_t* bytes = (const uint8_t*)data;
+
+    for(uint64_t i = 0; i < len; i++) {
+        seed ^= bytes[i];
+        seed *= 0x100000001b3ull;
+    }
+
+    return seed;
+}
+
+/**
+ * @brief Hash null terminated string (null string hashes as empty)
+ *
+ * @param str
+ * @param seed
+ * @return uint64_t
+ */
+uint64_t UTHashString(const char* str, uint64_t seed) {
+    return str ? UTHash(str, strlen(str), seed) : seed;
+}
+
+/**
+ * @brief Monotonic time in milliseconds, works without GLFW so it can be used before/without window
+ *
+ * @return double
+ */
+double UTGetTimeMs() {
+    struct timespec ts;
+
+#ifdef _WIN32
+    // windows.h would redefine APIENTRY after glad, so stick with C11 clock there
+    timespec_get(&ts, TIME_UTC);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+
+/**
+ * @brief Reads whole file into null terminated malloc`d buffer
+ *
+ * @param path
+ * @param pLen optional, receives file length without null terminator
+ * @return char* nullptr if file cannot be read, otherwise caller must free it
+ */
+char* UTReadFile(const char* path, uint32_t* pLen) {
+    FILE* f = fopen(path, "rb");
+
+    if(!f) {
+        return nullptr;
+    }
+
+    // Get length
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    if(len < 0) {
+        fclose(f);
+
+        return nullptr;
+    }
+
+    char* buffer = malloc(len + 1);
+
+    if(fread(buffer, 1, len, f) != (size_t)len) {
+        free(buffer);
+        fclose(f);
+
+        return nullptr;
+    }
+
+    buffer[len] = '\0';
+
+    fclose(f);
+
+    if(pLen) {
+        *pLen = (uint32_t)len;
+    }
+
+    return buffer;
+}
+
+/**
+ * @brief Read only view of whole file
+ */
+typedef struct UTMappedFile_s {
+    const uint8_t* pData;
+    uint64_t mLength;
+    bool mMapped;
+} UTMappedFile_t;
+
+/**
+ * @brief Map file into memory, falls back to reading it where mmap is not available
+ *
+ * @param path
+ * @param pFile
+ * @return true
+ * @return false file can`t be opened or is empty
+ */
+bool UTMapFile(const char* path, UTMappedFile_t* pFile) {
+    memset(pFile, 0, sizeof(UTMappedFile_t));
+
+#ifndef _WIN32
+    int fd = open(path, O_RDONLY);
+
+    if(fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+
+    if(fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if(data != MAP_FAILED) {
+            pFile->pData = (const uint8_t*)data;
+            pFile->mLength = st.st_size;
+            pFile->mMapped = true;
+        }
+    }
+
+    close(fd);
+#else
+    uint32_t len = 0;
+    pFile->pData = (const uint8_t*)UTReadFile(path, &len);
+    pFile->mLength = len;
+#endif
+
+    if(pFile->pData && pFile->mLength == 0) {
+        free((void*)pFile->pData);
+        pFile->pData = nullptr;
+    }
+
+    return pFile->pData != nullptr;
+}
+
+/**
+ * @brief Unmap or free file view
+ *
+ * @param pFile
+ */
+void UTUnmapFile(UTMappedFile_t* pFile) {
+#ifndef _WIN32
+    if(pFile->mMapped) {
+        munmap((void*)pFile->pData, pFile->mLength);
+    }
+    else
+#endif
+    {
+        free((void*)pFile->pData);
+    }
+
+    memset(pFile, 0, sizeof(UTMappedFile_t));
+}
+
+/**
+ * @brief Creates directory if it doesn`t exist
+ *
+ * @param path
+ * @return true directory exist after call
+ * @return false
+ */
+bool UTMakeDirectory(const char* path) {
+    struct stat st;
+
+    if(stat(path, &st) == 0) {
+        return S_ISDIR(st.st_mode);
+    }
+
+#ifdef _WIN32
+    return _mkdir(path) == 0;
+#else
+    return mkdir(path, 0755) == 0;
+#endif
+}
+
+/**
+ * @brief Checks if current context exposes extension (glad is loaded without extensions so we ask driver directly)
+ *
+ * @param name
+ * @return true
+ * @return false
+ */
+bool UTHasGLExtension(const char* name) {
+    int count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+
+    for(int i = 0; i < count; i++) {
+        const char* ext = (const char*)glGetStringi(GL_EXTENSIONS, i);
+
+        if(ext && strcmp(ext, name) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Number of online CPU cores
+ *
+ * @return uint32_t at least 1
+ */
+uint32_t UTCoreCount() {
+#ifdef _WIN32
+    // winpthreads, windows.h is avoided here
+    int count = pthread_num_processors_np();
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+    return count > 0 ? (uint32_t)count : 1;
+}
+
+typedef void (*UTParallelFunc)(uint32_t begin, uint32_t end, void* pData);
+
+typedef struct UTParallelTask_s {
+    UTParallelFunc mFunc;
+    uint32_t mBegin, mEnd;
+    void* pData;
+} UTParallelTask_t;
+
+void* __UTParallelThread(void* pData) {
+    UTParallelTask_t* pTask = (UTParallelTask_t*)pData;
+
+    pTask->mFunc(pTask->mBegin, pTask->mEnd, pTask->pData);
+
+    return nullptr;
+}
+
+/**
+ * @brief Split [0, count) into contiguous ranges and run them on all cores, returns when every range is done
+ *
+ * @param count
+ * @param minChunk smallest range worth own thread
+ * @param func called with [begin, end) range, must be safe to run concurrently on disjoint ranges
+ * @param pData
+ * @return uint32_t threads used
+ */
+uint32_t UTParallelFor(uint32_t count, uint32_t minChunk, UTParallelFunc func, void* pData) {
+    uint32_t threads = UTCoreCount();
+
+    threads = threads > UT_MAX_THREADS ? UT_MAX_THREADS : threads;
+    minChunk = minChunk ? minChunk : 1;
+
+    if(count / minChunk < threads) {
+        threads = count / minChunk ? count / minChunk : 1;
+    }
+
+    UTParallelTask_t tasks[UT_MAX_THREADS];
+    pthread_t handles[UT_MAX_THREADS];
+    bool started[UT_MAX_THREADS] = {0};
+
+    for(uint32_t i = 0; i < threads; i++) {
+        tasks[i] = (UTParallelTask_t){func, (uint64_t)count * i / threads, (uint64_t)count * (i + 1) / threads, pData};
+    }
+
+    // Calling thread takes first range, range of thread which can`t start runs here too
+    for(uint32_t i = 1; i < threads; i++) {
+        started[i] = pthread_create(&handles[i], nullptr, __UTParallelThread, &tasks[i]) == 0;
+    }
+
+    __UTParallelThread(&tasks[0]);
+
+    for(uint32_t i = 1; i < threads; i++) {
+        if(started[i]) {
+            pthread_join(handles[i], nullptr);
+        }
+        else {
+            __UTParallelThread(&tasks[i]);
+        }
+    }
+
+    return threads;
+}
+
+#endif